@@ -0,0 +1,77 @@
+#include <boost/aura/copy.hpp>
+#include <boost/aura/device.hpp>
+#include <boost/aura/device_array.hpp>
+#include <boost/aura/environment.hpp>
+#include <boost/aura/feed.hpp>
+#include <boost/aura/host_array.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+/// Time func repetitions times, return bandwidth in GB/s.
+template <typename Func>
+double bandwidth(Func func, std::size_t bytes, std::size_t repetitions)
+{
+        func();
+        auto start = std::chrono::high_resolution_clock::now();
+        for (std::size_t i = 0; i < repetitions; i++)
+        {
+                func();
+        }
+        auto stop = std::chrono::high_resolution_clock::now();
+        double seconds = std::chrono::duration<double>(stop - start).count();
+        return bytes * repetitions / seconds / 1e9;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+        std::size_t repetitions = argc > 1 ? std::atoi(argv[1]) : 20;
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                boost::aura::feed f(d);
+                std::cout << "size [MB], pageable HtoD, pinned HtoD, "
+                          << "pageable DtoH, pinned DtoH [GB/s]" << std::endl;
+                for (std::size_t mb : {1, 4, 16, 64})
+                {
+                        std::size_t n = mb * 1024 * 1024 / sizeof(float);
+                        std::vector<float> pageable(n, 1.0f);
+                        boost::aura::host_array<float> pinned(n, d);
+                        boost::aura::device_array<float> da(n, d);
+                        auto bytes = n * sizeof(float);
+
+                        auto pageable_htod = bandwidth([&]()
+                                {
+                                        boost::aura::copy(pageable, da, f);
+                                        boost::aura::wait_for(f);
+                                }, bytes, repetitions);
+                        auto pinned_htod = bandwidth([&]()
+                                {
+                                        boost::aura::copy(pinned, da, f);
+                                        boost::aura::wait_for(f);
+                                }, bytes, repetitions);
+                        auto pageable_dtoh = bandwidth([&]()
+                                {
+                                        boost::aura::copy(da, pageable, f);
+                                        boost::aura::wait_for(f);
+                                }, bytes, repetitions);
+                        auto pinned_dtoh = bandwidth([&]()
+                                {
+                                        boost::aura::copy(da, pinned, f);
+                                        boost::aura::wait_for(f);
+                                }, bytes, repetitions);
+                        std::cout << mb << ", " << pageable_htod << ", "
+                                  << pinned_htod << ", " << pageable_dtoh
+                                  << ", " << pinned_dtoh << std::endl;
+                }
+        }
+        boost::aura::finalize();
+        return 0;
+}
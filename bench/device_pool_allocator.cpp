@@ -0,0 +1,73 @@
+#include <boost/aura/device.hpp>
+#include <boost/aura/device_pool_allocator.hpp>
+#include <boost/aura/environment.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+/// Run allocate/deallocate loop on num_threads threads, return ns per pair.
+double run(boost::aura::device_pool_allocator<float>& a,
+        std::size_t num_threads, std::size_t iterations)
+{
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < num_threads; t++)
+        {
+                threads.emplace_back([&a, t, iterations]()
+                        {
+                                // Each thread (feed) uses its own sizes.
+                                const std::size_t n = 1024 * (t % 4 + 1);
+                                for (std::size_t i = 0; i < iterations; i++)
+                                {
+                                        auto ptr0 = a.allocate(n);
+                                        auto ptr1 = a.allocate(n + 1);
+                                        a.deallocate(ptr0, n);
+                                        a.deallocate(ptr1, n + 1);
+                                }
+                        });
+        }
+        for (auto& t : threads)
+        {
+                t.join();
+        }
+        auto stop = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::nano>(stop - start)
+                       .count() /
+                (2. * num_threads * iterations);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+        std::size_t iterations = argc > 1 ? std::atoi(argv[1]) : 100000;
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                std::cout << "threads, locked [ns], thread caches [ns]"
+                          << std::endl;
+                for (std::size_t num_threads : {1, 2, 4, 8})
+                {
+                        boost::aura::device_pool_allocator<float> locked(
+                                d, 64 * 1024 * 1024, 4 * 1024 * 1024, 0);
+                        boost::aura::device_pool_allocator<float> cached(
+                                d, 64 * 1024 * 1024, 4 * 1024 * 1024, 16);
+                        // Warm up slabs.
+                        run(locked, num_threads, 1);
+                        run(cached, num_threads, 1);
+                        std::cout << num_threads << ", "
+                                  << run(locked, num_threads, iterations)
+                                  << ", "
+                                  << run(cached, num_threads, iterations)
+                                  << std::endl;
+                }
+        }
+        boost::aura::finalize();
+        return 0;
+}
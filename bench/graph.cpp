@@ -0,0 +1,111 @@
+#include <boost/aura/copy.hpp>
+#include <boost/aura/device.hpp>
+#include <boost/aura/device_ptr.hpp>
+#include <boost/aura/environment.hpp>
+#include <boost/aura/feed.hpp>
+#include <boost/aura/graph.hpp>
+#include <boost/aura/invoke.hpp>
+#include <boost/aura/kernel.hpp>
+#include <boost/aura/library.hpp>
+
+#include <test/test.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+/// Time func repetitions times, return host time per call in microseconds.
+template <typename Func>
+double host_time(Func func, std::size_t repetitions)
+{
+        func();
+        double seconds = 0.0;
+        for (std::size_t i = 0; i < repetitions; i++)
+        {
+                seconds += func();
+        }
+        return seconds / repetitions * 1e6;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+        std::size_t repetitions = argc > 1 ? std::atoi(argv[1]) : 100;
+        // Each frame issues 2 * steps commands.
+        const std::size_t steps = 20;
+        const std::size_t num_el = 1024;
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                boost::aura::feed f(d);
+                boost::aura::library l(
+                        boost::aura::path(boost::aura::test::get_test_dir() +
+                                "/kernels.al"),
+                        d);
+                boost::aura::kernel k("add_alang", l);
+
+                std::vector<float> a(num_el, 1.0f);
+                auto a_ptr = boost::aura::device_malloc<float>(num_el, d);
+                auto b_ptr = boost::aura::device_malloc<float>(num_el, d);
+                auto c_ptr = boost::aura::device_malloc<float>(num_el, d);
+
+                auto frame = [&]()
+                {
+                        for (std::size_t i = 0; i < steps; i++)
+                        {
+                                boost::aura::copy(
+                                        a.begin(), a.end(), a_ptr, f);
+                                boost::aura::invoke(k,
+                                        boost::aura::mesh({{num_el, 1, 1}}),
+                                        boost::aura::bundle({{1, 1, 1}}),
+                                        boost::aura::args(a_ptr.get_base_ptr(),
+                                                b_ptr.get_base_ptr(),
+                                                c_ptr.get_base_ptr()),
+                                        f);
+                        }
+                };
+
+                boost::aura::graph g;
+                f.begin_capture(g);
+                frame();
+                f.end_capture();
+
+                auto direct = host_time([&]()
+                        {
+                                auto start =
+                                        std::chrono::high_resolution_clock::now();
+                                frame();
+                                auto stop =
+                                        std::chrono::high_resolution_clock::now();
+                                boost::aura::wait_for(f);
+                                return std::chrono::duration<double>(
+                                        stop - start).count();
+                        }, repetitions);
+                auto replay = host_time([&]()
+                        {
+                                auto start =
+                                        std::chrono::high_resolution_clock::now();
+                                g.launch(f);
+                                auto stop =
+                                        std::chrono::high_resolution_clock::now();
+                                boost::aura::wait_for(f);
+                                return std::chrono::duration<double>(
+                                        stop - start).count();
+                        }, repetitions);
+                std::cout << "commands per frame, direct, graph [us host time]"
+                          << std::endl;
+                std::cout << 2 * steps << ", " << direct << ", " << replay
+                          << std::endl;
+
+                boost::aura::device_free(a_ptr);
+                boost::aura::device_free(b_ptr);
+                boost::aura::device_free(c_ptr);
+        }
+        boost::aura::finalize();
+        return 0;
+}
@@ -0,0 +1,91 @@
+#include <boost/aura/device.hpp>
+#include <boost/aura/device_ptr.hpp>
+#include <boost/aura/environment.hpp>
+#include <boost/aura/feed.hpp>
+#include <boost/aura/invoke.hpp>
+#include <boost/aura/kernel.hpp>
+#include <boost/aura/library.hpp>
+
+#include <test/test.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+int main(int argc, char* argv[])
+{
+        std::size_t launches = argc > 1 ? std::atoi(argv[1]) : 10000;
+        const std::size_t num_el = 1024;
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                boost::aura::feed f(d);
+                boost::aura::library l(
+                        boost::aura::path(boost::aura::test::get_test_dir() +
+                                "/kernels.al"),
+                        d);
+                boost::aura::kernel k("add_alang", l);
+
+                auto a_ptr = boost::aura::device_malloc<float>(num_el, d);
+                auto b_ptr = boost::aura::device_malloc<float>(num_el, d);
+                auto c_ptr = boost::aura::device_malloc<float>(num_el, d);
+                auto a_base = a_ptr.get_base_ptr();
+                auto b_base = b_ptr.get_base_ptr();
+                auto c_base = c_ptr.get_base_ptr();
+
+                // Alternate output buffers so launches differ in arguments.
+                std::vector<decltype(boost::aura::args(a_base, b_base, c_base))>
+                        packs;
+                for (std::size_t i = 0; i < launches; i++)
+                {
+                        packs.push_back(i % 2 == 0
+                                        ? boost::aura::args(
+                                                  a_base, b_base, c_base)
+                                        : boost::aura::args(
+                                                  b_base, a_base, c_base));
+                }
+                auto m = boost::aura::mesh({{num_el, 1, 1}});
+                auto b = boost::aura::bundle({{1, 1, 1}});
+
+                auto single = [&]()
+                {
+                        for (const auto& p : packs)
+                        {
+                                boost::aura::invoke(
+                                        k, m, b, std::move(p), f);
+                        }
+                };
+                auto many = [&]()
+                {
+                        boost::aura::invoke_many(k, m, b, packs, f);
+                };
+
+                auto launches_per_second = [&](std::function<void()> func)
+                {
+                        func();
+                        boost::aura::wait_for(f);
+                        auto start = std::chrono::high_resolution_clock::now();
+                        func();
+                        boost::aura::wait_for(f);
+                        auto stop = std::chrono::high_resolution_clock::now();
+                        return launches /
+                                std::chrono::duration<double>(stop - start)
+                                        .count();
+                };
+                auto single_rate = launches_per_second(single);
+                auto many_rate = launches_per_second(many);
+                std::cout << "launches, invoke, invoke_many [launches/s]"
+                          << std::endl;
+                std::cout << launches << ", " << single_rate << ", "
+                          << many_rate << std::endl;
+
+                boost::aura::device_free(a_ptr);
+                boost::aura::device_free(b_ptr);
+                boost::aura::device_free(c_ptr);
+        }
+        boost::aura::finalize();
+        return 0;
+}
@@ -0,0 +1,85 @@
+#include <boost/aura/algorithm.hpp>
+#include <boost/aura/copy.hpp>
+#include <boost/aura/device.hpp>
+#include <boost/aura/device_array.hpp>
+#include <boost/aura/environment.hpp>
+#include <boost/aura/feed.hpp>
+
+#include <test/test.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+
+/// Time func repetitions times, return bandwidth in GB/s.
+template <typename Func>
+double bandwidth(Func func, std::size_t bytes, std::size_t repetitions)
+{
+        func();
+        auto start = std::chrono::high_resolution_clock::now();
+        for (std::size_t i = 0; i < repetitions; i++)
+        {
+                func();
+        }
+        auto stop = std::chrono::high_resolution_clock::now();
+        double seconds = std::chrono::duration<double>(stop - start).count();
+        return bytes * repetitions / seconds * 1e-9;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+        std::size_t repetitions = argc > 1 ? std::atoi(argv[1]) : 20;
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                boost::aura::feed f(d);
+                std::cout << "elements, host, reduce, min_element, dot "
+                             "[GB/s]"
+                          << std::endl;
+                for (std::size_t n = 1 << 16; n <= 1 << 26; n <<= 2)
+                {
+                        std::vector<float> v(n, 1.0f);
+                        boost::aura::device_array<float> a(n, d);
+                        boost::aura::copy(v, a, f);
+                        boost::aura::wait_for(f);
+
+                        // std::reduce needs C++17, accumulate is the
+                        // sequential equivalent.
+                        volatile float sink = 0.0f;
+                        auto host = bandwidth([&]()
+                                {
+                                        sink = std::accumulate(
+                                                v.begin(), v.end(), 0.0f);
+                                },
+                                n * sizeof(float), repetitions);
+                        auto reduce = bandwidth([&]()
+                                {
+                                        sink = boost::aura::reduce(
+                                                a, 0.0f, f);
+                                },
+                                n * sizeof(float), repetitions);
+                        auto min_element = bandwidth([&]()
+                                {
+                                        boost::aura::min_element(a, f);
+                                },
+                                n * sizeof(float), repetitions);
+                        auto dot = bandwidth([&]()
+                                {
+                                        sink = boost::aura::dot(a, a, f);
+                                },
+                                2 * n * sizeof(float), repetitions);
+                        std::cout << n << ", " << host << ", " << reduce
+                                  << ", " << min_element << ", " << dot
+                                  << std::endl;
+                }
+        }
+        boost::aura::finalize();
+        return 0;
+}
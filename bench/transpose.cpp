@@ -0,0 +1,99 @@
+#include <boost/aura/algorithm.hpp>
+#include <boost/aura/bounds.hpp>
+#include <boost/aura/copy.hpp>
+#include <boost/aura/device.hpp>
+#include <boost/aura/device_array.hpp>
+#include <boost/aura/environment.hpp>
+#include <boost/aura/feed.hpp>
+
+#include <test/test.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+/// Time func repetitions times, return bandwidth in GB/s.
+template <typename Func>
+double bandwidth(Func func, std::size_t bytes, std::size_t repetitions)
+{
+        func();
+        auto start = std::chrono::high_resolution_clock::now();
+        for (std::size_t i = 0; i < repetitions; i++)
+        {
+                func();
+        }
+        auto stop = std::chrono::high_resolution_clock::now();
+        double seconds = std::chrono::duration<double>(stop - start).count();
+        return bytes * repetitions / seconds * 1e-9;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+        std::size_t repetitions = argc > 1 ? std::atoi(argv[1]) : 20;
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                boost::aura::feed f(d);
+                // Bandwidth counts bytes read and written. copy is the
+                // device to device copy (clEnqueueCopyBuffer in OpenCL).
+                std::cout << "size, copy, transpose 2d, permute 3d {1, 2, 0} "
+                             "[GB/s]"
+                          << std::endl;
+                for (std::size_t size : {256, 1024, 4096})
+                {
+                        std::size_t n = size * size;
+                        std::size_t depth = 16;
+                        boost::aura::device_array<float> in(
+                                boost::aura::bounds({size, size}), d);
+                        boost::aura::device_array<float> out(
+                                boost::aura::bounds({size, size}), d);
+                        boost::aura::device_array<float> in3(
+                                boost::aura::bounds(
+                                        {size, size / depth, depth}),
+                                d);
+                        boost::aura::device_array<float> out3(
+                                boost::aura::bounds(
+                                        {size / depth, depth, size}),
+                                d);
+                        std::vector<float> v(n, 1.0f);
+                        boost::aura::copy(v, in, f);
+                        boost::aura::copy(v, in3, f);
+                        boost::aura::wait_for(f);
+                        auto bytes = 2 * n * sizeof(float);
+
+                        auto copy = bandwidth([&]()
+                                {
+                                        boost::aura::copy(in.begin(),
+                                                in.end(), out.begin(), f);
+                                        boost::aura::wait_for(f);
+                                },
+                                bytes, repetitions);
+                        auto transpose = bandwidth([&]()
+                                {
+                                        boost::aura::transpose(in, out, f);
+                                        boost::aura::wait_for(f);
+                                },
+                                bytes, repetitions);
+                        auto permute = bandwidth([&]()
+                                {
+                                        boost::aura::permute(in3, out3,
+                                                boost::aura::bounds(
+                                                        {1, 2, 0}),
+                                                f);
+                                        boost::aura::wait_for(f);
+                                },
+                                bytes, repetitions);
+                        std::cout << size << ", " << copy << ", "
+                                  << transpose << ", " << permute
+                                  << std::endl;
+                }
+        }
+        boost::aura::finalize();
+        return 0;
+}
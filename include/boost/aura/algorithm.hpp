@@ -0,0 +1,9 @@
+#pragma once
+
+#include <boost/aura/algorithm/compact.hpp>
+#include <boost/aura/algorithm/functional.hpp>
+#include <boost/aura/algorithm/random.hpp>
+#include <boost/aura/algorithm/reduce.hpp>
+#include <boost/aura/algorithm/scan.hpp>
+#include <boost/aura/algorithm/sort.hpp>
+#include <boost/aura/algorithm/transpose.hpp>
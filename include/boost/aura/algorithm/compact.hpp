@@ -0,0 +1,309 @@
+#pragma once
+
+#include <boost/aura/algorithm/detail/builtin_kernel.hpp>
+#include <boost/aura/algorithm/functional.hpp>
+#include <boost/aura/algorithm/scan.hpp>
+#include <boost/aura/copy.hpp>
+#include <boost/aura/device_array.hpp>
+#include <boost/aura/device_ptr.hpp>
+#include <boost/aura/feed.hpp>
+#include <boost/aura/invoke.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace boost
+{
+namespace aura
+{
+namespace detail
+{
+
+/// Compaction kernels, specialized with AURA_T, AURA_BUNDLE, AURA_ITEMS
+/// and AURA_KEEP(i) (element i of x is kept, may use the value b).
+///
+/// Each bundle counts the kept elements of its tile, the counts are
+/// scanned, and each bundle then writes its kept elements starting at the
+/// count of all previous tiles. If rejected is set, the other elements are
+/// written after all kept elements, so the output is a stable partition.
+inline const std::string& compact_source()
+{
+        static std::string v = R"(
+
+#define AURA_TILE (AURA_BUNDLE * AURA_ITEMS)
+
+AURA_KERNEL void aura_compact_count(
+        AURA_DEVMEM const AURA_T* x, AURA_VALUE(uint) x_offset,
+        AURA_VALUE(AURA_T) b, AURA_VALUE(uint) n,
+        AURA_DEVMEM uint* counts
+        AURA_MESH_ID_ARG
+        AURA_BUNDLE_ID_ARG)
+{
+        AURA_SHARED uint c[AURA_BUNDLE];
+        uint lid = AURA_BUNDLE_ID_0;
+        uint tile = AURA_MESH_ID_0 / AURA_BUNDLE;
+        uint first = tile * AURA_TILE;
+        uint m = n - first < AURA_TILE ? n - first : AURA_TILE;
+        uint count = 0;
+        for (uint j = lid; j < m; j += AURA_BUNDLE)
+        {
+                if (AURA_KEEP(first + j))
+                {
+                        count++;
+                }
+        }
+        c[lid] = count;
+        AURA_SYNC;
+        for (uint k = AURA_BUNDLE / 2; k > 0; k /= 2)
+        {
+                if (lid < k)
+                {
+                        c[lid] += c[lid + k];
+                }
+                AURA_SYNC;
+        }
+        if (lid == 0)
+        {
+                counts[tile] = c[0];
+        }
+}
+
+AURA_KERNEL void aura_compact_scatter(
+        AURA_DEVMEM const AURA_T* x, AURA_VALUE(uint) x_offset,
+        AURA_VALUE(AURA_T) b, AURA_VALUE(uint) n,
+        AURA_DEVMEM const uint* counts, AURA_VALUE(uint) num_tiles,
+        AURA_DEVMEM AURA_T* y, AURA_VALUE(uint) y_offset,
+        AURA_VALUE(uint) rejected
+        AURA_MESH_ID_ARG
+        AURA_BUNDLE_ID_ARG)
+{
+        AURA_SHARED AURA_T s[AURA_TILE];
+        AURA_SHARED uint keep[AURA_TILE];
+        AURA_SHARED uint t[AURA_BUNDLE];
+        uint lid = AURA_BUNDLE_ID_0;
+        uint tile = AURA_MESH_ID_0 / AURA_BUNDLE;
+        uint first = tile * AURA_TILE;
+        uint m = n - first < AURA_TILE ? n - first : AURA_TILE;
+        for (uint j = lid; j < m; j += AURA_BUNDLE)
+        {
+                s[j] = x[x_offset + first + j];
+                keep[j] = AURA_KEEP(first + j) ? 1 : 0;
+        }
+        AURA_SYNC;
+        uint begin = lid * AURA_ITEMS;
+        uint end = begin + AURA_ITEMS < m ? begin + AURA_ITEMS : m;
+        uint count = 0;
+        for (uint j = begin; j < end; j++)
+        {
+                count += keep[j];
+        }
+        t[lid] = count;
+        AURA_SYNC;
+        // Scan the counts of all threads.
+        for (uint k = 1; k < AURA_BUNDLE; k *= 2)
+        {
+                uint v = lid >= k ? t[lid - k] : 0;
+                AURA_SYNC;
+                t[lid] += v;
+                AURA_SYNC;
+        }
+        // Kept elements before the first element of the thread.
+        uint pos = (tile > 0 ? counts[tile - 1] : 0) +
+                (lid > 0 ? t[lid - 1] : 0);
+        uint total = counts[num_tiles - 1];
+        for (uint j = begin; j < end; j++)
+        {
+                if (keep[j])
+                {
+                        y[y_offset + pos] = s[j];
+                        pos++;
+                }
+                else if (rejected)
+                {
+                        y[y_offset + total + first + j - pos] = s[j];
+                }
+        }
+}
+
+)";
+        return v;
+}
+
+/// Value passed to predicates as b: the value member if there is one.
+template <typename T, typename Pred>
+auto predicate_operand(const Pred& pred, int) -> decltype(T(pred.value))
+{
+        return T(pred.value);
+}
+
+template <typename T, typename Pred>
+T predicate_operand(const Pred&, long)
+{
+        return T();
+}
+
+/// Write the n elements of x that AURA_KEEP(i) (defined in defines)
+/// selects to y, followed by the others if rejected is set. y must not
+/// overlap x. Returns the number of kept elements (blocks until it is
+/// available).
+template <typename T>
+std::size_t compact_impl(device_ptr<T> x, std::size_t n, device_ptr<T> y,
+        const std::string& defines, T operand, bool rejected, feed& f)
+{
+        check_builtin_size(n);
+        device& d = x.get_device();
+        auto b = builtin_bundle_size(d);
+        auto items = builtin_tile_items(
+                d, b, sizeof(T) + sizeof(std::uint32_t));
+        auto tile = b * items;
+        auto num_tiles = (n + tile - 1) / tile;
+
+        auto source = alang_type_define<T>("AURA_T") +
+                alang_define("AURA_BUNDLE", b) +
+                alang_define("AURA_ITEMS", items) + defines +
+                compact_source();
+        auto& count_kernel = builtin_kernel(d, source, "aura_compact_count");
+        auto& scatter_kernel =
+                builtin_kernel(d, source, "aura_compact_scatter");
+
+        device_array<std::uint32_t> counts(num_tiles, d);
+        invoke(count_kernel, mesh({{num_tiles, 1, 1}}), bundle({{b, 1, 1}}),
+                args(x.get_base_ptr(),
+                        builtin_offset(x, n), operand,
+                        static_cast<std::uint32_t>(n),
+                        counts.get_base_ptr()),
+                f);
+        // Scan storage lives until the count is read back below.
+        device_array<std::uint32_t> sums(
+                scan_storage_size<std::uint32_t>(num_tiles, d), d);
+        scan_impl(counts.begin(), counts.begin(), num_tiles,
+                std::uint32_t(0), false, false, plus(), sums.begin(), f);
+        invoke(scatter_kernel, mesh({{num_tiles, 1, 1}}), bundle({{b, 1, 1}}),
+                args(x.get_base_ptr(),
+                        builtin_offset(x, n), operand,
+                        static_cast<std::uint32_t>(n), counts.get_base_ptr(),
+                        static_cast<std::uint32_t>(num_tiles),
+                        y.get_base_ptr(),
+                        builtin_offset(y, n),
+                        static_cast<std::uint32_t>(rejected)),
+                f);
+
+        std::uint32_t result;
+        copy(counts.end() - 1, counts.end(), &result, f);
+        wait_for(f);
+        return result;
+}
+
+/// Defines that keep elements pred selects.
+template <typename Pred>
+std::string keep_if_defines()
+{
+        return "#define AURA_PRED(a) " + Pred::alang() + "\n" +
+                "#define AURA_KEEP(i) AURA_PRED(x[x_offset + (i)])\n";
+}
+
+/// Defines that keep elements not equal to their predecessor.
+template <typename BinaryPred>
+std::string keep_unique_defines()
+{
+        return "#define AURA_EQUAL(a, b) " + BinaryPred::alang() + "\n" +
+                "#define AURA_KEEP(i) ((i) == 0 || "
+                "!AURA_EQUAL(x[x_offset + (i) - 1], x[x_offset + (i)]))\n";
+}
+
+} // namespace detail
+
+/// Copy elements of range for which pred is true to result, keeping their
+/// order, e.g. copy_if(first, last, result, greater_than<float>{0.5f}, f).
+/// result must not overlap the range. Only the number of copied elements
+/// is read back, returns the end of the result.
+template <typename T, typename Pred>
+device_ptr<T> copy_if(device_ptr<T> first, device_ptr<T> last,
+        device_ptr<T> result, Pred pred, feed& f)
+{
+        if (last - first <= 0)
+        {
+                return result;
+        }
+        return result + detail::compact_impl(first, last - first, result,
+                                detail::keep_if_defines<Pred>(),
+                                detail::predicate_operand<T>(pred, 0), false,
+                                f);
+}
+
+/// Copy elements of array for which pred is true to out (at least as
+/// large as in), returns the end of the result.
+template <typename T, typename Allocator, typename BoundsType, typename Pred>
+device_ptr<T> copy_if(const device_array<T, Allocator, BoundsType>& in,
+        device_array<T, Allocator, BoundsType>& out, Pred pred, feed& f)
+{
+        if (out.size() < in.size())
+        {
+                throw std::string("output array too small");
+        }
+        return copy_if(in.begin(), in.end(), out.begin(), pred, f);
+}
+
+/// Reorder range so elements for which pred is true come first, keeping
+/// the relative order in both groups. Returns the first element of the
+/// second group.
+template <typename T, typename Pred>
+device_ptr<T> partition(device_ptr<T> first, device_ptr<T> last, Pred pred,
+        feed& f)
+{
+        if (last - first <= 0)
+        {
+                return first;
+        }
+        device_array<T> tmp(last - first, first.get_device());
+        auto count = detail::compact_impl(first, last - first, tmp.begin(),
+                detail::keep_if_defines<Pred>(),
+                detail::predicate_operand<T>(pred, 0), true, f);
+        copy(tmp.begin(), tmp.end(), first, f);
+        wait_for(f);
+        return first + count;
+}
+
+/// Partition array.
+template <typename T, typename Allocator, typename BoundsType, typename Pred>
+device_ptr<T> partition(
+        device_array<T, Allocator, BoundsType>& a, Pred pred, feed& f)
+{
+        return partition(a.begin(), a.end(), pred, f);
+}
+
+/// Remove consecutive elements for which pred(previous, element) is true
+/// from range, returns the new end of the range.
+template <typename T, typename BinaryPred>
+device_ptr<T> unique(device_ptr<T> first, device_ptr<T> last,
+        BinaryPred pred, feed& f)
+{
+        if (last - first <= 0)
+        {
+                return first;
+        }
+        device_array<T> tmp(last - first, first.get_device());
+        auto count = detail::compact_impl(first, last - first, tmp.begin(),
+                detail::keep_unique_defines<BinaryPred>(), T(), false, f);
+        copy(tmp.begin(), tmp.begin() + count, first, f);
+        wait_for(f);
+        return first + count;
+}
+
+/// Remove consecutive equal elements from range.
+template <typename T>
+device_ptr<T> unique(device_ptr<T> first, device_ptr<T> last, feed& f)
+{
+        return unique(first, last, equal_to(), f);
+}
+
+/// Remove consecutive equal elements from array, returns the new end.
+template <typename T, typename Allocator, typename BoundsType>
+device_ptr<T> unique(device_array<T, Allocator, BoundsType>& a, feed& f)
+{
+        return unique(a.begin(), a.end(), equal_to(), f);
+}
+
+} // namespace aura
+} // namespace boost
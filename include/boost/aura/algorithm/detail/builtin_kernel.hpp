@@ -0,0 +1,148 @@
+#pragma once
+
+#include <boost/aura/base/content_hash.hpp>
+#include <boost/aura/base/kernel_signature.hpp>
+#include <boost/aura/device.hpp>
+#include <boost/aura/device_ptr.hpp>
+#include <boost/aura/kernel.hpp>
+#include <boost/aura/library_registry.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+namespace boost
+{
+namespace aura
+{
+namespace detail
+{
+
+/// Source lines that define macro as the device type of T.
+template <typename T>
+std::string alang_type_define(const std::string& macro)
+{
+        auto name = device_type_name<T>::get();
+        if (name.empty())
+        {
+                std::ostringstream os;
+                os << "no device type for " << sizeof(T) << " byte type";
+                throw os.str();
+        }
+        std::string source;
+        if (std::is_same<T, double>::value)
+        {
+                source += "#if defined AURA_BASE_OPENCL && "
+                          "defined cl_khr_fp64\n"
+                          "#pragma OPENCL EXTENSION cl_khr_fp64 : enable\n"
+                          "#endif\n";
+        }
+        if (std::is_integral<T>::value && sizeof(T) == 8)
+        {
+                // long is 32-bit in CUDA on LLP64 hosts.
+                return source + "#ifdef AURA_BASE_CUDA\n#define " + macro +
+                        (std::is_signed<T>::value ? " long long\n" :
+                                                    " unsigned long long\n") +
+                        "#else\n#define " + macro + " " + name +
+                        "\n#endif\n";
+        }
+        return source + "#define " + macro + " " + name + "\n";
+}
+
+/// Source line that defines macro as value.
+template <typename T>
+std::string alang_define(const std::string& macro, const T& value)
+{
+        std::ostringstream os;
+        os << "#define " << macro << " " << value << "\n";
+        return os.str();
+}
+
+/// Bundle size of built-in kernels on device (power of two, at most 256).
+inline std::size_t builtin_bundle_size(const device& d)
+{
+        const auto& p = d.get_properties();
+        std::size_t limit = std::min<std::size_t>(
+                p.max_bundle_size, p.max_bundle_extent[0]);
+        std::size_t b = 1;
+        while (b * 2 <= limit && b * 2 <= 256)
+        {
+                b *= 2;
+        }
+        return b;
+}
+
+/// Number of bundles a built-in kernel processes n elements with (each
+/// bundle gets at least one element, at most bundle bundles).
+inline std::size_t builtin_num_bundles(
+        const device& d, std::size_t n, std::size_t bundle)
+{
+        std::size_t max_bundles = d.get_properties().compute_units * 4;
+        if (max_bundles == 0 || max_bundles > bundle)
+        {
+                max_bundles = bundle;
+        }
+        return std::max<std::size_t>(
+                std::min((n + bundle - 1) / bundle, max_bundles), 1);
+}
+
+/// Elements per thread of built-in kernels that keep a tile of bundle
+/// times items elements of bytes each in local memory (power of two, at
+/// most 8, tiles use at most half the local memory).
+inline std::size_t builtin_tile_items(
+        const device& d, std::size_t bundle, std::size_t bytes)
+{
+        std::size_t limit = d.get_properties().local_memory_size / 2;
+        if (limit == 0)
+        {
+                return 4;
+        }
+        std::size_t items = 8;
+        while (items > 1 && (bundle * items + bundle) * bytes > limit)
+        {
+                items /= 2;
+        }
+        return items;
+}
+
+/// Built-in kernels index elements with 32 bit integers.
+inline void check_builtin_size(std::size_t n)
+{
+        if (n > std::numeric_limits<std::uint32_t>::max())
+        {
+                throw std::string("range too large for built-in algorithm");
+        }
+}
+
+/// Offset of x as kernel argument, throws if the n elements at x are
+/// beyond 32 bit indices.
+template <typename T>
+std::uint32_t builtin_offset(const device_ptr<T>& x, std::size_t n)
+{
+        check_builtin_size(x.get_offset() + n);
+        return static_cast<std::uint32_t>(x.get_offset());
+}
+
+/// Built-in kernel name compiled from source for device. The kernel is
+/// kept in the object cache of the device, so each specialization is only
+/// compiled once per device.
+inline kernel& builtin_kernel(
+        device& d, const std::string& source, const std::string& name)
+{
+        auto key = content_hash({"builtin_kernel", source, name});
+        auto k = d.object_cache.get<kernel>(key, [&]()
+                {
+                        auto l = library_registry::instance().get(source, d);
+                        return std::make_shared<kernel>(name, l);
+                });
+        return *k;
+}
+
+} // namespace detail
+} // namespace aura
+} // namespace boost
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <string>
+
+namespace boost
+{
+namespace aura
+{
+
+/// Operators of built-in algorithms. alang() returns the operator as an
+/// alang expression of a (and b), operator() applies it on the host.
+/// Predicates with a value member compare a with it, the value is passed
+/// to kernels as b.
+
+/// a + b
+struct plus
+{
+        static std::string alang() { return "((a) + (b))"; }
+
+        template <typename T>
+        T operator()(const T& a, const T& b) const
+        {
+                return a + b;
+        }
+};
+
+/// a * b
+struct multiplies
+{
+        static std::string alang() { return "((a) * (b))"; }
+
+        template <typename T>
+        T operator()(const T& a, const T& b) const
+        {
+                return a * b;
+        }
+};
+
+/// Smaller of a and b.
+struct minimum
+{
+        static std::string alang() { return "((b) < (a) ? (b) : (a))"; }
+
+        template <typename T>
+        T operator()(const T& a, const T& b) const
+        {
+                return b < a ? b : a;
+        }
+};
+
+/// Larger of a and b.
+struct maximum
+{
+        static std::string alang() { return "((a) < (b) ? (b) : (a))"; }
+
+        template <typename T>
+        T operator()(const T& a, const T& b) const
+        {
+                return a < b ? b : a;
+        }
+};
+
+/// a
+struct identity
+{
+        static std::string alang() { return "(a)"; }
+
+        template <typename T>
+        T operator()(const T& a) const
+        {
+                return a;
+        }
+};
+
+/// -a
+struct negate
+{
+        static std::string alang() { return "(-(a))"; }
+
+        template <typename T>
+        T operator()(const T& a) const
+        {
+                return -a;
+        }
+};
+
+/// a * a
+struct square
+{
+        static std::string alang() { return "((a) * (a))"; }
+
+        template <typename T>
+        T operator()(const T& a) const
+        {
+                return a * a;
+        }
+};
+
+/// |a|
+struct absolute
+{
+        static std::string alang() { return "((a) < 0 ? -(a) : (a))"; }
+
+        template <typename T>
+        T operator()(const T& a) const
+        {
+                return a < 0 ? -a : a;
+        }
+};
+
+/// a == b
+struct equal_to
+{
+        static std::string alang() { return "((a) == (b))"; }
+
+        template <typename T>
+        bool operator()(const T& a, const T& b) const
+        {
+                return a == b;
+        }
+};
+
+/// a != 0
+struct nonzero
+{
+        static std::string alang() { return "((a) != 0)"; }
+
+        template <typename T>
+        bool operator()(const T& a) const
+        {
+                return a != T(0);
+        }
+};
+
+/// a < value
+template <typename T>
+struct less_than
+{
+        static std::string alang() { return "((a) < (b))"; }
+
+        bool operator()(const T& a) const { return a < value; }
+
+        T value;
+};
+
+/// a > value
+template <typename T>
+struct greater_than
+{
+        static std::string alang() { return "((b) < (a))"; }
+
+        bool operator()(const T& a) const { return value < a; }
+
+        T value;
+};
+
+} // namespace aura
+} // namespace boost
@@ -0,0 +1,310 @@
+#pragma once
+
+#include <boost/aura/algorithm/detail/builtin_kernel.hpp>
+#include <boost/aura/device_array.hpp>
+#include <boost/aura/device_ptr.hpp>
+#include <boost/aura/feed.hpp>
+#include <boost/aura/invoke.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace boost
+{
+namespace aura
+{
+
+/// Alang functions of the counter-based Philox4x32-10 generator, to be
+/// prepended to kernel sources, e.g.
+/// library l(random_alang_header::get() + source, d).
+///
+/// aura_philox4x32(counter, key0, key1) returns four random uints that
+/// only depend on counter and key, so every thread can compute its own
+/// numbers. aura_uniform_float maps a uint to [0, 1),
+/// aura_normal_float2 maps two uints to two standard normal numbers.
+/// The double versions are defined if AURA_RANDOM_DOUBLE is defined (not
+/// on Metal, which has no double precision).
+struct random_alang_header
+{
+        static const std::string& get()
+        {
+                static std::string v = R"(
+
+typedef struct
+{
+        uint x, y, z, w;
+} aura_uint4;
+
+typedef struct
+{
+        float x, y;
+} aura_float2;
+
+AURA_DEVICE_FUNCTION aura_uint4 aura_philox4x32(
+        aura_uint4 c, uint key0, uint key1)
+{
+        for (int i = 0; i < 10; i++)
+        {
+                ulong p0 = (ulong)0xD2511F53u * c.x;
+                ulong p1 = (ulong)0xCD9E8D57u * c.z;
+                aura_uint4 r;
+                r.x = (uint)(p1 >> 32) ^ c.y ^ key0;
+                r.y = (uint)p1;
+                r.z = (uint)(p0 >> 32) ^ c.w ^ key1;
+                r.w = (uint)p0;
+                c = r;
+                key0 += 0x9E3779B9u;
+                key1 += 0xBB67AE85u;
+        }
+        return c;
+}
+
+AURA_DEVICE_FUNCTION float aura_uniform_float(uint x)
+{
+        return (x >> 8) * (1.0f / 16777216.0f);
+}
+
+AURA_DEVICE_FUNCTION aura_float2 aura_normal_float2(uint x, uint y)
+{
+        // Box-Muller, u1 is in (0, 1].
+        float u1 = ((x >> 8) + 1) * (1.0f / 16777216.0f);
+        float r = sqrt(-2.0f * log(u1));
+        float t = 6.28318530717958647692f * aura_uniform_float(y);
+        aura_float2 z;
+        z.x = r * cos(t);
+        z.y = r * sin(t);
+        return z;
+}
+
+#if defined AURA_RANDOM_DOUBLE
+
+typedef struct
+{
+        double x, y;
+} aura_double2;
+
+AURA_DEVICE_FUNCTION double aura_uniform_double(uint hi, uint lo)
+{
+        return (((ulong)hi << 21) | (lo >> 11)) *
+                (1.0 / 9007199254740992.0);
+}
+
+AURA_DEVICE_FUNCTION aura_double2 aura_normal_double2(
+        uint hi1, uint lo1, uint hi2, uint lo2)
+{
+        double u1 = ((((ulong)hi1 << 21) | (lo1 >> 11)) + 1) *
+                (1.0 / 9007199254740992.0);
+        double r = sqrt(-2.0 * log(u1));
+        double t = 6.28318530717958647692 * aura_uniform_double(hi2, lo2);
+        aura_double2 z;
+        z.x = r * cos(t);
+        z.y = r * sin(t);
+        return z;
+}
+
+#endif
+
+)";
+                return v;
+        }
+};
+
+/// Philox4x32-10 on the host, returns the same numbers as
+/// aura_philox4x32 in kernels.
+inline std::array<std::uint32_t, 4> philox4x32(
+        std::array<std::uint32_t, 4> c, std::array<std::uint32_t, 2> key)
+{
+        for (int i = 0; i < 10; i++)
+        {
+                std::uint64_t p0 = std::uint64_t(0xD2511F53u) * c[0];
+                std::uint64_t p1 = std::uint64_t(0xCD9E8D57u) * c[2];
+                c = {{std::uint32_t(p1 >> 32) ^ c[1] ^ key[0],
+                        std::uint32_t(p1),
+                        std::uint32_t(p0 >> 32) ^ c[3] ^ key[1],
+                        std::uint32_t(p0)}};
+                key[0] += 0x9E3779B9u;
+                key[1] += 0xBB67AE85u;
+        }
+        return c;
+}
+
+namespace detail
+{
+
+/// Fill kernel, specialized with AURA_T, AURA_NORMAL (normal instead of
+/// uniform numbers) and AURA_PER_BLOCK (numbers per generator call).
+///
+/// Number j of the stream of a seed is lane j % AURA_PER_BLOCK of the
+/// generator called with counter j / AURA_PER_BLOCK and the seed as key.
+/// Each thread computes whole blocks and writes the numbers of the
+/// block that are in the filled part of the stream, so the result does
+/// not depend on mesh and bundle.
+inline const std::string& random_fill_source()
+{
+        static std::string v = R"(
+
+AURA_KERNEL void aura_random_fill(
+        AURA_DEVMEM AURA_T* y, AURA_VALUE(uint) y_offset,
+        AURA_VALUE(uint) n, AURA_VALUE(uint) seed_lo,
+        AURA_VALUE(uint) seed_hi, AURA_VALUE(uint) offset_lo,
+        AURA_VALUE(uint) offset_hi, AURA_VALUE(AURA_T) a,
+        AURA_VALUE(AURA_T) b
+        AURA_MESH_ID_ARG
+        AURA_MESH_SIZE_ARG)
+{
+        ulong first = ((ulong)offset_hi << 32) | offset_lo;
+        ulong last = first + n;
+        ulong first_block = first / AURA_PER_BLOCK;
+        ulong last_block = (last - 1) / AURA_PER_BLOCK;
+        for (ulong block = first_block + AURA_MESH_ID_0;
+                block <= last_block; block += AURA_MESH_SIZE_0)
+        {
+                aura_uint4 c;
+                c.x = (uint)block;
+                c.y = (uint)(block >> 32);
+                c.z = 0;
+                c.w = 0;
+                aura_uint4 r = aura_philox4x32(c, seed_lo, seed_hi);
+                AURA_T v[AURA_PER_BLOCK];
+#if defined AURA_RANDOM_DOUBLE && AURA_NORMAL
+                aura_double2 z = aura_normal_double2(r.x, r.y, r.z, r.w);
+                v[0] = a + b * z.x;
+                v[1] = a + b * z.y;
+#elif defined AURA_RANDOM_DOUBLE
+                v[0] = a + (b - a) * aura_uniform_double(r.x, r.y);
+                v[1] = a + (b - a) * aura_uniform_double(r.z, r.w);
+#elif AURA_NORMAL
+                aura_float2 z0 = aura_normal_float2(r.x, r.y);
+                aura_float2 z1 = aura_normal_float2(r.z, r.w);
+                v[0] = a + b * z0.x;
+                v[1] = a + b * z0.y;
+                v[2] = a + b * z1.x;
+                v[3] = a + b * z1.y;
+#else
+                v[0] = a + (b - a) * aura_uniform_float(r.x);
+                v[1] = a + (b - a) * aura_uniform_float(r.y);
+                v[2] = a + (b - a) * aura_uniform_float(r.z);
+                v[3] = a + (b - a) * aura_uniform_float(r.w);
+#endif
+                for (uint l = 0; l < AURA_PER_BLOCK; l++)
+                {
+                        ulong j = block * AURA_PER_BLOCK + l;
+                        if (j >= first && j < last)
+                        {
+                                y[y_offset + (uint)(j - first)] = v[l];
+                        }
+                }
+        }
+}
+
+)";
+        return v;
+}
+
+/// Fill n elements at x with numbers offset to offset + n - 1 of the
+/// stream of seed.
+template <typename T>
+void random_fill_impl(device_ptr<T> x, std::size_t n, std::uint64_t seed,
+        std::uint64_t offset, bool normal, T a, T b, feed& f)
+{
+        static_assert(std::is_same<T, float>::value ||
+                        std::is_same<T, double>::value,
+                "random numbers are float or double");
+#ifdef AURA_BASE_METAL
+        static_assert(!std::is_same<T, double>::value,
+                "Metal has no double precision random numbers");
+#endif
+        if (n == 0)
+        {
+                return;
+        }
+        check_builtin_size(n);
+        device& d = x.get_device();
+        std::size_t per_block = sizeof(T) == 4 ? 4 : 2;
+        auto source = alang_type_define<T>("AURA_T") +
+                (std::is_same<T, double>::value ?
+                                "#define AURA_RANDOM_DOUBLE\n" :
+                                "") +
+                alang_define("AURA_NORMAL", normal ? 1 : 0) +
+                alang_define("AURA_PER_BLOCK", per_block) +
+                random_alang_header::get() + random_fill_source();
+        auto& k = builtin_kernel(d, source, "aura_random_fill");
+
+        auto bundle_size = builtin_bundle_size(d);
+        std::size_t blocks = (offset + n - 1) / per_block -
+                offset / per_block + 1;
+        auto num_bundles = std::min<std::size_t>(
+                (blocks + bundle_size - 1) / bundle_size, 65536);
+        invoke(k, mesh({{num_bundles, 1, 1}}), bundle({{bundle_size, 1, 1}}),
+                args(x.get_base_ptr(),
+                        builtin_offset(x, n),
+                        static_cast<std::uint32_t>(n),
+                        static_cast<std::uint32_t>(seed),
+                        static_cast<std::uint32_t>(seed >> 32),
+                        static_cast<std::uint32_t>(offset),
+                        static_cast<std::uint32_t>(offset >> 32), a, b),
+                f);
+}
+
+} // namespace detail
+
+/// Fill range with uniform numbers in [low, high). The numbers are
+/// numbers offset, offset + 1, ... of the stream of seed, so filling a
+/// range in parts with matching offsets gives the same numbers. Numbers
+/// in [0, 1) (the default range) are bit-identical on every device and
+/// backend; scaled to other ranges they can differ in the last bit, as
+/// compilers may contract the scaling (fma, fast math on Metal).
+/// Returns without waiting.
+template <typename T>
+void fill_uniform(device_ptr<T> first, device_ptr<T> last,
+        std::uint64_t seed, std::uint64_t offset, feed& f, T low = T(0),
+        T high = T(1))
+{
+        if (last - first <= 0)
+        {
+                return;
+        }
+        detail::random_fill_impl(
+                first, last - first, seed, offset, false, low, high, f);
+}
+
+/// Fill array with uniform numbers in [low, high).
+template <typename T, typename Allocator, typename BoundsType>
+void fill_uniform(device_array<T, Allocator, BoundsType>& a,
+        std::uint64_t seed, std::uint64_t offset, feed& f, T low = T(0),
+        T high = T(1))
+{
+        fill_uniform(a.begin(), a.end(), seed, offset, f, low, high);
+}
+
+/// Fill range with normal numbers (Box-Muller on the uniform stream).
+/// Reproducible like fill_uniform, up to the rounding of the math
+/// functions of the backend.
+template <typename T>
+void fill_normal(device_ptr<T> first, device_ptr<T> last,
+        std::uint64_t seed, std::uint64_t offset, feed& f, T mean = T(0),
+        T stddev = T(1))
+{
+        if (last - first <= 0)
+        {
+                return;
+        }
+        detail::random_fill_impl(
+                first, last - first, seed, offset, true, mean, stddev, f);
+}
+
+/// Fill array with normal numbers.
+template <typename T, typename Allocator, typename BoundsType>
+void fill_normal(device_array<T, Allocator, BoundsType>& a,
+        std::uint64_t seed, std::uint64_t offset, feed& f, T mean = T(0),
+        T stddev = T(1))
+{
+        fill_normal(a.begin(), a.end(), seed, offset, f, mean, stddev);
+}
+
+} // namespace aura
+} // namespace boost
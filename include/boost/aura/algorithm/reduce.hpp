@@ -0,0 +1,427 @@
+#pragma once
+
+#include <boost/aura/algorithm/detail/builtin_kernel.hpp>
+#include <boost/aura/algorithm/functional.hpp>
+#include <boost/aura/copy.hpp>
+#include <boost/aura/device_array.hpp>
+#include <boost/aura/device_ptr.hpp>
+#include <boost/aura/feed.hpp>
+#include <boost/aura/invoke.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace boost
+{
+namespace aura
+{
+namespace detail
+{
+
+/// Reduction kernels, specialized with
+/// AURA_T (element type), AURA_BUNDLE (bundle size),
+/// AURA_REDUCE(a, b) and AURA_TRANSFORM(a, b) (element of x and y).
+///
+/// Each bundle reduces a grid-stride share of the range to a partial
+/// result with a tree in local memory, a single bundle then reduces the
+/// partial results. Slots of threads without elements are never read, so
+/// operators need no identity.
+inline const std::string& reduce_source()
+{
+        static std::string v = R"(
+
+AURA_KERNEL void aura_reduce_partial(
+        AURA_DEVMEM const AURA_T* x, AURA_VALUE(uint) x_offset,
+        AURA_DEVMEM const AURA_T* y, AURA_VALUE(uint) y_offset,
+        AURA_VALUE(uint) n, AURA_DEVMEM AURA_T* partial
+        AURA_MESH_ID_ARG
+        AURA_MESH_SIZE_ARG
+        AURA_BUNDLE_ID_ARG)
+{
+        AURA_SHARED AURA_T s[AURA_BUNDLE];
+        uint gid = AURA_MESH_ID_0;
+        uint lid = AURA_BUNDLE_ID_0;
+        uint stride = AURA_MESH_SIZE_0;
+        if (gid < n)
+        {
+                AURA_T acc = AURA_TRANSFORM(
+                        x[x_offset + gid], y[y_offset + gid]);
+                for (uint i = gid + stride; i < n; i += stride)
+                {
+                        acc = AURA_REDUCE(acc,
+                                AURA_TRANSFORM(x[x_offset + i],
+                                        y[y_offset + i]));
+                }
+                s[lid] = acc;
+        }
+        AURA_SYNC;
+        for (uint k = AURA_BUNDLE / 2; k > 0; k /= 2)
+        {
+                if (lid < k && gid + k < n)
+                {
+                        s[lid] = AURA_REDUCE(s[lid], s[lid + k]);
+                }
+                AURA_SYNC;
+        }
+        if (lid == 0)
+        {
+                partial[gid / AURA_BUNDLE] = s[0];
+        }
+}
+
+AURA_KERNEL void aura_reduce_final(
+        AURA_DEVMEM AURA_T* partial, AURA_VALUE(uint) n
+        AURA_BUNDLE_ID_ARG)
+{
+        AURA_SHARED AURA_T s[AURA_BUNDLE];
+        uint lid = AURA_BUNDLE_ID_0;
+        if (lid < n)
+        {
+                AURA_T acc = partial[lid];
+                for (uint i = lid + AURA_BUNDLE; i < n; i += AURA_BUNDLE)
+                {
+                        acc = AURA_REDUCE(acc, partial[i]);
+                }
+                s[lid] = acc;
+        }
+        AURA_SYNC;
+        for (uint k = AURA_BUNDLE / 2; k > 0; k /= 2)
+        {
+                if (lid < k && lid + k < n)
+                {
+                        s[lid] = AURA_REDUCE(s[lid], s[lid + k]);
+                }
+                AURA_SYNC;
+        }
+        if (lid == 0)
+        {
+                partial[0] = s[0];
+        }
+}
+
+)";
+        return v;
+}
+
+/// Position kernels, specialized with AURA_T, AURA_BUNDLE and
+/// AURA_BETTER(a, b) (a is strictly better than b). Ties are resolved to
+/// the first position.
+inline const std::string& position_source()
+{
+        static std::string v = R"(
+
+AURA_KERNEL void aura_position_partial(
+        AURA_DEVMEM const AURA_T* x, AURA_VALUE(uint) x_offset,
+        AURA_VALUE(uint) n, AURA_DEVMEM AURA_T* partial_value,
+        AURA_DEVMEM uint* partial_index
+        AURA_MESH_ID_ARG
+        AURA_MESH_SIZE_ARG
+        AURA_BUNDLE_ID_ARG)
+{
+        AURA_SHARED AURA_T s[AURA_BUNDLE];
+        AURA_SHARED uint si[AURA_BUNDLE];
+        uint gid = AURA_MESH_ID_0;
+        uint lid = AURA_BUNDLE_ID_0;
+        uint stride = AURA_MESH_SIZE_0;
+        if (gid < n)
+        {
+                AURA_T best = x[x_offset + gid];
+                uint best_index = gid;
+                for (uint i = gid + stride; i < n; i += stride)
+                {
+                        AURA_T v = x[x_offset + i];
+                        if (AURA_BETTER(v, best))
+                        {
+                                best = v;
+                                best_index = i;
+                        }
+                }
+                s[lid] = best;
+                si[lid] = best_index;
+        }
+        AURA_SYNC;
+        for (uint k = AURA_BUNDLE / 2; k > 0; k /= 2)
+        {
+                if (lid < k && gid + k < n)
+                {
+                        AURA_T v = s[lid + k];
+                        uint vi = si[lid + k];
+                        if (AURA_BETTER(v, s[lid]) ||
+                                (!AURA_BETTER(s[lid], v) && vi < si[lid]))
+                        {
+                                s[lid] = v;
+                                si[lid] = vi;
+                        }
+                }
+                AURA_SYNC;
+        }
+        if (lid == 0)
+        {
+                partial_value[gid / AURA_BUNDLE] = s[0];
+                partial_index[gid / AURA_BUNDLE] = si[0];
+        }
+}
+
+AURA_KERNEL void aura_position_final(
+        AURA_DEVMEM AURA_T* partial_value, AURA_DEVMEM uint* partial_index,
+        AURA_VALUE(uint) n
+        AURA_BUNDLE_ID_ARG)
+{
+        AURA_SHARED AURA_T s[AURA_BUNDLE];
+        AURA_SHARED uint si[AURA_BUNDLE];
+        uint lid = AURA_BUNDLE_ID_0;
+        if (lid < n)
+        {
+                AURA_T best = partial_value[lid];
+                uint best_index = partial_index[lid];
+                for (uint i = lid + AURA_BUNDLE; i < n; i += AURA_BUNDLE)
+                {
+                        AURA_T v = partial_value[i];
+                        uint vi = partial_index[i];
+                        if (AURA_BETTER(v, best) ||
+                                (!AURA_BETTER(best, v) && vi < best_index))
+                        {
+                                best = v;
+                                best_index = vi;
+                        }
+                }
+                s[lid] = best;
+                si[lid] = best_index;
+        }
+        AURA_SYNC;
+        for (uint k = AURA_BUNDLE / 2; k > 0; k /= 2)
+        {
+                if (lid < k && lid + k < n)
+                {
+                        AURA_T v = s[lid + k];
+                        uint vi = si[lid + k];
+                        if (AURA_BETTER(v, s[lid]) ||
+                                (!AURA_BETTER(s[lid], v) && vi < si[lid]))
+                        {
+                                s[lid] = v;
+                                si[lid] = vi;
+                        }
+                }
+                AURA_SYNC;
+        }
+        if (lid == 0)
+        {
+                partial_index[0] = si[0];
+        }
+}
+
+)";
+        return v;
+}
+
+/// Reduce transform_op(x[i], y[i]) with reduce_op on the device and
+/// return the result (blocks until it is available).
+template <typename T, typename BinaryOp, typename TransformOp>
+T reduce_impl(device_ptr<T> x, device_ptr<T> y, std::size_t n,
+        BinaryOp reduce_op, TransformOp transform_op, feed& f)
+{
+        check_builtin_size(n);
+        device& d = x.get_device();
+        auto b = builtin_bundle_size(d);
+        auto num_bundles = builtin_num_bundles(d, n, b);
+
+        auto source = alang_type_define<T>("AURA_T") +
+                alang_define("AURA_BUNDLE", b) +
+                "#define AURA_REDUCE(a, b) " + BinaryOp::alang() + "\n" +
+                "#define AURA_TRANSFORM(a, b) " + TransformOp::alang() +
+                "\n" + reduce_source();
+        auto& partial_kernel = builtin_kernel(d, source, "aura_reduce_partial");
+        auto& final_kernel = builtin_kernel(d, source, "aura_reduce_final");
+
+        device_array<T> partial(num_bundles, d);
+        invoke(partial_kernel, mesh({{num_bundles, 1, 1}}),
+                bundle({{b, 1, 1}}),
+                args(x.get_base_ptr(),
+                        builtin_offset(x, n), y.get_base_ptr(),
+                        builtin_offset(y, n),
+                        static_cast<std::uint32_t>(n),
+                        partial.get_base_ptr()),
+                f);
+        invoke(final_kernel, mesh({{1, 1, 1}}), bundle({{b, 1, 1}}),
+                args(partial.get_base_ptr(),
+                        static_cast<std::uint32_t>(num_bundles)),
+                f);
+
+        T result;
+        copy(partial.begin(), partial.begin() + 1, &result, f);
+        wait_for(f);
+        return result;
+}
+
+/// Position of the best element (better(a, b) as alang expression) on
+/// the device (blocks until it is available).
+template <typename T>
+std::size_t position_impl(device_ptr<T> x, std::size_t n,
+        const std::string& better, feed& f)
+{
+        check_builtin_size(n);
+        device& d = x.get_device();
+        auto b = builtin_bundle_size(d);
+        auto num_bundles = builtin_num_bundles(d, n, b);
+
+        auto source = alang_type_define<T>("AURA_T") +
+                alang_define("AURA_BUNDLE", b) +
+                "#define AURA_BETTER(a, b) " + better + "\n" +
+                position_source();
+        auto& partial_kernel =
+                builtin_kernel(d, source, "aura_position_partial");
+        auto& final_kernel = builtin_kernel(d, source, "aura_position_final");
+
+        device_array<T> partial_value(num_bundles, d);
+        device_array<std::uint32_t> partial_index(num_bundles, d);
+        invoke(partial_kernel, mesh({{num_bundles, 1, 1}}),
+                bundle({{b, 1, 1}}),
+                args(x.get_base_ptr(), builtin_offset(x, n),
+                        static_cast<std::uint32_t>(n),
+                        partial_value.get_base_ptr(),
+                        partial_index.get_base_ptr()),
+                f);
+        invoke(final_kernel, mesh({{1, 1, 1}}), bundle({{b, 1, 1}}),
+                args(partial_value.get_base_ptr(),
+                        partial_index.get_base_ptr(),
+                        static_cast<std::uint32_t>(num_bundles)),
+                f);
+
+        std::uint32_t result;
+        copy(partial_index.begin(), partial_index.begin() + 1, &result, f);
+        wait_for(f);
+        return result;
+}
+
+} // namespace detail
+
+/// Reduce range with op, e.g. reduce(first, last, 0.0f, plus(), f).
+/// Blocks until the result is available.
+template <typename T, typename BinaryOp>
+T reduce(device_ptr<T> first, device_ptr<T> last, T init, BinaryOp op,
+        feed& f)
+{
+        if (last - first <= 0)
+        {
+                return init;
+        }
+        return op(init, detail::reduce_impl(first, first, last - first, op,
+                                identity(), f));
+}
+
+/// Sum of range plus init.
+template <typename T>
+T reduce(device_ptr<T> first, device_ptr<T> last, T init, feed& f)
+{
+        return reduce(first, last, init, plus(), f);
+}
+
+/// Reduce array with op.
+template <typename T, typename Allocator, typename BoundsType,
+        typename BinaryOp>
+T reduce(const device_array<T, Allocator, BoundsType>& a, T init,
+        BinaryOp op, feed& f)
+{
+        return reduce(a.begin(), a.end(), init, op, f);
+}
+
+/// Sum of array plus init.
+template <typename T, typename Allocator, typename BoundsType>
+T reduce(const device_array<T, Allocator, BoundsType>& a, T init, feed& f)
+{
+        return reduce(a.begin(), a.end(), init, plus(), f);
+}
+
+/// Reduce transform_op applied to each element with reduce_op, e.g. the
+/// squared norm transform_reduce(first, last, 0.0f, plus(), square(), f).
+template <typename T, typename BinaryOp, typename UnaryOp>
+T transform_reduce(device_ptr<T> first, device_ptr<T> last, T init,
+        BinaryOp reduce_op, UnaryOp transform_op, feed& f)
+{
+        if (last - first <= 0)
+        {
+                return init;
+        }
+        return reduce_op(init, detail::reduce_impl(first, first,
+                                       last - first, reduce_op,
+                                       transform_op, f));
+}
+
+/// Transform and reduce array.
+template <typename T, typename Allocator, typename BoundsType,
+        typename BinaryOp, typename UnaryOp>
+T transform_reduce(const device_array<T, Allocator, BoundsType>& a, T init,
+        BinaryOp reduce_op, UnaryOp transform_op, feed& f)
+{
+        return transform_reduce(
+                a.begin(), a.end(), init, reduce_op, transform_op, f);
+}
+
+/// Dot product of two ranges.
+template <typename T>
+T dot(device_ptr<T> first1, device_ptr<T> last1, device_ptr<T> first2,
+        feed& f)
+{
+        if (last1 - first1 <= 0)
+        {
+                return T();
+        }
+        return detail::reduce_impl(
+                first1, first2, last1 - first1, plus(), multiplies(), f);
+}
+
+/// Dot product of two arrays of the same size.
+template <typename T, typename Allocator, typename BoundsType>
+T dot(const device_array<T, Allocator, BoundsType>& a,
+        const device_array<T, Allocator, BoundsType>& b, feed& f)
+{
+        if (a.size() != b.size())
+        {
+                throw std::string("dot of arrays of different size");
+        }
+        return dot(a.begin(), a.end(), b.begin(), f);
+}
+
+/// First smallest element of range (last if range is empty).
+template <typename T>
+device_ptr<T> min_element(device_ptr<T> first, device_ptr<T> last, feed& f)
+{
+        if (last - first <= 0)
+        {
+                return last;
+        }
+        return first + detail::position_impl(
+                               first, last - first, "((a) < (b))", f);
+}
+
+/// First largest element of range (last if range is empty).
+template <typename T>
+device_ptr<T> max_element(device_ptr<T> first, device_ptr<T> last, feed& f)
+{
+        if (last - first <= 0)
+        {
+                return last;
+        }
+        return first + detail::position_impl(
+                               first, last - first, "((b) < (a))", f);
+}
+
+/// First smallest element of array.
+template <typename T, typename Allocator, typename BoundsType>
+device_ptr<T> min_element(
+        const device_array<T, Allocator, BoundsType>& a, feed& f)
+{
+        return min_element(a.begin(), a.end(), f);
+}
+
+/// First largest element of array.
+template <typename T, typename Allocator, typename BoundsType>
+device_ptr<T> max_element(
+        const device_array<T, Allocator, BoundsType>& a, feed& f)
+{
+        return max_element(a.begin(), a.end(), f);
+}
+
+} // namespace aura
+} // namespace boost
@@ -0,0 +1,355 @@
+#pragma once
+
+#include <boost/aura/algorithm/detail/builtin_kernel.hpp>
+#include <boost/aura/algorithm/functional.hpp>
+#include <boost/aura/device_array.hpp>
+#include <boost/aura/device_ptr.hpp>
+#include <boost/aura/feed.hpp>
+#include <boost/aura/invoke.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace boost
+{
+namespace aura
+{
+namespace detail
+{
+
+/// Scan kernels, specialized with AURA_T (element type), AURA_BUNDLE
+/// (bundle size), AURA_ITEMS (elements per thread) and AURA_SCAN(a, b).
+///
+/// Each bundle handles a tile of AURA_BUNDLE * AURA_ITEMS elements. The
+/// scan reduces every tile, scans the tile sums, and then scans every
+/// tile again starting with the sum of all previous tiles. Tiles are
+/// loaded to local memory with coalesced reads and each thread works on
+/// consecutive elements, so operators need to be associative only.
+inline const std::string& scan_source()
+{
+        static std::string v = R"(
+
+#define AURA_TILE (AURA_BUNDLE * AURA_ITEMS)
+
+AURA_KERNEL void aura_scan_reduce(
+        AURA_DEVMEM const AURA_T* x, AURA_VALUE(uint) x_offset,
+        AURA_VALUE(uint) n, AURA_DEVMEM AURA_T* sums,
+        AURA_VALUE(uint) sums_offset
+        AURA_MESH_ID_ARG
+        AURA_BUNDLE_ID_ARG)
+{
+        AURA_SHARED AURA_T s[AURA_TILE];
+        AURA_SHARED AURA_T t[AURA_BUNDLE];
+        uint lid = AURA_BUNDLE_ID_0;
+        uint tile = AURA_MESH_ID_0 / AURA_BUNDLE;
+        uint first = tile * AURA_TILE;
+        uint m = n - first < AURA_TILE ? n - first : AURA_TILE;
+        for (uint j = lid; j < m; j += AURA_BUNDLE)
+        {
+                s[j] = x[x_offset + first + j];
+        }
+        AURA_SYNC;
+        uint begin = lid * AURA_ITEMS;
+        uint end = begin + AURA_ITEMS < m ? begin + AURA_ITEMS : m;
+        if (begin < m)
+        {
+                AURA_T acc = s[begin];
+                for (uint j = begin + 1; j < end; j++)
+                {
+                        acc = AURA_SCAN(acc, s[j]);
+                }
+                t[lid] = acc;
+        }
+        AURA_SYNC;
+        // Combine neighbours to keep the order of operands.
+        uint threads = (m + AURA_ITEMS - 1) / AURA_ITEMS;
+        for (uint k = 1; k < AURA_BUNDLE; k *= 2)
+        {
+                if (lid % (2 * k) == 0 && lid + k < threads)
+                {
+                        t[lid] = AURA_SCAN(t[lid], t[lid + k]);
+                }
+                AURA_SYNC;
+        }
+        if (lid == 0)
+        {
+                sums[sums_offset + tile] = t[0];
+        }
+}
+
+AURA_KERNEL void aura_scan_tiles(
+        AURA_DEVMEM const AURA_T* x, AURA_VALUE(uint) x_offset,
+        AURA_DEVMEM AURA_T* y, AURA_VALUE(uint) y_offset,
+        AURA_VALUE(uint) n, AURA_DEVMEM const AURA_T* sums,
+        AURA_VALUE(uint) sums_offset, AURA_VALUE(AURA_T) init,
+        AURA_VALUE(uint) has_init, AURA_VALUE(uint) exclusive
+        AURA_MESH_ID_ARG
+        AURA_BUNDLE_ID_ARG)
+{
+        AURA_SHARED AURA_T s[AURA_TILE];
+        AURA_SHARED AURA_T t[AURA_BUNDLE];
+        uint lid = AURA_BUNDLE_ID_0;
+        uint tile = AURA_MESH_ID_0 / AURA_BUNDLE;
+        uint first = tile * AURA_TILE;
+        uint m = n - first < AURA_TILE ? n - first : AURA_TILE;
+        for (uint j = lid; j < m; j += AURA_BUNDLE)
+        {
+                s[j] = x[x_offset + first + j];
+        }
+        AURA_SYNC;
+        uint begin = lid * AURA_ITEMS;
+        uint end = begin + AURA_ITEMS < m ? begin + AURA_ITEMS : m;
+        if (begin < m)
+        {
+                for (uint j = begin + 1; j < end; j++)
+                {
+                        s[j] = AURA_SCAN(s[j - 1], s[j]);
+                }
+                t[lid] = s[end - 1];
+        }
+        AURA_SYNC;
+        // Scan the sums of all threads.
+        uint threads = (m + AURA_ITEMS - 1) / AURA_ITEMS;
+        for (uint k = 1; k < AURA_BUNDLE; k *= 2)
+        {
+                bool add = lid >= k && lid < threads;
+                AURA_T v;
+                if (add)
+                {
+                        v = t[lid - k];
+                }
+                AURA_SYNC;
+                if (add)
+                {
+                        t[lid] = AURA_SCAN(v, t[lid]);
+                }
+                AURA_SYNC;
+        }
+        if (lid > 0 && begin < m)
+        {
+                AURA_T v = t[lid - 1];
+                for (uint j = begin; j < end; j++)
+                {
+                        s[j] = AURA_SCAN(v, s[j]);
+                }
+        }
+        AURA_SYNC;
+        // Sum of init and all previous tiles.
+        bool has_carry = tile > 0 || has_init;
+        AURA_T carry = init;
+        if (tile > 0)
+        {
+                AURA_T sum = sums[sums_offset + tile - 1];
+                carry = has_init ? AURA_SCAN(carry, sum) : sum;
+        }
+        for (uint j = lid; j < m; j += AURA_BUNDLE)
+        {
+                AURA_T v;
+                if (exclusive)
+                {
+                        v = j == 0 ? carry : AURA_SCAN(carry, s[j - 1]);
+                }
+                else
+                {
+                        v = has_carry ? AURA_SCAN(carry, s[j]) : s[j];
+                }
+                y[y_offset + first + j] = v;
+        }
+}
+
+)";
+        return v;
+}
+
+/// Number of elements of temporary storage that scan_impl needs to scan n
+/// elements of T (the tile sums of all levels).
+template <typename T>
+std::size_t scan_storage_size(std::size_t n, device& d)
+{
+        auto b = builtin_bundle_size(d);
+        auto tile = b * builtin_tile_items(d, b, sizeof(T));
+        std::size_t size = 0;
+        for (auto m = n; m > 0;)
+        {
+                auto num_tiles = (m + tile - 1) / tile;
+                size += num_tiles;
+                m = num_tiles > 1 ? num_tiles : 0;
+        }
+        return size;
+}
+
+/// Scan n elements of x to y with op (y may be x), using sums (at least
+/// scan_storage_size<T>(n, d) elements) as temporary storage. Exclusive
+/// scans always have an init value. Returns without waiting for the scan.
+template <typename T, typename BinaryOp>
+void scan_impl(device_ptr<T> x, device_ptr<T> y, std::size_t n, T init,
+        bool has_init, bool exclusive, BinaryOp op, device_ptr<T> sums,
+        feed& f)
+{
+        check_builtin_size(n);
+        device& d = x.get_device();
+        auto b = builtin_bundle_size(d);
+        auto items = builtin_tile_items(d, b, sizeof(T));
+        auto tile = b * items;
+        auto num_tiles = (n + tile - 1) / tile;
+
+        auto source = alang_type_define<T>("AURA_T") +
+                alang_define("AURA_BUNDLE", b) +
+                alang_define("AURA_ITEMS", items) +
+                "#define AURA_SCAN(a, b) " + BinaryOp::alang() + "\n" +
+                scan_source();
+        auto& reduce_kernel = builtin_kernel(d, source, "aura_scan_reduce");
+        auto& tiles_kernel = builtin_kernel(d, source, "aura_scan_tiles");
+
+        // Tile sums, scanned in place (sums of single tiles are not read).
+        // The sums of the next level follow the sums of this level.
+        if (num_tiles > 1)
+        {
+                invoke(reduce_kernel, mesh({{num_tiles, 1, 1}}),
+                        bundle({{b, 1, 1}}),
+                        args(x.get_base_ptr(),
+                                builtin_offset(x, n),
+                                static_cast<std::uint32_t>(n),
+                                sums.get_base_ptr(),
+                                builtin_offset(sums, num_tiles)),
+                        f);
+                scan_impl(sums, sums, num_tiles, T(), false, false, op,
+                        sums + num_tiles, f);
+        }
+        invoke(tiles_kernel, mesh({{num_tiles, 1, 1}}), bundle({{b, 1, 1}}),
+                args(x.get_base_ptr(),
+                        builtin_offset(x, n), y.get_base_ptr(),
+                        builtin_offset(y, n),
+                        static_cast<std::uint32_t>(n), sums.get_base_ptr(),
+                        builtin_offset(sums, num_tiles), init,
+                        static_cast<std::uint32_t>(has_init),
+                        static_cast<std::uint32_t>(exclusive)),
+                f);
+}
+
+/// Scan n elements of x to y with op, allocating temporary storage from
+/// the device (waits for the scan to free the temporary storage).
+template <typename T, typename BinaryOp>
+void scan_impl(device_ptr<T> x, device_ptr<T> y, std::size_t n, T init,
+        bool has_init, bool exclusive, BinaryOp op, feed& f)
+{
+        device& d = x.get_device();
+        device_array<T> sums(scan_storage_size<T>(n, d), d);
+        scan_impl(x, y, n, init, has_init, exclusive, op, sums.begin(), f);
+        wait_for(f);
+}
+
+/// Check that arrays have the same size.
+template <typename T, typename Allocator, typename BoundsType>
+void check_same_size(const device_array<T, Allocator, BoundsType>& a,
+        const device_array<T, Allocator, BoundsType>& b)
+{
+        if (a.size() != b.size())
+        {
+                throw std::string("arrays of different size");
+        }
+}
+
+} // namespace detail
+
+/// Inclusive scan of range with op starting with init, result[i] is
+/// init op first[0] op ... op first[i]. result may be first. Returns the
+/// end of the result (waits for the scan to free the temporary storage).
+template <typename T, typename BinaryOp>
+device_ptr<T> inclusive_scan(device_ptr<T> first, device_ptr<T> last,
+        device_ptr<T> result, BinaryOp op, T init, feed& f)
+{
+        if (last - first <= 0)
+        {
+                return result;
+        }
+        detail::scan_impl(
+                first, result, last - first, init, true, false, op, f);
+        return result + (last - first);
+}
+
+/// Inclusive scan of range with op.
+template <typename T, typename BinaryOp>
+device_ptr<T> inclusive_scan(device_ptr<T> first, device_ptr<T> last,
+        device_ptr<T> result, BinaryOp op, feed& f)
+{
+        if (last - first <= 0)
+        {
+                return result;
+        }
+        detail::scan_impl(
+                first, result, last - first, T(), false, false, op, f);
+        return result + (last - first);
+}
+
+/// Inclusive prefix sum of range.
+template <typename T>
+device_ptr<T> inclusive_scan(device_ptr<T> first, device_ptr<T> last,
+        device_ptr<T> result, feed& f)
+{
+        return inclusive_scan(first, last, result, plus(), f);
+}
+
+/// Exclusive scan of range with op, result[i] is
+/// init op first[0] op ... op first[i - 1]. result may be first.
+template <typename T, typename BinaryOp>
+device_ptr<T> exclusive_scan(device_ptr<T> first, device_ptr<T> last,
+        device_ptr<T> result, T init, BinaryOp op, feed& f)
+{
+        if (last - first <= 0)
+        {
+                return result;
+        }
+        detail::scan_impl(
+                first, result, last - first, init, true, true, op, f);
+        return result + (last - first);
+}
+
+/// Exclusive prefix sum of range.
+template <typename T>
+device_ptr<T> exclusive_scan(device_ptr<T> first, device_ptr<T> last,
+        device_ptr<T> result, T init, feed& f)
+{
+        return exclusive_scan(first, last, result, init, plus(), f);
+}
+
+/// Inclusive scan of array with op.
+template <typename T, typename Allocator, typename BoundsType,
+        typename BinaryOp>
+void inclusive_scan(const device_array<T, Allocator, BoundsType>& in,
+        device_array<T, Allocator, BoundsType>& out, BinaryOp op, feed& f)
+{
+        detail::check_same_size(in, out);
+        inclusive_scan(in.begin(), in.end(), out.begin(), op, f);
+}
+
+/// Inclusive prefix sum of array.
+template <typename T, typename Allocator, typename BoundsType>
+void inclusive_scan(const device_array<T, Allocator, BoundsType>& in,
+        device_array<T, Allocator, BoundsType>& out, feed& f)
+{
+        inclusive_scan(in, out, plus(), f);
+}
+
+/// Exclusive scan of array with op.
+template <typename T, typename Allocator, typename BoundsType,
+        typename BinaryOp>
+void exclusive_scan(const device_array<T, Allocator, BoundsType>& in,
+        device_array<T, Allocator, BoundsType>& out, T init, BinaryOp op,
+        feed& f)
+{
+        detail::check_same_size(in, out);
+        exclusive_scan(in.begin(), in.end(), out.begin(), init, op, f);
+}
+
+/// Exclusive prefix sum of array.
+template <typename T, typename Allocator, typename BoundsType>
+void exclusive_scan(const device_array<T, Allocator, BoundsType>& in,
+        device_array<T, Allocator, BoundsType>& out, T init, feed& f)
+{
+        exclusive_scan(in, out, init, plus(), f);
+}
+
+} // namespace aura
+} // namespace boost
@@ -0,0 +1,513 @@
+#pragma once
+
+#include <boost/aura/algorithm/detail/builtin_kernel.hpp>
+#include <boost/aura/algorithm/functional.hpp>
+#include <boost/aura/algorithm/scan.hpp>
+#include <boost/aura/device.hpp>
+#include <boost/aura/device_allocator.hpp>
+#include <boost/aura/device_array.hpp>
+#include <boost/aura/device_ptr.hpp>
+#include <boost/aura/feed.hpp>
+#include <boost/aura/invoke.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace boost
+{
+namespace aura
+{
+
+/// Temporary storage of sort and sort_by_key.
+///
+/// Arrays (temporary keys and values, digit counts and the partial sums
+/// of the scan of the counts) grow to the largest sort and are kept, so
+/// repeated sorts with the same storage do not allocate device memory.
+/// Storage is allocated from the device of the sorted data, or with
+/// allocators (e.g. device_pool_allocator). The storage must live until
+/// the sorts that use it are done.
+/// @tparam K key type (4 or 8 bytes)
+/// @tparam V value type (4 or 8 bytes)
+/// @tparam Allocator allocator template
+template <typename K, typename V = K,
+        template <class> class Allocator = device_allocator>
+class sort_storage
+{
+public:
+        typedef device_array<K, Allocator<K>> key_array;
+        typedef device_array<V, Allocator<V>> value_array;
+        typedef device_array<std::uint32_t, Allocator<std::uint32_t>>
+                count_array;
+
+        /// Create storage that allocates from the device.
+        sort_storage()
+                : key_allocator_(nullptr)
+                , value_allocator_(nullptr)
+                , count_allocator_(nullptr)
+        {
+        }
+
+        /// Create storage that allocates with allocators.
+        sort_storage(Allocator<K>& keys, Allocator<V>& values,
+                Allocator<std::uint32_t>& counts)
+                : key_allocator_(&keys)
+                , value_allocator_(&values)
+                , count_allocator_(&counts)
+        {
+        }
+
+        /// Prevent copies.
+        sort_storage(const sort_storage&) = delete;
+        void operator=(const sort_storage&) = delete;
+
+        /// Make room for sorting n keys (with values if values is set) with
+        /// num_counts digit counts and num_sums partial sums.
+        void reserve(std::size_t n, bool values, std::size_t num_counts,
+                std::size_t num_sums, device& d)
+        {
+                grow_(keys_, n, key_allocator_, d);
+                if (values)
+                {
+                        grow_(values_, n, value_allocator_, d);
+                }
+                grow_(counts_, num_counts, count_allocator_, d);
+                grow_(sums_, num_sums, count_allocator_, d);
+        }
+
+        /// Release memory.
+        void clear()
+        {
+                keys_ = key_array();
+                values_ = value_array();
+                counts_ = count_array();
+                sums_ = count_array();
+        }
+
+        /// Access temporary keys.
+        key_array& keys() { return keys_; }
+
+        /// Access temporary values.
+        value_array& values() { return values_; }
+
+        /// Access digit counts.
+        count_array& counts() { return counts_; }
+
+        /// Access partial sums of the scan of the digit counts.
+        count_array& sums() { return sums_; }
+
+private:
+        /// Replace array by one of at least n elements if it is smaller.
+        template <typename T>
+        static void grow_(device_array<T, Allocator<T>>& a, std::size_t n,
+                Allocator<T>* allocator, device& d)
+        {
+                if (a.size() >= n)
+                {
+                        return;
+                }
+                if (allocator != nullptr)
+                {
+                        a = device_array<T, Allocator<T>>(n, *allocator, d);
+                }
+                else
+                {
+                        a = device_array<T, Allocator<T>>(n, d);
+                }
+        }
+
+        /// Allocators (nullptr allocates from the device).
+        Allocator<K>* key_allocator_;
+        Allocator<V>* value_allocator_;
+        Allocator<std::uint32_t>* count_allocator_;
+
+        /// Temporary keys and values.
+        key_array keys_;
+        value_array values_;
+
+        /// Digit counts of all tiles.
+        count_array counts_;
+
+        /// Partial sums of the scan of the digit counts.
+        count_array sums_;
+};
+
+namespace detail
+{
+
+/// Radix sort kernels, specialized with AURA_U (unsigned type of the key
+/// bits), AURA_V (unsigned type of the value bits), AURA_HAS_VALUES,
+/// AURA_ORDER(k) (key bits in ascending order of keys), AURA_BUNDLE,
+/// AURA_ITEMS and AURA_DIGIT_BITS.
+///
+/// A pass sorts the digit at shift. Each bundle sorts its tile by the
+/// digit in local memory (one stable split per bit) and counts the
+/// digits. The counts are stored digit major, so their exclusive scan is
+/// the position of the first element of each digit and tile. Each bundle
+/// then moves its sorted tile to these positions.
+inline const std::string& radix_sort_source()
+{
+        static std::string v = R"(
+
+#define AURA_TILE (AURA_BUNDLE * AURA_ITEMS)
+#define AURA_RADIX (1 << AURA_DIGIT_BITS)
+#define AURA_DIGIT(k) ((uint)((AURA_ORDER(k) >> shift) & (AURA_RADIX - 1)))
+
+AURA_KERNEL void aura_radix_tiles(
+        AURA_DEVMEM const AURA_U* keys, AURA_VALUE(uint) keys_offset,
+        AURA_DEVMEM const AURA_V* values, AURA_VALUE(uint) values_offset,
+        AURA_VALUE(uint) n, AURA_VALUE(uint) shift,
+        AURA_DEVMEM AURA_U* tmp_keys, AURA_DEVMEM AURA_V* tmp_values,
+        AURA_DEVMEM uint* counts, AURA_VALUE(uint) num_tiles
+        AURA_MESH_ID_ARG
+        AURA_BUNDLE_ID_ARG)
+{
+        AURA_SHARED AURA_U sk[AURA_TILE];
+#if AURA_HAS_VALUES
+        AURA_SHARED AURA_V sv[AURA_TILE];
+#endif
+        AURA_SHARED uint t[AURA_BUNDLE];
+        AURA_SHARED uint starts[AURA_RADIX];
+        AURA_SHARED uint ends[AURA_RADIX];
+        uint lid = AURA_BUNDLE_ID_0;
+        uint tile = AURA_MESH_ID_0 / AURA_BUNDLE;
+        uint first = tile * AURA_TILE;
+        uint m = n - first < AURA_TILE ? n - first : AURA_TILE;
+        for (uint j = lid; j < m; j += AURA_BUNDLE)
+        {
+                sk[j] = keys[keys_offset + first + j];
+#if AURA_HAS_VALUES
+                sv[j] = values[values_offset + first + j];
+#endif
+        }
+        for (uint j = lid; j < AURA_RADIX; j += AURA_BUNDLE)
+        {
+                starts[j] = 0;
+                ends[j] = 0;
+        }
+        AURA_SYNC;
+
+        // Stable split by each bit of the digit, zeros first.
+        uint begin = lid * AURA_ITEMS;
+        uint end = begin + AURA_ITEMS < m ? begin + AURA_ITEMS : m;
+        for (uint bit = 0; bit < AURA_DIGIT_BITS; bit++)
+        {
+                AURA_U k[AURA_ITEMS];
+#if AURA_HAS_VALUES
+                AURA_V v[AURA_ITEMS];
+#endif
+                uint zeros = 0;
+                for (uint j = begin; j < end; j++)
+                {
+                        k[j - begin] = sk[j];
+#if AURA_HAS_VALUES
+                        v[j - begin] = sv[j];
+#endif
+                        zeros += (AURA_DIGIT(sk[j]) >> bit) & 1 ? 0 : 1;
+                }
+                t[lid] = zeros;
+                AURA_SYNC;
+                for (uint s = 1; s < AURA_BUNDLE; s *= 2)
+                {
+                        uint z = lid >= s ? t[lid - s] : 0;
+                        AURA_SYNC;
+                        t[lid] += z;
+                        AURA_SYNC;
+                }
+                uint total = t[AURA_BUNDLE - 1];
+                uint z = lid > 0 ? t[lid - 1] : 0;
+                uint o = total + begin - z;
+                AURA_SYNC;
+                for (uint j = begin; j < end; j++)
+                {
+                        uint dst = (AURA_DIGIT(k[j - begin]) >> bit) & 1 ?
+                                o++ : z++;
+                        sk[dst] = k[j - begin];
+#if AURA_HAS_VALUES
+                        sv[dst] = v[j - begin];
+#endif
+                }
+                AURA_SYNC;
+        }
+
+        // Write sorted tile and find the range of each digit.
+        for (uint j = lid; j < m; j += AURA_BUNDLE)
+        {
+                uint digit = AURA_DIGIT(sk[j]);
+                if (j == 0 || AURA_DIGIT(sk[j - 1]) != digit)
+                {
+                        starts[digit] = j;
+                }
+                if (j + 1 == m || AURA_DIGIT(sk[j + 1]) != digit)
+                {
+                        ends[digit] = j + 1;
+                }
+                tmp_keys[first + j] = sk[j];
+#if AURA_HAS_VALUES
+                tmp_values[first + j] = sv[j];
+#endif
+        }
+        AURA_SYNC;
+        for (uint j = lid; j < AURA_RADIX; j += AURA_BUNDLE)
+        {
+                counts[j * num_tiles + tile] = ends[j] - starts[j];
+        }
+}
+
+AURA_KERNEL void aura_radix_scatter(
+        AURA_DEVMEM const AURA_U* tmp_keys,
+        AURA_DEVMEM const AURA_V* tmp_values, AURA_VALUE(uint) n,
+        AURA_VALUE(uint) shift, AURA_DEVMEM const uint* counts,
+        AURA_VALUE(uint) num_tiles, AURA_DEVMEM AURA_U* keys,
+        AURA_VALUE(uint) keys_offset, AURA_DEVMEM AURA_V* values,
+        AURA_VALUE(uint) values_offset
+        AURA_MESH_ID_ARG
+        AURA_BUNDLE_ID_ARG)
+{
+        AURA_SHARED uint starts[AURA_RADIX];
+        uint lid = AURA_BUNDLE_ID_0;
+        uint tile = AURA_MESH_ID_0 / AURA_BUNDLE;
+        uint first = tile * AURA_TILE;
+        uint m = n - first < AURA_TILE ? n - first : AURA_TILE;
+        for (uint j = lid; j < m; j += AURA_BUNDLE)
+        {
+                uint digit = AURA_DIGIT(tmp_keys[first + j]);
+                if (j == 0 || AURA_DIGIT(tmp_keys[first + j - 1]) != digit)
+                {
+                        starts[digit] = j;
+                }
+        }
+        AURA_SYNC;
+        for (uint j = lid; j < m; j += AURA_BUNDLE)
+        {
+                AURA_U key = tmp_keys[first + j];
+                uint digit = AURA_DIGIT(key);
+                uint dst = counts[digit * num_tiles + tile] + j -
+                        starts[digit];
+                keys[keys_offset + dst] = key;
+#if AURA_HAS_VALUES
+                values[values_offset + dst] = tmp_values[first + j];
+#endif
+        }
+}
+
+)";
+        return v;
+}
+
+/// Unsigned type with the bits of T. Keys and values of radix sorts are
+/// moved as these bits, so both must have 4 or 8 bytes.
+template <typename T>
+struct radix_bits
+{
+        static_assert(sizeof(T) == 4 || sizeof(T) == 8,
+                "radix sort supports 4 and 8 byte types");
+        typedef typename std::conditional<sizeof(T) == 4, std::uint32_t,
+                std::uint64_t>::type type;
+};
+
+/// Alang expression of the bits k of a key of type K that orders the
+/// bits like the keys: flip the sign bit of signed integers, flip the
+/// sign bit of positive and all bits of negative floats.
+template <typename K>
+std::string radix_order()
+{
+        static_assert(std::is_integral<K>::value ||
+                        std::is_floating_point<K>::value,
+                "radix sort supports integer and floating point keys");
+        std::string sign = sizeof(K) == 4 ? "((AURA_U)1 << 31)" :
+                                            "((AURA_U)1 << 63)";
+        if (std::is_floating_point<K>::value)
+        {
+                return "(((k) & " + sign + ") ? ~(k) : ((k) ^ " + sign +
+                        "))";
+        }
+        if (std::is_signed<K>::value)
+        {
+                return "((k) ^ " + sign + ")";
+        }
+        return "(k)";
+}
+
+/// Sort n keys (and values if values is set) on the device.
+template <typename K, typename V, template <class> class Allocator>
+void radix_sort_impl(device_ptr<K> keys, device_ptr<V> values, bool has_values,
+        std::size_t n, sort_storage<K, V, Allocator>& storage,
+        std::size_t digit_bits, feed& f)
+{
+        if (digit_bits < 1 || digit_bits > 8)
+        {
+                throw std::string("radix sort digit width must be 1 to 8 "
+                                  "bits");
+        }
+        check_builtin_size(n);
+        device& d = keys.get_device();
+        auto b = builtin_bundle_size(d);
+        auto items = builtin_tile_items(
+                d, b, sizeof(K) + (has_values ? sizeof(V) : 0));
+        auto tile = b * items;
+        auto num_tiles = (n + tile - 1) / tile;
+        std::size_t radix = 1 << digit_bits;
+        check_builtin_size(radix * num_tiles);
+
+        auto source = alang_type_define<typename radix_bits<K>::type>(
+                              "AURA_U") +
+                alang_type_define<typename radix_bits<V>::type>("AURA_V") +
+                alang_define("AURA_HAS_VALUES", has_values ? 1 : 0) +
+                "#define AURA_ORDER(k) " + radix_order<K>() + "\n" +
+                alang_define("AURA_BUNDLE", b) +
+                alang_define("AURA_ITEMS", items) +
+                alang_define("AURA_DIGIT_BITS", digit_bits) +
+                radix_sort_source();
+        auto& tiles_kernel = builtin_kernel(d, source, "aura_radix_tiles");
+        auto& scatter_kernel =
+                builtin_kernel(d, source, "aura_radix_scatter");
+
+        storage.reserve(n, has_values, radix * num_tiles,
+                scan_storage_size<std::uint32_t>(radix * num_tiles, d), d);
+        // Kernels ignore values without AURA_HAS_VALUES, values and
+        // tmp_values are null then.
+        auto values_ptr = values.get_base_ptr();
+        auto keys_offset = builtin_offset(keys, n);
+        auto values_offset = builtin_offset(values, has_values ? n : 0);
+        auto tmp_keys = storage.keys().get_base_ptr();
+        auto tmp_values = has_values ? storage.values().get_base_ptr() :
+                                       device_ptr<V>().get_base_ptr();
+        auto counts = storage.counts().begin();
+        auto sums = storage.sums().begin();
+        for (std::size_t shift = 0; shift < 8 * sizeof(K);
+                shift += digit_bits)
+        {
+                invoke(tiles_kernel, mesh({{num_tiles, 1, 1}}),
+                        bundle({{b, 1, 1}}),
+                        args(keys.get_base_ptr(),
+                                keys_offset,
+                                values_ptr,
+                                values_offset,
+                                static_cast<std::uint32_t>(n),
+                                static_cast<std::uint32_t>(shift), tmp_keys,
+                                tmp_values, counts.get_base_ptr(),
+                                static_cast<std::uint32_t>(num_tiles)),
+                        f);
+                scan_impl(counts, counts, radix * num_tiles,
+                        std::uint32_t(0), true, true, plus(), sums, f);
+                invoke(scatter_kernel, mesh({{num_tiles, 1, 1}}),
+                        bundle({{b, 1, 1}}),
+                        args(tmp_keys, tmp_values,
+                                static_cast<std::uint32_t>(n),
+                                static_cast<std::uint32_t>(shift),
+                                counts.get_base_ptr(),
+                                static_cast<std::uint32_t>(num_tiles),
+                                keys.get_base_ptr(),
+                                keys_offset,
+                                values_ptr,
+                                values_offset),
+                        f);
+        }
+}
+
+} // namespace detail
+
+/// Sort range in ascending order with a LSD radix sort of digit_bits (1 to
+/// 8) bits per pass, using temporary storage s. Keys are 4 or 8 byte
+/// integers or floating point numbers (NaNs are sorted by their bits).
+/// Returns without waiting for the sort.
+template <typename K, typename V, template <class> class Allocator>
+void sort(device_ptr<K> first, device_ptr<K> last,
+        sort_storage<K, V, Allocator>& s, feed& f, std::size_t digit_bits = 4)
+{
+        if (last - first <= 1)
+        {
+                return;
+        }
+        detail::radix_sort_impl(first, device_ptr<V>(), false, last - first, s,
+                digit_bits, f);
+}
+
+/// Sort range (waits for the sort to free the temporary storage).
+template <typename K>
+void sort(device_ptr<K> first, device_ptr<K> last, feed& f,
+        std::size_t digit_bits = 4)
+{
+        sort_storage<K> s;
+        sort(first, last, s, f, digit_bits);
+        wait_for(f);
+}
+
+/// Sort array using temporary storage s.
+template <typename K, typename KeyAllocator, typename BoundsType,
+        typename V, template <class> class Allocator>
+void sort(device_array<K, KeyAllocator, BoundsType>& a,
+        sort_storage<K, V, Allocator>& s, feed& f, std::size_t digit_bits = 4)
+{
+        sort(a.begin(), a.end(), s, f, digit_bits);
+}
+
+/// Sort array.
+template <typename K, typename KeyAllocator, typename BoundsType>
+void sort(device_array<K, KeyAllocator, BoundsType>& a, feed& f,
+        std::size_t digit_bits = 4)
+{
+        sort(a.begin(), a.end(), f, digit_bits);
+}
+
+/// Sort keys and reorder values (starting at values_first) with them. The
+/// sort is stable. Values are 4 or 8 byte types. Returns without waiting
+/// for the sort.
+template <typename K, typename V, template <class> class Allocator>
+void sort_by_key(device_ptr<K> keys_first, device_ptr<K> keys_last,
+        device_ptr<V> values_first, sort_storage<K, V, Allocator>& s, feed& f,
+        std::size_t digit_bits = 4)
+{
+        if (keys_last - keys_first <= 1)
+        {
+                return;
+        }
+        detail::radix_sort_impl(keys_first, values_first, true,
+                keys_last - keys_first, s, digit_bits, f);
+}
+
+/// Sort keys and values (waits for the sort to free the temporary
+/// storage).
+template <typename K, typename V>
+void sort_by_key(device_ptr<K> keys_first, device_ptr<K> keys_last,
+        device_ptr<V> values_first, feed& f, std::size_t digit_bits = 4)
+{
+        sort_storage<K, V> s;
+        sort_by_key(keys_first, keys_last, values_first, s, f, digit_bits);
+        wait_for(f);
+}
+
+/// Sort key array and value array of the same size using storage s.
+template <typename K, typename KeyAllocator, typename V,
+        typename ValueAllocator, typename BoundsType,
+        template <class> class Allocator>
+void sort_by_key(device_array<K, KeyAllocator, BoundsType>& keys,
+        device_array<V, ValueAllocator, BoundsType>& values,
+        sort_storage<K, V, Allocator>& s, feed& f, std::size_t digit_bits = 4)
+{
+        if (keys.size() != values.size())
+        {
+                throw std::string("arrays of different size");
+        }
+        sort_by_key(keys.begin(), keys.end(), values.begin(), s, f,
+                digit_bits);
+}
+
+/// Sort key array and value array of the same size.
+template <typename K, typename KeyAllocator, typename V,
+        typename ValueAllocator, typename BoundsType>
+void sort_by_key(device_array<K, KeyAllocator, BoundsType>& keys,
+        device_array<V, ValueAllocator, BoundsType>& values, feed& f,
+        std::size_t digit_bits = 4)
+{
+        if (keys.size() != values.size())
+        {
+                throw std::string("arrays of different size");
+        }
+        sort_by_key(keys.begin(), keys.end(), values.begin(), f, digit_bits);
+}
+
+} // namespace aura
+} // namespace boost
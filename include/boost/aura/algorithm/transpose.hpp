@@ -0,0 +1,366 @@
+#pragma once
+
+#include <boost/aura/algorithm/detail/builtin_kernel.hpp>
+#include <boost/aura/bounds.hpp>
+#include <boost/aura/copy.hpp>
+#include <boost/aura/device_array.hpp>
+#include <boost/aura/device_ptr.hpp>
+#include <boost/aura/feed.hpp>
+#include <boost/aura/invoke.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace boost
+{
+namespace aura
+{
+namespace detail
+{
+
+/// Permutation kernels, specialized with AURA_T, AURA_TILE_DIM,
+/// AURA_TILE_ROWS and AURA_MAX_RANK. The geometry is passed by value and
+/// holds extent, input stride and output stride of each input axis.
+///
+/// aura_permute_copy is used if the fastest axis stays the fastest axis,
+/// reads and writes are coalesced then. Otherwise aura_permute_tiles
+/// moves tiles of the fastest input axis and the input axis that becomes
+/// the fastest output axis through local memory, one tile per bundle, and
+/// all other axes are batch axes.
+inline const std::string& permute_source()
+{
+        static std::string v = R"(
+
+typedef struct
+{
+        uint v[3 * AURA_MAX_RANK];
+} aura_permute_geometry;
+
+AURA_KERNEL void aura_permute_copy(
+        AURA_DEVMEM const AURA_T* x, AURA_VALUE(uint) x_offset,
+        AURA_DEVMEM AURA_T* y, AURA_VALUE(uint) y_offset,
+        AURA_VALUE(aura_permute_geometry) geometry, AURA_VALUE(uint) rank,
+        AURA_VALUE(uint) n
+        AURA_MESH_ID_ARG
+        AURA_MESH_SIZE_ARG)
+{
+        for (uint i = AURA_MESH_ID_0; i < n; i += AURA_MESH_SIZE_0)
+        {
+                uint rest = i;
+                uint dst = 0;
+                for (uint k = 0; k < rank; k++)
+                {
+                        uint e = geometry.v[3 * k];
+                        dst += (rest % e) * geometry.v[3 * k + 2];
+                        rest /= e;
+                }
+                y[y_offset + dst] = x[x_offset + i];
+        }
+}
+
+AURA_KERNEL void aura_permute_tiles(
+        AURA_DEVMEM const AURA_T* x, AURA_VALUE(uint) x_offset,
+        AURA_DEVMEM AURA_T* y, AURA_VALUE(uint) y_offset,
+        AURA_VALUE(aura_permute_geometry) geometry, AURA_VALUE(uint) rank,
+        AURA_VALUE(uint) axis
+        AURA_MESH_ID_ARG
+        AURA_BUNDLE_ID_ARG)
+{
+        // Padding shifts the columns of the tile to different banks.
+        AURA_SHARED AURA_T s[AURA_TILE_DIM][AURA_TILE_DIM + 1];
+        uint tx = AURA_BUNDLE_ID_0;
+        uint ty = AURA_BUNDLE_ID_1;
+        uint e0 = geometry.v[0];
+        uint out_stride = geometry.v[2];
+        uint ea = geometry.v[3 * axis];
+        uint in_stride = geometry.v[3 * axis + 1];
+        uint tiles0 = (e0 + AURA_TILE_DIM - 1) / AURA_TILE_DIM;
+        uint tilesa = (ea + AURA_TILE_DIM - 1) / AURA_TILE_DIM;
+        uint g = AURA_MESH_ID_0 / AURA_TILE_DIM;
+        uint t0 = g % tiles0;
+        g /= tiles0;
+        uint ta = g % tilesa;
+        g /= tilesa;
+
+        // Offsets of the batch axes.
+        uint src = x_offset;
+        uint dst = y_offset;
+        for (uint k = 1; k < rank; k++)
+        {
+                if (k != axis)
+                {
+                        uint e = geometry.v[3 * k];
+                        src += (g % e) * geometry.v[3 * k + 1];
+                        dst += (g % e) * geometry.v[3 * k + 2];
+                        g /= e;
+                }
+        }
+
+        for (uint j = ty; j < AURA_TILE_DIM; j += AURA_TILE_ROWS)
+        {
+                uint c0 = t0 * AURA_TILE_DIM + tx;
+                uint ca = ta * AURA_TILE_DIM + j;
+                if (c0 < e0 && ca < ea)
+                {
+                        s[j][tx] = x[src + c0 + ca * in_stride];
+                }
+        }
+        AURA_SYNC;
+        for (uint j = ty; j < AURA_TILE_DIM; j += AURA_TILE_ROWS)
+        {
+                uint ca = ta * AURA_TILE_DIM + tx;
+                uint c0 = t0 * AURA_TILE_DIM + j;
+                if (c0 < e0 && ca < ea)
+                {
+                        y[dst + ca + c0 * out_stride] = s[tx][j];
+                }
+        }
+}
+
+)";
+        return v;
+}
+
+/// Axes of a permutation after dropping axes of extent one and merging
+/// input axes that stay neighbours in the output.
+struct permute_geometry
+{
+        /// Extent of each input axis.
+        std::vector<std::size_t> extents;
+
+        /// Stride of each input axis in the input.
+        std::vector<std::size_t> in_strides;
+
+        /// Stride of each input axis in the output.
+        std::vector<std::size_t> out_strides;
+
+        /// Input axis that is the fastest output axis.
+        std::size_t axis;
+};
+
+/// Geometry of permutation axes of array with bounds b.
+inline permute_geometry make_permute_geometry(
+        const bounds& b, const bounds& axes)
+{
+        std::size_t rank = b.size();
+        if (axes.size() != rank)
+        {
+                throw std::string("permutation and array differ in rank");
+        }
+        std::vector<bool> seen(rank, false);
+        for (std::size_t i = 0; i < rank; i++)
+        {
+                if (axes[i] >= rank || seen[axes[i]])
+                {
+                        throw std::string("invalid axis permutation");
+                }
+                seen[axes[i]] = true;
+        }
+
+        // Output position of each input axis, counting only axes with an
+        // extent larger than one.
+        std::vector<std::size_t> position(rank, 0);
+        std::size_t num_positions = 0;
+        for (std::size_t i = 0; i < rank; i++)
+        {
+                if (b[axes[i]] > 1)
+                {
+                        position[axes[i]] = num_positions++;
+                }
+        }
+
+        std::vector<std::size_t> extents;
+        std::vector<std::size_t> positions;
+        for (std::size_t k = 0; k < rank; k++)
+        {
+                if (b[k] <= 1)
+                {
+                        continue;
+                }
+                if (!positions.empty() && position[k] == positions.back() + 1)
+                {
+                        extents.back() *= b[k];
+                        positions.back() = position[k];
+                        continue;
+                }
+                extents.push_back(b[k]);
+                positions.push_back(position[k]);
+        }
+        if (extents.empty())
+        {
+                extents.push_back(1);
+                positions.push_back(0);
+        }
+
+        permute_geometry g;
+        g.extents = extents;
+        g.in_strides.resize(extents.size());
+        g.out_strides.resize(extents.size());
+        g.axis = 0;
+        std::size_t stride = 1;
+        for (std::size_t k = 0; k < extents.size(); k++)
+        {
+                g.in_strides[k] = stride;
+                stride *= extents[k];
+        }
+        // Merged axes keep the last position of their members, so the
+        // output order of merged axes is the order of positions.
+        for (std::size_t k = 0; k < extents.size(); k++)
+        {
+                std::size_t s = 1;
+                for (std::size_t j = 0; j < extents.size(); j++)
+                {
+                        if (positions[j] < positions[k])
+                        {
+                                s *= extents[j];
+                        }
+                }
+                g.out_strides[k] = s;
+                if (s == 1)
+                {
+                        g.axis = k;
+                }
+        }
+        return g;
+}
+
+/// Geometry as kernel argument, layout of aura_permute_geometry.
+struct permute_geometry_arg
+{
+        std::uint32_t v[3 * AURA_TINY_VECTOR_MAX_SIZE];
+};
+
+/// Pack geometry into a kernel argument.
+inline permute_geometry_arg make_permute_geometry_arg(
+        const permute_geometry& g)
+{
+        permute_geometry_arg a = {};
+        for (std::size_t k = 0; k < g.extents.size(); k++)
+        {
+                a.v[3 * k] = g.extents[k];
+                a.v[3 * k + 1] = g.in_strides[k];
+                a.v[3 * k + 2] = g.out_strides[k];
+        }
+        return a;
+}
+
+/// Write x permuted to y: axis i of y is axis axes[i] of x (bounds b).
+template <typename T>
+void permute_impl(device_ptr<T> x, const bounds& b, const bounds& axes,
+        device_ptr<T> y, feed& f)
+{
+        auto g = make_permute_geometry(b, axes);
+        std::size_t n = product(b);
+        if (n == 0)
+        {
+                return;
+        }
+        check_builtin_size(n);
+        if (g.extents.size() == 1)
+        {
+                copy(x, x + n, y, f);
+                return;
+        }
+
+        device& d = x.get_device();
+        auto bundle_size = builtin_bundle_size(d);
+        std::size_t tile_dim = std::min<std::size_t>(32, bundle_size);
+        std::size_t tile_rows = std::max<std::size_t>(
+                std::min<std::size_t>({8, bundle_size / tile_dim,
+                        d.get_properties().max_bundle_extent[1]}),
+                1);
+        auto source = alang_type_define<T>("AURA_T") +
+                alang_define("AURA_TILE_DIM", tile_dim) +
+                alang_define("AURA_TILE_ROWS", tile_rows) +
+                alang_define("AURA_MAX_RANK", AURA_TINY_VECTOR_MAX_SIZE) +
+                permute_source();
+        auto geometry = make_permute_geometry_arg(g);
+        auto rank = static_cast<std::uint32_t>(g.extents.size());
+
+        if (g.axis == 0)
+        {
+                auto& copy_kernel =
+                        builtin_kernel(d, source, "aura_permute_copy");
+                auto num_bundles = std::min<std::size_t>(
+                        (n + bundle_size - 1) / bundle_size, 65536);
+                invoke(copy_kernel, mesh({{num_bundles, 1, 1}}),
+                        bundle({{bundle_size, 1, 1}}),
+                        args(x.get_base_ptr(),
+                                builtin_offset(x, n),
+                                y.get_base_ptr(),
+                                builtin_offset(y, n),
+                                geometry, rank,
+                                static_cast<std::uint32_t>(n)),
+                        f);
+                return;
+        }
+
+        auto& tiles_kernel = builtin_kernel(d, source, "aura_permute_tiles");
+        std::size_t num_tiles = n / (g.extents[0] * g.extents[g.axis]);
+        num_tiles *= (g.extents[0] + tile_dim - 1) / tile_dim;
+        num_tiles *= (g.extents[g.axis] + tile_dim - 1) / tile_dim;
+        check_builtin_size(num_tiles * tile_dim);
+        invoke(tiles_kernel, mesh({{num_tiles, 1, 1}}),
+                bundle({{tile_dim, tile_rows, 1}}),
+                args(x.get_base_ptr(),
+                        builtin_offset(x, n),
+                        y.get_base_ptr(),
+                        builtin_offset(y, n),
+                        geometry, rank,
+                        static_cast<std::uint32_t>(g.axis)),
+                f);
+}
+
+} // namespace detail
+
+/// Permute axes of array in to out: axis i of out is axis axes[i] of in,
+/// so out must have the bounds in[axes[0]], in[axes[1]], ... The first
+/// axis of an array is the fastest (stored contiguously). Converting n
+/// structs of k fields (bounds {k, n}) to k arrays of n fields is the
+/// permutation {1, 0}. out must not overlap in. Returns without waiting
+/// for the permutation.
+template <typename T, typename Allocator1, typename Allocator2>
+void permute(const device_array<T, Allocator1, bounds>& in,
+        device_array<T, Allocator2, bounds>& out, const bounds& axes,
+        feed& f)
+{
+        auto b = in.bounds();
+        if (axes.size() != b.size())
+        {
+                throw std::string("permutation and array differ in rank");
+        }
+        bounds expected;
+        for (std::size_t i = 0; i < axes.size(); i++)
+        {
+                if (axes[i] >= b.size())
+                {
+                        throw std::string("invalid axis permutation");
+                }
+                expected.push_back(b[axes[i]]);
+        }
+        if (out.bounds() != expected)
+        {
+                throw std::string("output bounds do not match permutation");
+        }
+        detail::permute_impl(in.begin(), b, axes, out.begin(), f);
+}
+
+/// Transpose array in to out (reverse the order of axes), e.g. a matrix
+/// with bounds {columns, rows} becomes {rows, columns}.
+template <typename T, typename Allocator1, typename Allocator2>
+void transpose(const device_array<T, Allocator1, bounds>& in,
+        device_array<T, Allocator2, bounds>& out, feed& f)
+{
+        bounds axes;
+        for (std::size_t i = in.bounds().size(); i > 0; i--)
+        {
+                axes.push_back(i - 1);
+        }
+        permute(in, out, axes, f);
+}
+
+} // namespace aura
+} // namespace boost
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+namespace boost
+{
+namespace aura
+{
+
+/// Bundle sizes a kernel can be launched with on a device.
+struct bundle_limits
+{
+        /// Maximum number of threads in a bundle.
+        std::size_t max_size;
+
+        /// Maximum bundle extent in each dimension.
+        std::array<std::size_t, 3> max_extent;
+
+        /// Bundle sizes should be a multiple of this (warp/wavefront size).
+        std::size_t preferred_multiple;
+
+        /// Name of the device, identifies tuning results.
+        std::string device_name;
+};
+
+} // namespace aura
+} // namespace boost
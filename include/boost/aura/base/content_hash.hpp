@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+namespace boost
+{
+namespace aura
+{
+namespace detail
+{
+
+/// 128 bit content hash (two FNV-1a 64 bit hashes with different offset
+/// bases) of a list of strings, returned as hex string.
+inline std::string content_hash(std::initializer_list<std::string> parts)
+{
+        const std::uint64_t prime = 0x100000001b3ULL;
+        std::uint64_t h0 = 0xcbf29ce484222325ULL;
+        std::uint64_t h1 = 0x84222325cbf29ce4ULL;
+        std::uint64_t length = 0;
+
+        auto process = [&](unsigned char c)
+        {
+                h0 = (h0 ^ c) * prime;
+                h1 = (h1 ^ static_cast<unsigned char>(~c)) * prime;
+        };
+
+        for (const auto& part : parts)
+        {
+                for (unsigned char c : part)
+                {
+                        process(c);
+                }
+                // Separate parts so {"ab", "c"} and {"a", "bc"} differ.
+                process(0);
+                length += part.size() + 1;
+        }
+        h1 ^= length;
+
+        std::ostringstream os;
+        os << std::hex << std::setfill('0') << std::setw(16) << h0
+           << std::setw(16) << h1;
+        return os.str();
+}
+
+} // namespace detail
+} // namespace aura
+} // namespace boost
@@ -20,6 +20,15 @@ struct alang_header
 #define AURA_KERNEL extern "C" __global__
 #define AURA_CONSTANT
 #define AURA_DEVMEM
+#define AURA_SHARED __shared__
+#define AURA_SYNC __syncthreads()
+#define AURA_VALUE(type) type
+#define AURA_DEVICE_FUNCTION __device__ inline
+
+typedef unsigned char uchar;
+typedef unsigned short ushort;
+typedef unsigned int uint;
+typedef unsigned long long ulong;
 
 #define AURA_MESH_ID_ARG
 #define AURA_MESH_ID_0 (blockIdx.x * blockDim.x + threadIdx.x)
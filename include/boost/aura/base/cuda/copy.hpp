@@ -1,6 +1,7 @@
 #pragma once
 
 #include <boost/aura/base/cuda/device_ptr.hpp>
+#include <boost/aura/base/cuda/event.hpp>
 #include <boost/aura/base/cuda/feed.hpp>
 
 #include <cuda.h>
@@ -57,6 +58,34 @@ void copy(const device_ptr<T> first, const device_ptr<T> last,
         f.get_device().deactivate();
 }
 
+/// Copy host memory to device, returns event that completes with the copy.
+template <typename InputIt, typename T>
+event copy_async(InputIt first, InputIt last, device_ptr<T> dst_first,
+        feed& f)
+{
+        copy(first, last, dst_first, f);
+        return event(f);
+}
+
+/// Copy device memory to host, returns event that completes with the copy.
+template <typename T, typename OutputIt>
+event copy_async(const device_ptr<T> first, const device_ptr<T> last,
+        OutputIt dst_first, feed& f)
+{
+        copy(first, last, dst_first, f);
+        return event(f);
+}
+
+/// Copy device to device memory, returns event that completes with the
+/// copy.
+template <typename T>
+event copy_async(const device_ptr<T> first, const device_ptr<T> last,
+        device_ptr<T> dst_first, feed& f)
+{
+        copy(first, last, dst_first, f);
+        return event(f);
+}
+
 } // cuda
 } // base_detail
 } // aura
@@ -2,6 +2,8 @@
 
 #include <boost/aura/base/allocation_tracker.hpp>
 #include <boost/aura/base/check_initialized.hpp>
+#include <boost/aura/base/device_properties.hpp>
+#include <boost/aura/base/object_cache.hpp>
 #include <boost/aura/base/cuda/safecall.hpp>
 #include <boost/aura/platform.hpp>
 
@@ -43,6 +45,7 @@ public:
         {
                 AURA_CUDA_SAFE_CALL(cuDeviceGet(&device_, ordinal));
                 AURA_CUDA_SAFE_CALL(cuCtxCreate(&context_, 0, device_));
+                query_properties_();
                 initialized_ = true;
         }
 
@@ -56,7 +59,10 @@ public:
                 , ordinal_(other.ordinal_)
                 , device_(other.device_)
                 , context_(other.context_)
+                , properties_(std::move(other.properties_))
         {
+                // Cached objects refer to the other device object.
+                other.object_cache.clear();
                 other.initialized_ = false;
                 other.ordinal_ = -1;
         }
@@ -65,11 +71,13 @@ public:
         device& operator=(device&& other)
         {
                 reset();
+                other.object_cache.clear();
 
                 initialized_ = other.initialized_;
                 ordinal_ = other.ordinal_;
                 device_ = other.device_;
                 context_ = other.context_;
+                properties_ = std::move(other.properties_);
 
                 other.initialized_ = false;
                 other.ordinal_ = -1;
@@ -81,6 +89,7 @@ public:
         {
                 if (initialized_)
                 {
+                        object_cache.clear();
                         AURA_CUDA_SAFE_CALL(cuCtxDestroy(context_));
                         initialized_ = false;
                 }
@@ -128,16 +137,83 @@ public:
         /// Query initialized state.
         inline bool initialized() const { return initialized_; }
 
+        /// Access device properties.
+        inline const device_properties& get_properties() const
+        {
+                AURA_CHECK_INITIALIZED(initialized_);
+                return properties_;
+        }
+
         /// Shared memory.
         bool supports_shared_memory() const
         {
-                return platform::supports_shared_memory;
+                return properties_.supports_shared_memory;
+        }
+
+        /// Query if mapping device memory is zero-copy.
+        bool supports_zero_copy_map() const
+        {
+                return properties_.supports_shared_memory;
         }
 
         /// Allocation tracker.
         boost::aura::detail::allocation_tracker allocation_tracker;
 
+        /// Objects that live as long as the device (built-in kernels).
+        boost::aura::detail::object_cache object_cache;
+
 private:
+        /// Query device attribute.
+        std::size_t get_attribute_(CUdevice_attribute attribute) const
+        {
+                int value = 0;
+                AURA_CUDA_SAFE_CALL(
+                        cuDeviceGetAttribute(&value, attribute, device_));
+                return value;
+        }
+
+        /// Query device properties.
+        void query_properties_()
+        {
+                auto& p = properties_;
+                char name[256];
+                AURA_CUDA_SAFE_CALL(
+                        cuDeviceGetName(name, sizeof(name), device_));
+                p.name = name;
+                p.vendor = "NVIDIA";
+                p.unified_memory =
+                        get_attribute_(CU_DEVICE_ATTRIBUTE_INTEGRATED) != 0;
+                // Memory from cuMemAlloc has no host address, not even on
+                // integrated devices.
+                p.supports_shared_memory = false;
+                p.compute_units = get_attribute_(
+                        CU_DEVICE_ATTRIBUTE_MULTIPROCESSOR_COUNT);
+                p.max_bundle_size = get_attribute_(
+                        CU_DEVICE_ATTRIBUTE_MAX_THREADS_PER_BLOCK);
+                p.max_bundle_extent = {{
+                        get_attribute_(CU_DEVICE_ATTRIBUTE_MAX_BLOCK_DIM_X),
+                        get_attribute_(CU_DEVICE_ATTRIBUTE_MAX_BLOCK_DIM_Y),
+                        get_attribute_(CU_DEVICE_ATTRIBUTE_MAX_BLOCK_DIM_Z)}};
+                p.simd_width = get_attribute_(CU_DEVICE_ATTRIBUTE_WARP_SIZE);
+                p.local_memory_size = get_attribute_(
+                        CU_DEVICE_ATTRIBUTE_MAX_SHARED_MEMORY_PER_BLOCK);
+                std::size_t total = 0;
+                AURA_CUDA_SAFE_CALL(cuDeviceTotalMem(&total, device_));
+                p.global_memory_size = total;
+                // The driver does not expose cache line size and allocation
+                // alignment, both are fixed: L1 lines are 128 bytes on all
+                // architectures, cuMemAlloc aligns to at least 256 bytes.
+                p.cache_line_size = 128;
+                p.memory_alignment = 256;
+                // Threads are scalar.
+                p.preferred_vector_width_char = 1;
+                p.preferred_vector_width_short = 1;
+                p.preferred_vector_width_int = 1;
+                p.preferred_vector_width_long = 1;
+                p.preferred_vector_width_float = 1;
+                p.preferred_vector_width_double = 1;
+        }
+
         /// Initialized flag
         bool initialized_;
 
@@ -149,6 +225,9 @@ private:
 
         /// Context handle
         CUcontext context_;
+
+        /// Device properties
+        device_properties properties_;
 };
 
 } // namespace cuda
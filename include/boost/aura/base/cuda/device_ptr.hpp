@@ -7,7 +7,10 @@
 
 #include <cuda.h>
 
+#include <boost/core/ignore_unused.hpp>
+
 #include <cstddef>
+#include <string>
 
 namespace boost
 {
@@ -99,10 +102,57 @@ void device_free(device_ptr<T>& ptr)
         ptr.reset();
 }
 
-/// Set device memory (bytes).
+/// Alignment (bytes) of device memory regions that alias an allocation.
+inline std::size_t device_region_alignment(device& d)
+{
+        return d.get_properties().memory_alignment;
+}
+
+/// Create region of an allocation (the region is not tracked).
+template <typename T>
+device_ptr<T> device_region(
+        device_ptr<T>& ptr, std::size_t offset_bytes, std::size_t size_bytes)
+{
+        boost::ignore_unused(size_bytes);
+        typename device_ptr<T>::base_type m;
+        m.device_buffer = ptr.get_base_ptr().device_buffer + offset_bytes;
+        return device_ptr<T>(m, ptr.get_device(),
+                ptr.get_memory_access_tag(), ptr.is_shared_memory());
+}
+
+/// Free region of an allocation.
+template <typename T>
+void device_region_free(device_ptr<T>& ptr)
+{
+        ptr.reset();
+}
+
+/// Map device memory to host.
+/// Returns nullptr, device memory can not be mapped.
+template <typename T>
+T* device_map(const device_ptr<T>& ptr, std::size_t num,
+        memory_access_tag tag, feed& f)
+{
+        boost::ignore_unused(ptr, num, tag, f);
+        return nullptr;
+}
+
+/// Unmap device memory mapped with device_map.
+template <typename T>
+void device_unmap(const device_ptr<T>& ptr, T* host_ptr, feed& f)
+{
+        boost::ignore_unused(ptr, host_ptr, f);
+}
+
+/// Set device memory (bytes), not supported while f is capturing.
 template <typename T>
 void device_memset(device_ptr<T>& ptr, char value, std::size_t num, feed& f)
 {
+        if (f.get_capture() != nullptr)
+        {
+                throw std::string("can not set memory while feed is "
+                                  "capturing");
+        }
         ptr.get_device().activate();
         AURA_CUDA_SAFE_CALL(
                         cuMemsetD8(
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <boost/aura/base/cuda/feed.hpp>
+#include <boost/aura/base/cuda/safecall.hpp>
+
+#include <cuda.h>
+
+#include <functional>
+#include <memory>
+
+namespace boost
+{
+namespace aura
+{
+namespace base_detail
+{
+namespace cuda
+{
+
+namespace detail
+{
+
+/// Called by the driver once an event has completed.
+inline void CUDA_CB event_notify(void* user_data)
+{
+        std::unique_ptr<std::function<void()>> callback(
+                reinterpret_cast<std::function<void()>*>(user_data));
+        try
+        {
+                (*callback)();
+        }
+        catch (...)
+        {
+                // Exceptions must not propagate into the driver.
+        }
+}
+
+} // namespace detail
+
+/// Marker in a feed, completes once all prior commands in the feed are done.
+class event
+{
+public:
+        /// Create empty event.
+        inline explicit event()
+                : device_(nullptr)
+                , stream_(nullptr)
+        {
+        }
+
+        /// Record event in feed.
+        inline explicit event(feed& f)
+                : device_(&f.get_device())
+                , stream_(f.get_base_feed())
+        {
+                device_->activate();
+                AURA_CUDA_SAFE_CALL(
+                        cuEventCreate(&event_, CU_EVENT_DISABLE_TIMING));
+                AURA_CUDA_SAFE_CALL(cuEventRecord(event_, f.get_base_feed()));
+                device_->deactivate();
+        }
+
+        /// Prevent copies.
+        event(const event&) = delete;
+        void operator=(const event&) = delete;
+
+        /// Move construct.
+        event(event&& other)
+                : device_(other.device_)
+                , stream_(other.stream_)
+                , event_(other.event_)
+        {
+                other.device_ = nullptr;
+        }
+
+        /// Move assign.
+        event& operator=(event&& other)
+        {
+                finalize();
+                device_ = other.device_;
+                stream_ = other.stream_;
+                event_ = other.event_;
+                other.device_ = nullptr;
+                return *this;
+        }
+
+        /// Destroy event.
+        inline ~event() { finalize(); }
+
+        /// Query if all commands before the event have finished.
+        bool query() const
+        {
+                if (nullptr == device_)
+                {
+                        return true;
+                }
+                device_->activate();
+                auto result = cuEventQuery(event_);
+                device_->deactivate();
+                if (result == CUDA_ERROR_NOT_READY)
+                {
+                        return false;
+                }
+                AURA_CUDA_SAFE_CALL(result);
+                return true;
+        }
+
+        /// Wait until all commands before the event have finished.
+        void synchronize() const
+        {
+                if (nullptr != device_)
+                {
+                        device_->activate();
+                        AURA_CUDA_SAFE_CALL(cuEventSynchronize(event_));
+                        device_->deactivate();
+                }
+        }
+
+        /// Call callback once the event has completed.
+        /// The callback is enqueued to the feed the event was recorded in,
+        /// so it also waits for commands enqueued there before then() is
+        /// called, and later commands wait for it. It runs on a driver
+        /// thread and must not call into CUDA. The feed must still exist.
+        void then(std::function<void()> callback) const
+        {
+                if (nullptr == device_)
+                {
+                        callback();
+                        return;
+                }
+                device_->activate();
+                auto user_data = new std::function<void()>(std::move(callback));
+                auto result = cuLaunchHostFunc(
+                        stream_, detail::event_notify, user_data);
+                if (result != CUDA_SUCCESS)
+                {
+                        delete user_data;
+                }
+                device_->deactivate();
+                AURA_CUDA_SAFE_CALL(result);
+        }
+
+        /// Access base event.
+        CUevent get_base_event() const { return event_; }
+
+private:
+        /// Finalize object.
+        void finalize()
+        {
+                if (nullptr != device_)
+                {
+                        device_->activate();
+                        AURA_CUDA_SAFE_CALL(cuEventDestroy(event_));
+                        device_->deactivate();
+                        device_ = nullptr;
+                }
+        }
+
+        /// Device the event was recorded on.
+        device* device_;
+
+        /// Stream the event was recorded in.
+        CUstream stream_;
+
+        /// Event handle.
+        CUevent event_;
+
+        friend class feed;
+};
+
+inline event feed::record() { return event(*this); }
+
+inline void feed::wait(const event& e)
+{
+        if (nullptr == e.device_)
+        {
+                return;
+        }
+        device_->activate();
+        AURA_CUDA_SAFE_CALL(cuStreamWaitEvent(feed_, e.event_, 0));
+        device_->deactivate();
+}
+
+} // cuda
+} // base_detail
+} // aura
+} // boost
@@ -2,9 +2,12 @@
 
 #include <boost/aura/base/cuda/device.hpp>
 #include <boost/aura/base/cuda/safecall.hpp>
+#include <boost/aura/base/feed_order.hpp>
 
 #include <cuda.h>
 
+#include <boost/core/ignore_unused.hpp>
+
 namespace boost
 {
 namespace aura
@@ -15,12 +18,16 @@ namespace cuda
 {
 
 
+class event;
+class graph;
+
 class feed
 {
 public:
         /// create empty feed object without device and stream
         inline explicit feed()
                 : device_(nullptr)
+                , capture_(nullptr)
         {
         }
 
@@ -28,10 +35,14 @@ public:
          * Create device feed for device.
          *
          * @param d device to create feed for
+         * @param order ignored, streams execute commands in order
          */
-        inline explicit feed(device& d)
+        inline explicit feed(
+                device& d, feed_order order = feed_order::in_order)
                 : device_(&d)
+                , capture_(nullptr)
         {
+                boost::ignore_unused(order);
                 device_->activate();
                 AURA_CUDA_SAFE_CALL(
                         cuStreamCreate(&feed_, 0 /*CU_STREAM_NON_BLOCKING*/));
@@ -46,8 +57,10 @@ public:
         feed(feed&& f)
                 : device_(f.device_)
                 , feed_(f.feed_)
+                , capture_(f.capture_)
         {
                 f.device_ = nullptr;
+                f.capture_ = nullptr;
         }
 
         /**
@@ -60,7 +73,9 @@ public:
                 finalize();
                 device_ = f.device_;
                 feed_ = f.feed_;
+                capture_ = f.capture_;
                 f.device_ = nullptr;
+                f.capture_ = nullptr;
                 return *this;
         }
 
@@ -75,6 +90,24 @@ public:
                 device_->deactivate();
         }
 
+        /// @copydoc boost::aura::base::opencl::feed::record()
+        inline event record();
+
+        /// @copydoc boost::aura::base::opencl::feed::wait()
+        inline void wait(const event& e);
+
+        /// Capture commands in graph instead of executing them, until
+        /// end_capture() is called.
+        /// @note Defined in graph.hpp.
+        inline void begin_capture(graph& g);
+
+        /// Stop capturing and instantiate the graph.
+        /// @note Defined in graph.hpp.
+        inline void end_capture();
+
+        /// @copydoc boost::aura::base::opencl::feed::get_capture()
+        graph* get_capture() const { return capture_; }
+
         /// @copydoc boost::aura::base::cuda::device::get_base_device()
         inline const CUdevice get_base_device() const
         {
@@ -115,6 +148,9 @@ private:
 
         /// Stream handle
         CUstream feed_;
+
+        /// Graph commands are captured in.
+        graph* capture_;
 };
 
 /**
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <boost/aura/base/cuda/device.hpp>
+#include <boost/aura/base/cuda/feed.hpp>
+#include <boost/aura/base/cuda/safecall.hpp>
+
+#include <cuda.h>
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+namespace boost
+{
+namespace aura
+{
+namespace base_detail
+{
+namespace cuda
+{
+
+/// Sequence of copies and kernel launches captured from a feed.
+///
+/// Commands are captured into a CUDA graph that is instantiated when the
+/// capture ends and launched with a single call. Host memory used by
+/// captured copies must stay valid.
+class graph
+{
+public:
+        /// Create empty graph.
+        inline explicit graph()
+                : device_(nullptr)
+                , graph_(nullptr)
+                , exec_(nullptr)
+        {
+        }
+
+        /// Prevent copies.
+        graph(const graph&) = delete;
+        void operator=(const graph&) = delete;
+
+        /// Move construct.
+        graph(graph&& other)
+                : device_(other.device_)
+                , graph_(other.graph_)
+                , exec_(other.exec_)
+                , kernel_nodes_(std::move(other.kernel_nodes_))
+        {
+                other.device_ = nullptr;
+                other.graph_ = nullptr;
+                other.exec_ = nullptr;
+        }
+
+        /// Move assign.
+        graph& operator=(graph&& other)
+        {
+                reset();
+                device_ = other.device_;
+                graph_ = other.graph_;
+                exec_ = other.exec_;
+                kernel_nodes_ = std::move(other.kernel_nodes_);
+                other.device_ = nullptr;
+                other.graph_ = nullptr;
+                other.exec_ = nullptr;
+                return *this;
+        }
+
+        /// Destroy graph.
+        inline ~graph() { reset(); }
+
+        /// Release graph.
+        void reset()
+        {
+                if (nullptr != device_)
+                {
+                        device_->activate();
+                        if (nullptr != exec_)
+                        {
+                                AURA_CUDA_SAFE_CALL(cuGraphExecDestroy(exec_));
+                        }
+                        if (nullptr != graph_)
+                        {
+                                AURA_CUDA_SAFE_CALL(cuGraphDestroy(graph_));
+                        }
+                        device_->deactivate();
+                }
+                device_ = nullptr;
+                graph_ = nullptr;
+                exec_ = nullptr;
+                kernel_nodes_.clear();
+        }
+
+        /// @copydoc boost::aura::base::opencl::graph::launch()
+        void launch(feed& f)
+        {
+                f.get_device().activate();
+                AURA_CUDA_SAFE_CALL(cuGraphLaunch(exec_, f.get_base_feed()));
+                f.get_device().deactivate();
+        }
+
+        /// @copydoc boost::aura::base::opencl::graph::set_arg()
+        template <typename T>
+        void set_arg(std::size_t kernel_node, std::size_t index, const T& value)
+        {
+                auto& n = kernel_nodes_.at(kernel_node);
+                auto& v = n.values.at(index);
+                v.resize(sizeof(T));
+                std::memcpy(&v[0], &value, sizeof(T));
+
+                device_->activate();
+                CUDA_KERNEL_NODE_PARAMS params;
+                AURA_CUDA_SAFE_CALL(
+                        cuGraphKernelNodeGetParams(n.node, &params));
+                // Captured arguments are kept by the graph, replaced ones
+                // are kept by the node.
+                std::vector<void*> args(params.kernelParams,
+                        params.kernelParams + n.values.size());
+                for (std::size_t i = 0; i < n.values.size(); i++)
+                {
+                        if (!n.values[i].empty())
+                        {
+                                args[i] = &n.values[i][0];
+                        }
+                }
+                params.kernelParams = args.empty() ? NULL : &args[0];
+                AURA_CUDA_SAFE_CALL(
+                        cuGraphExecKernelNodeSetParams(exec_, n.node, &params));
+                device_->deactivate();
+        }
+
+        /// Number of commands.
+        std::size_t size() const
+        {
+                if (nullptr == graph_)
+                {
+                        return 0;
+                }
+                std::size_t count = 0;
+                AURA_CUDA_SAFE_CALL(cuGraphGetNodes(graph_, NULL, &count));
+                return count;
+        }
+
+        /// Number of kernel launches.
+        std::size_t num_kernel_nodes() const { return kernel_nodes_.size(); }
+
+        /// Add kernel launch to the graph feed is capturing in, after the
+        /// commands captured so far (instead of launching it in feed).
+        void add_kernel_node(feed& f, const CUDA_KERNEL_NODE_PARAMS& params,
+                std::size_t num_args)
+        {
+                CUstreamCaptureStatus status;
+                CUgraph g;
+                const CUgraphNode* dependencies;
+                std::size_t num_dependencies;
+                AURA_CUDA_SAFE_CALL(cuStreamGetCaptureInfo_v2(f.get_base_feed(),
+                        &status, NULL, &g, &dependencies,
+                        &num_dependencies));
+                kernel_node_t n;
+                AURA_CUDA_SAFE_CALL(cuGraphAddKernelNode(&n.node, g,
+                        dependencies, num_dependencies, &params));
+                // Commands captured later depend on the launch.
+                AURA_CUDA_SAFE_CALL(cuStreamUpdateCaptureDependencies(
+                        f.get_base_feed(), &n.node, 1,
+                        CU_STREAM_SET_CAPTURE_DEPENDENCIES));
+                n.values.resize(num_args);
+                kernel_nodes_.push_back(std::move(n));
+        }
+
+private:
+        /// Captured kernel launch.
+        struct kernel_node_t
+        {
+                /// Node in graph.
+                CUgraphNode node;
+
+                /// Replaced argument values (empty if not replaced).
+                std::vector<std::vector<char>> values;
+        };
+
+        /// Instantiate captured graph.
+        void instantiate_(device& d, CUgraph g)
+        {
+                device_ = &d;
+                graph_ = g;
+                AURA_CUDA_SAFE_CALL(cuGraphInstantiateWithFlags(&exec_, g, 0));
+        }
+
+        /// Device the graph was captured on.
+        device* device_;
+
+        /// Captured graph.
+        CUgraph graph_;
+
+        /// Executable graph.
+        CUgraphExec exec_;
+
+        /// Kernel launches in capture order.
+        std::vector<kernel_node_t> kernel_nodes_;
+
+        friend class feed;
+};
+
+inline void feed::begin_capture(graph& g)
+{
+        g.reset();
+        device_->activate();
+        AURA_CUDA_SAFE_CALL(cuStreamBeginCapture(
+                feed_, CU_STREAM_CAPTURE_MODE_THREAD_LOCAL));
+        device_->deactivate();
+        capture_ = &g;
+}
+
+inline void feed::end_capture()
+{
+        if (nullptr == capture_)
+        {
+                return;
+        }
+        device_->activate();
+        CUgraph g;
+        AURA_CUDA_SAFE_CALL(cuStreamEndCapture(feed_, &g));
+        capture_->instantiate_(*device_, g);
+        device_->deactivate();
+        capture_ = nullptr;
+}
+
+} // cuda
+} // base_detail
+} // aura
+} // boost
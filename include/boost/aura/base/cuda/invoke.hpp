@@ -2,12 +2,17 @@
 
 #include <boost/aura/base/base_mesh_bundle.hpp>
 #include <boost/aura/base/cuda/feed.hpp>
+#include <boost/aura/base/cuda/graph.hpp>
 #include <boost/aura/base/cuda/kernel.hpp>
 #include <boost/aura/base/cuda/safecall.hpp>
-#include <boost/aura/meta/tsizeof.hpp>
 
 #include <cuda.h>
 
+#include <array>
+#include <cstring>
+#include <tuple>
+#include <vector>
+
 namespace boost
 {
 namespace aura
@@ -21,44 +26,86 @@ typedef void* arg_t;
 template <std::size_t N>
 using args_tt = std::array<arg_t, N>;
 
-// Alias for returned packed arguments
-template <std::size_t N>
-using args_t = std::pair<char*, args_tt<N>>;
+/// Packed arguments, stored inline with the alignment of each type.
+template <typename... Targs>
+struct args_t
+{
+        std::tuple<Targs...> values;
+};
 
-/// Copy arguments to memory block recursively
-template <typename ArgsItr, typename T0>
-void fill_args_(char* p, ArgsItr it, const T0 a0)
+/// Fill argument table recursively
+template <std::size_t I, std::size_t N>
+struct fill_args_
 {
-        std::memcpy(p, &a0, sizeof(T0));
-        *it = p;
-}
+        template <typename Tuple>
+        static void apply(const Tuple& t, arg_t* table)
+        {
+                table[I] = const_cast<void*>(
+                        static_cast<const void*>(&std::get<I>(t)));
+                fill_args_<I + 1, N>::apply(t, table);
+        }
+};
 
-template <typename ArgsItr, typename T0, typename... Targs>
-void fill_args_(char* p, ArgsItr it, const T0 a0, const Targs... ar)
+template <std::size_t N>
+struct fill_args_<N, N>
 {
-        std::memcpy(p, &a0, sizeof(T0));
-        *it = p;
-        fill_args_(p + sizeof(T0), ++it, ar...);
-}
+        template <typename Tuple>
+        static void apply(const Tuple&, arg_t*)
+        {
+        }
+};
 
 /// Pack arguments
 template <typename... Targs>
-args_t<sizeof...(Targs)> args_impl(const Targs... ar)
+args_t<Targs...> args_impl(const Targs... ar)
+{
+        return args_t<Targs...>{std::make_tuple(ar...)};
+}
+
+/// Table of pointers to packed arguments (valid while a is alive)
+template <typename... Targs>
+args_tt<sizeof...(Targs)> arg_table(const args_t<Targs...>& a)
 {
-        args_tt<sizeof...(Targs)> pa;
-        char* p = (char*)malloc(tsizeof<Targs...>::sz);
-        char* ptr = p;
-        fill_args_(p, pa.begin(), ar...);
-        return std::make_pair(ptr, pa);
+        args_tt<sizeof...(Targs)> table;
+        fill_args_<0, sizeof...(Targs)>::apply(a.values, table.data());
+        return table;
 }
 
 namespace detail
 {
 
-template <unsigned long N, typename MeshType, typename BundleType>
+/// Launch kernel in feed, or add the launch to the graph feed is capturing
+/// in.
+template <typename MeshBundle>
+inline void launch_kernel(CUfunction k, const MeshBundle& mesh_bundle,
+        void** args, std::size_t num_args, feed& f)
+{
+        if (f.get_capture() != nullptr)
+        {
+                CUDA_KERNEL_NODE_PARAMS params;
+                std::memset(&params, 0, sizeof(params));
+                params.func = k;
+                params.gridDimX = mesh_bundle.first[0];
+                params.gridDimY = mesh_bundle.first[1];
+                params.gridDimZ = mesh_bundle.first[2];
+                params.blockDimX = mesh_bundle.second[0];
+                params.blockDimY = mesh_bundle.second[1];
+                params.blockDimZ = mesh_bundle.second[2];
+                params.kernelParams = args;
+                f.get_capture()->add_kernel_node(f, params, num_args);
+                return;
+        }
+        AURA_CUDA_SAFE_CALL(cuLaunchKernel(k, mesh_bundle.first[0],
+                mesh_bundle.first[1], mesh_bundle.first[2],
+                mesh_bundle.second[0], mesh_bundle.second[1],
+                mesh_bundle.second[2], 0, f.get_base_feed(), args, NULL));
+}
+
+template <typename MeshType, typename BundleType, typename... Targs>
 inline void invoke_impl(kernel& k, const MeshType& m, const BundleType& b,
-        const args_t<N>&& a, feed& f)
+        const args_t<Targs...>&& a, feed& f)
 {
+        auto table = arg_table(a);
         auto mesh_bundle = adjust_mesh_bundle(m, b);
         f.get_device().activate();
 
@@ -70,16 +117,29 @@ inline void invoke_impl(kernel& k, const MeshType& m, const BundleType& b,
 #endif
 
 
-        AURA_CUDA_SAFE_CALL(cuLaunchKernel(k.get_base_kernel(),
-                mesh_bundle.first[0], mesh_bundle.first[1],
-                mesh_bundle.first[2], mesh_bundle.second[0],
-                mesh_bundle.second[1], mesh_bundle.second[2], 0,
-                f.get_base_feed(), const_cast<void**>(&a.second[0]), NULL));
+        launch_kernel(k.get_base_kernel(), mesh_bundle,
+                table.empty() ? NULL : table.data(), table.size(), f);
         f.get_device().deactivate();
-        free(a.first);
 }
 
 
+/// @copydoc boost::aura::base::opencl::detail::invoke_many_impl()
+template <typename MeshType, typename BundleType, typename... Targs>
+inline void invoke_many_impl(kernel& k, const MeshType& m,
+        const BundleType& b, const std::vector<args_t<Targs...>>& packs,
+        feed& f)
+{
+        auto mesh_bundle = adjust_mesh_bundle(m, b);
+        f.get_device().activate();
+        for (const auto& a : packs)
+        {
+                auto table = arg_table(a);
+                launch_kernel(k.get_base_kernel(), mesh_bundle,
+                        table.empty() ? NULL : table.data(), table.size(), f);
+        }
+        f.get_device().deactivate();
+}
+
 } // namespace detail
 
 } // cuda
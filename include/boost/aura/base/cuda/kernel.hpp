@@ -1,10 +1,17 @@
 #pragma once
 
+#include <boost/aura/base/bundle_limits.hpp>
+#include <boost/aura/base/kernel_signature.hpp>
 #include <boost/aura/base/cuda/library.hpp>
 #include <boost/aura/base/cuda/safecall.hpp>
 
 #include <cuda.h>
 
+#include <memory>
+#include <vector>
+
+#include <boost/core/ignore_unused.hpp>
+
 namespace boost
 {
 namespace aura
@@ -22,6 +29,8 @@ public:
 
         /// Create kernel from library.
         inline explicit kernel(const std::string& name, library& l)
+                : name_(name)
+                , library_hash_(l.get_hash())
         {
                 l.get_device().activate();
                 AURA_CUDA_SAFE_CALL(cuModuleGetFunction(
@@ -30,6 +39,15 @@ public:
                 initialized_ = true;
         }
 
+        /// Create kernel from shared library, the kernel keeps the library
+        /// alive.
+        inline explicit kernel(
+                const std::string& name, std::shared_ptr<library> l)
+                : kernel(name, *l)
+        {
+                library_ = std::move(l);
+        }
+
         /// Prevent copies.
         kernel(const kernel&) = delete;
         void operator=(const kernel&) = delete;
@@ -39,6 +57,9 @@ public:
         kernel(kernel&& other)
                 : initialized_(other.initialized_)
                 , kernel_(other.kernel_)
+                , name_(std::move(other.name_))
+                , library_hash_(std::move(other.library_hash_))
+                , library_(std::move(other.library_))
         {
                 other.initialized_ = false;
         }
@@ -50,6 +71,9 @@ public:
 
                 initialized_ = other.initialized_;
                 kernel_ = other.kernel_;
+                name_ = std::move(other.name_);
+                library_hash_ = std::move(other.library_hash_);
+                library_ = std::move(other.library_);
 
                 other.initialized_ = false;
                 return *this;
@@ -63,6 +87,7 @@ public:
                         kernel_ = nullptr;
                         initialized_ = false;
                 }
+                library_.reset();
         }
 
         /// Destroy kernel.
@@ -71,14 +96,54 @@ public:
         /// Access kernel (base).
         CUfunction get_base_kernel() { return kernel_; }
 
+        /// Access kernel name.
+        const std::string& get_name() const { return name_; }
+
+        /// Content hash of the library the kernel was created from.
+        const std::string& get_library_hash() const
+        {
+                return library_hash_;
+        }
+
 private:
         /// Initialized flag
         bool initialized_{false};
 
         /// Kernel handle.
         CUfunction kernel_;
+
+        /// Kernel name.
+        std::string name_;
+
+        /// Content hash of the library the kernel was created from.
+        std::string library_hash_;
+
+        /// Library kept alive by this kernel (if created from a shared one).
+        std::shared_ptr<library> library_;
 };
 
+/// @copydoc boost::aura::base::opencl::get_bundle_limits()
+inline bundle_limits get_bundle_limits(kernel& k, device& d)
+{
+        bundle_limits l;
+        int max_size;
+        AURA_CUDA_SAFE_CALL(cuFuncGetAttribute(&max_size,
+                CU_FUNC_ATTRIBUTE_MAX_THREADS_PER_BLOCK, k.get_base_kernel()));
+        l.max_size = max_size;
+        l.max_extent = d.get_properties().max_bundle_extent;
+        l.preferred_multiple = d.get_properties().simd_width;
+        l.device_name = d.get_properties().name;
+        return l;
+}
+
+/// Check that kernel parameters match params.
+/// The CUDA base has no parameter info, nothing is checked.
+inline void check_signature(
+        kernel& k, const std::vector<kernel_param>& params)
+{
+        boost::ignore_unused(k, params);
+}
+
 } // namespace cuda
 } // namespace base_detail
 } // namespace aura
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <boost/aura/base/base_mesh_bundle.hpp>
+#include <boost/aura/base/cuda/feed.hpp>
+#include <boost/aura/base/cuda/graph.hpp>
+#include <boost/aura/base/cuda/invoke.hpp>
+#include <boost/aura/base/cuda/kernel.hpp>
+#include <boost/aura/base/cuda/safecall.hpp>
+
+#include <cuda.h>
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+namespace boost
+{
+namespace aura
+{
+namespace base_detail
+{
+namespace cuda
+{
+
+/// @copydoc boost::aura::base_detail::opencl::launch_plan
+template <typename... Targs>
+class launch_plan
+{
+public:
+        /// Prepare launch.
+        launch_plan(kernel& k, const mesh& m, const bundle& b,
+                args_t<Targs...>&& a)
+                : kernel_(k.get_base_kernel())
+                , args_(std::move(a))
+                , mesh_bundle_(adjust_mesh_bundle(m, b))
+        {
+        }
+
+        /// Replace argument I.
+        template <std::size_t I>
+        void set_arg(const typename std::tuple_element<I,
+                std::tuple<Targs...>>::type& value)
+        {
+                std::get<I>(args_.values) = value;
+        }
+
+        /// Enqueue launch to feed.
+        void enqueue(feed& f)
+        {
+                auto table = arg_table(args_);
+                f.get_device().activate();
+                detail::launch_kernel(kernel_, mesh_bundle_,
+                        table.empty() ? NULL : table.data(), table.size(), f);
+                f.get_device().deactivate();
+        }
+
+private:
+        /// Kernel function.
+        CUfunction kernel_;
+
+        /// Current arguments.
+        args_t<Targs...> args_;
+
+        /// Adjusted mesh and bundle.
+        std::pair<mesh, bundle> mesh_bundle_;
+};
+
+} // cuda
+} // base_detail
+} // aura
+} // boost
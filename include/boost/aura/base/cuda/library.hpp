@@ -2,6 +2,8 @@
 
 #include <boost/aura/base/alang.hpp>
 #include <boost/aura/base/check_initialized.hpp>
+#include <boost/aura/base/content_hash.hpp>
+#include <boost/aura/base/deferred_build.hpp>
 #include <boost/aura/base/cuda/alang.hpp>
 #include <boost/aura/base/cuda/device.hpp>
 #include <boost/aura/base/cuda/safecall.hpp>
@@ -60,12 +62,29 @@ public:
                         kernelstring, d, options, inject_aura_preamble);
         }
 
+        /// Create library from string, CUDA builds synchronously.
+        inline explicit library(const std::string& kernelstring, device& d,
+                bool inject_aura_preamble, const std::string& options,
+                deferred_build_t)
+                : library(kernelstring, d, inject_aura_preamble, options)
+        {
+        }
+
+        /// Create library from file, CUDA builds synchronously.
+        inline explicit library(boost::aura::path p, device& d,
+                bool inject_aura_preamble, const std::string& options,
+                deferred_build_t)
+                : library(p, d, inject_aura_preamble, options)
+        {
+        }
+
         /// Move construct.
         library(library&& other)
                 : initialized_(other.initialized_)
                 , device_(other.device_)
                 , library_(other.library_)
                 , log_(other.log_)
+                , hash_(std::move(other.hash_))
         {
                 other.initialized_ = false;
                 other.device_ = nullptr;
@@ -82,6 +101,7 @@ public:
                 device_ = other.device_;
                 library_ = other.library_;
                 log_ = other.log_;
+                hash_ = std::move(other.hash_);
 
                 other.initialized_ = false;
                 other.device_ = nullptr;
@@ -97,6 +117,9 @@ public:
                 return *device_;
         }
 
+        /// Content hash of source (with preamble) and options.
+        const std::string& get_hash() const { return hash_; }
+
         /// Access library.
         CUmodule get_base_library()
         {
@@ -110,6 +133,12 @@ public:
                 return library_;
         }
 
+        /// Wait for build (libraries are always built on construction).
+        void wait() const { AURA_CHECK_INITIALIZED(initialized_); }
+
+        /// Query if the library is built.
+        bool ready() const { return true; }
+
         /// Destructor.
         ~library() { reset(); }
 
@@ -124,6 +153,7 @@ public:
                 device_ = nullptr;
                 library_ = nullptr;
                 log_ = "";
+                hash_ = "";
         }
 
 private:
@@ -144,6 +174,9 @@ private:
                                 salh.get() + std::string("\n") + alh.get() +
                                 std::string("\n") + kernelstring_with_preamble;
                 }
+                hash_ = boost::aura::detail::content_hash(
+                        {kernelstring_with_preamble, opt});
+
                 d.activate();
 
                 // Create and compile.
@@ -213,6 +246,9 @@ private:
 
         /// Library compile log
         std::string log_;
+
+        /// Content hash of source (with preamble) and options.
+        std::string hash_;
 };
 
 
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <boost/aura/base/cuda/device.hpp>
+#include <boost/aura/base/cuda/safecall.hpp>
+
+#include <cuda.h>
+
+#include <algorithm>
+#include <cstddef>
+
+namespace boost
+{
+namespace aura
+{
+namespace base_detail
+{
+namespace cuda
+{
+
+/// Pinned (page-locked) host memory.
+template <typename T>
+struct pinned_memory
+{
+        /// Host pointer.
+        T* host_ptr { nullptr };
+
+        /// Device the memory was allocated with.
+        device* device_ { nullptr };
+
+        /// Size in bytes.
+        std::size_t size_bytes { 0 };
+};
+
+/// Allocate pinned host memory.
+template <typename T>
+pinned_memory<T> pinned_malloc(std::size_t size, device& d)
+{
+        pinned_memory<T> m;
+        m.size_bytes = std::max<std::size_t>(size * sizeof(T), 1);
+        m.device_ = &d;
+        void* ptr = nullptr;
+        d.activate();
+        AURA_CUDA_SAFE_CALL(cuMemAllocHost(&ptr, m.size_bytes));
+        d.deactivate();
+        m.host_ptr = reinterpret_cast<T*>(ptr);
+        return m;
+}
+
+/// Free pinned host memory.
+template <typename T>
+void pinned_free(pinned_memory<T>& m)
+{
+        m.device_->activate();
+        AURA_CUDA_SAFE_CALL(cuMemFreeHost(m.host_ptr));
+        m.device_->deactivate();
+        m = pinned_memory<T>();
+}
+
+} // cuda
+} // base_detail
+} // aura
+} // boost
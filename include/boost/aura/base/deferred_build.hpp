@@ -0,0 +1,17 @@
+#pragma once
+
+namespace boost
+{
+namespace aura
+{
+
+/// Tag that selects library constructors that return before the build
+/// has finished (where the base supports it).
+struct deferred_build_t
+{
+};
+
+constexpr deferred_build_t deferred_build{};
+
+} // namespace aura
+} // namespace boost
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+namespace boost
+{
+namespace aura
+{
+
+/// Capabilities of a device, queried once when the device is created.
+/// Sizes are in bytes, values a backend can not query are 0 (or fixed
+/// values documented by the vendor, e.g. CUDA cache line size).
+struct device_properties
+{
+        /// Device name.
+        std::string name;
+
+        /// Device vendor.
+        std::string vendor;
+
+        /// Device is a CPU.
+        bool is_cpu{false};
+
+        /// Device and host share physical memory.
+        bool unified_memory{false};
+
+        /// Device memory can be accessed by the host directly
+        /// (see device::supports_shared_memory()).
+        bool supports_shared_memory{false};
+
+        /// Number of compute units (multiprocessors).
+        std::size_t compute_units{0};
+
+        /// Maximum number of threads in a bundle.
+        std::size_t max_bundle_size{0};
+
+        /// Maximum bundle extent in each dimension.
+        std::array<std::size_t, 3> max_bundle_extent{{0, 0, 0}};
+
+        /// Threads executed in lockstep (warp size).
+        std::size_t simd_width{0};
+
+        /// Local (shared) memory per bundle.
+        std::size_t local_memory_size{0};
+
+        /// Global memory.
+        std::size_t global_memory_size{0};
+
+        /// Global memory cache line.
+        std::size_t cache_line_size{0};
+
+        /// Alignment of device memory allocations.
+        std::size_t memory_alignment{0};
+
+        /// Preferred vector widths (elements) of the native types, 0 if
+        /// the type is not supported (e.g. double without fp64).
+        std::size_t preferred_vector_width_char{0};
+        std::size_t preferred_vector_width_short{0};
+        std::size_t preferred_vector_width_int{0};
+        std::size_t preferred_vector_width_long{0};
+        std::size_t preferred_vector_width_float{0};
+        std::size_t preferred_vector_width_double{0};
+};
+
+} // namespace aura
+} // namespace boost
@@ -0,0 +1,16 @@
+#pragma once
+
+namespace boost
+{
+namespace aura
+{
+
+/// Indicates if commands in a feed execute in order.
+enum class feed_order
+{
+        in_order,
+        out_of_order
+};
+
+} // namespace aura
+} // boost
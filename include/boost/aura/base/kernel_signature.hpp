@@ -0,0 +1,100 @@
+#pragma once
+
+#include <boost/aura/base/base_device_ptr.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace boost
+{
+namespace aura
+{
+
+/// Library option that keeps the argument info typed_kernel checks
+/// signatures against, e.g. library l(source, d, true, kernel_arg_info).
+/// Only OpenCL 1.2 devices provide argument info, other bases ignore it.
+const char* const kernel_arg_info = "-cl-kernel-arg-info";
+
+/// Description of a kernel parameter as seen by the host.
+struct kernel_param
+{
+        /// Parameter is device memory.
+        bool is_memory;
+
+        /// Size of the argument in bytes.
+        std::size_t size;
+
+        /// Device type name (element type for memory), empty if unknown.
+        std::string type_name;
+};
+
+namespace detail
+{
+
+/// Device type name of host type, empty if it has no fixed equivalent.
+template <typename T>
+struct device_type_name
+{
+        static std::string get() { return ""; }
+};
+
+#define AURA_DEVICE_TYPE_NAME(type, name)                                   \
+        template <>                                                         \
+        struct device_type_name<type>                                       \
+        {                                                                   \
+                static std::string get() { return name; }                   \
+        };                                                                  \
+/**/
+
+AURA_DEVICE_TYPE_NAME(float, "float")
+AURA_DEVICE_TYPE_NAME(double, "double")
+AURA_DEVICE_TYPE_NAME(std::int8_t, "char")
+AURA_DEVICE_TYPE_NAME(std::uint8_t, "uchar")
+AURA_DEVICE_TYPE_NAME(std::int16_t, "short")
+AURA_DEVICE_TYPE_NAME(std::uint16_t, "ushort")
+AURA_DEVICE_TYPE_NAME(std::int32_t, "int")
+AURA_DEVICE_TYPE_NAME(std::uint32_t, "uint")
+AURA_DEVICE_TYPE_NAME(std::int64_t, "long")
+AURA_DEVICE_TYPE_NAME(std::uint64_t, "ulong")
+
+#undef AURA_DEVICE_TYPE_NAME
+
+/// Argument a host parameter is passed to the kernel as.
+template <typename T>
+struct kernel_arg
+{
+        typedef T type;
+        static const T& convert(const T& v) { return v; }
+        static kernel_param describe()
+        {
+                return kernel_param{
+                        false, sizeof(T), device_type_name<T>::get()};
+        }
+};
+
+/// Device pointers are passed as their base pointer.
+template <typename T, typename BaseType>
+struct kernel_arg<base_device_ptr<T, BaseType>>
+{
+        typedef BaseType type;
+        static BaseType convert(const base_device_ptr<T, BaseType>& p)
+        {
+                return p.get_base_ptr();
+        }
+        static kernel_param describe()
+        {
+                return kernel_param{
+                        true, sizeof(BaseType), device_type_name<T>::get()};
+        }
+};
+
+/// List of types, to compare parameter packs.
+template <typename... Ts>
+struct type_list
+{
+};
+
+} // namespace detail
+} // namespace aura
+} // namespace boost
@@ -26,6 +26,10 @@ using namespace metal;
 #define AURA_KERNEL kernel
 #define AURA_CONSTANT __constant
 #define AURA_DEVMEM device
+#define AURA_SHARED threadgroup
+#define AURA_SYNC threadgroup_barrier(mem_flags::mem_threadgroup)
+#define AURA_VALUE(type) constant type&
+#define AURA_DEVICE_FUNCTION inline
 
 #define AURA_MESH_ID_ARG , uint3 aura_mesh_id[[thread_position_in_grid]]
 #define AURA_MESH_ID_0 aura_mesh_id.x
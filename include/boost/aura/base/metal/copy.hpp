@@ -1,7 +1,9 @@
 #pragma once
 
 #include <boost/aura/base/metal/device_ptr.hpp>
+#include <boost/aura/base/metal/event.hpp>
 #include <boost/aura/base/metal/feed.hpp>
+#include <boost/aura/base/metal/graph.hpp>
 
 #include <iterator>
 
@@ -29,6 +31,14 @@ T* unwrap(device_ptr<T> ptr)
 template <typename InputIt, typename T>
 void copy(InputIt first, InputIt last, device_ptr<T> dst_first, feed& f)
 {
+        if (f.get_capture() != nullptr)
+        {
+                f.get_capture()->add_node([=](feed& f2)
+                        {
+                                copy(first, last, dst_first, f2);
+                        });
+                return;
+        }
         wait_for(f);
         std::copy(first, last, detail::unwrap(dst_first));
 }
@@ -39,6 +49,14 @@ template <typename T, typename OutputIt>
 void copy(const device_ptr<T> first, const device_ptr<T> last,
         OutputIt dst_first, feed& f)
 {
+        if (f.get_capture() != nullptr)
+        {
+                f.get_capture()->add_node([=](feed& f2)
+                        {
+                                copy(first, last, dst_first, f2);
+                        });
+                return;
+        }
         wait_for(f);
         std::copy(detail::unwrap(first), detail::unwrap(last), dst_first);
 }
@@ -48,11 +66,49 @@ template <typename T>
 void copy(const device_ptr<T> first, const device_ptr<T> last,
         device_ptr<T> dst_first, feed& f)
 {
+        if (f.get_capture() != nullptr)
+        {
+                f.get_capture()->add_node([=](feed& f2)
+                        {
+                                copy(first, last, dst_first, f2);
+                        });
+                return;
+        }
         wait_for(f);
         std::copy(detail::unwrap(first), detail::unwrap(last),
                 detail::unwrap(dst_first));
 }
 
+/// Copy host memory to device.
+/// Copies are done by the host, the returned event is complete.
+template <typename InputIt, typename T>
+event copy_async(InputIt first, InputIt last, device_ptr<T> dst_first,
+        feed& f)
+{
+        copy(first, last, dst_first, f);
+        return event();
+}
+
+/// Copy device memory to host.
+/// Copies are done by the host, the returned event is complete.
+template <typename T, typename OutputIt>
+event copy_async(const device_ptr<T> first, const device_ptr<T> last,
+        OutputIt dst_first, feed& f)
+{
+        copy(first, last, dst_first, f);
+        return event();
+}
+
+/// Copy device to device memory.
+/// Copies are done by the host, the returned event is complete.
+template <typename T>
+event copy_async(const device_ptr<T> first, const device_ptr<T> last,
+        device_ptr<T> dst_first, feed& f)
+{
+        copy(first, last, dst_first, f);
+        return event();
+}
+
 } // metal
 } // base_detail
 } // aura
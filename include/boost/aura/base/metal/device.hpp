@@ -2,6 +2,8 @@
 
 #include <boost/aura/base/allocation_tracker.hpp>
 #include <boost/aura/base/check_initialized.hpp>
+#include <boost/aura/base/device_properties.hpp>
+#include <boost/aura/base/object_cache.hpp>
 #include <boost/aura/base/metal/safecall.hpp>
 #include <boost/aura/platform.hpp>
 
@@ -9,6 +11,7 @@
 #import <Metal/Metal.h>
 
 #include <cstddef>
+#include <cstdlib>
 
 #if ! __has_feature(objc_arc)
 #error This file must be compiled with ARC. Either turn on ARC for the project or use -fobjc-arc flag
@@ -53,6 +56,7 @@ public:
         {
                 device_ = MTLCreateSystemDefaultDevice();
                 AURA_METAL_CHECK_ERROR(device_);
+                query_properties_();
                 initialized_ = true;
         }
 
@@ -65,7 +69,10 @@ public:
                 : initialized_(other.initialized_)
                 , ordinal_(other.ordinal_)
                 , device_(other.device_)
+                , properties_(std::move(other.properties_))
         {
+                // Cached objects refer to the other device object.
+                other.object_cache.clear();
                 other.initialized_ = false;
                 other.ordinal_ = -1;
         }
@@ -74,10 +81,12 @@ public:
         device& operator=(device&& other)
         {
                 reset();
+                other.object_cache.clear();
 
                 initialized_ = other.initialized_;
                 ordinal_ = other.ordinal_;
                 device_ = other.device_;
+                properties_ = std::move(other.properties_);
 
                 other.initialized_ = false;
                 other.ordinal_ = -1;
@@ -89,6 +98,7 @@ public:
         {
                 if (initialized_)
                 {
+                        object_cache.clear();
                         device_ = nil;
                         initialized_ = false;
                 }
@@ -121,16 +131,80 @@ public:
         /// Query initialized state.
         inline bool initialized() const { return initialized_; }
 
+        /// @copydoc boost::aura::base::cuda::device::get_properties()
+        inline const device_properties& get_properties() const
+        {
+                AURA_CHECK_INITIALIZED(initialized_);
+                return properties_;
+        }
+
         /// Shared memory.
         bool supports_shared_memory() const
         {
-                return platform::supports_shared_memory;
+                return properties_.supports_shared_memory;
+        }
+
+        /// Query if mapping device memory is zero-copy.
+        bool supports_zero_copy_map() const
+        {
+                return properties_.supports_shared_memory;
         }
 
         /// Allocation tracker.
         boost::aura::detail::allocation_tracker allocation_tracker;
 
+        /// Objects that live as long as the device (built-in kernels).
+        boost::aura::detail::object_cache object_cache;
+
 private:
+        /// Query device properties.
+        /// Compute units and vector widths are not exposed by Metal, SIMD
+        /// width is a property of pipeline states.
+        void query_properties_()
+        {
+            @autoreleasepool {
+                auto& p = properties_;
+                p.name = [[device_ name] UTF8String];
+                p.vendor = "Apple";
+#if TARGET_OS_IPHONE == 1
+                p.unified_memory = true;
+#else
+                p.unified_memory = [device_ hasUnifiedMemory];
+#endif
+                p.supports_shared_memory = query_shared_storage_();
+                MTLSize extent = [device_ maxThreadsPerThreadgroup];
+                p.max_bundle_extent = {{extent.width, extent.height,
+                        extent.depth}};
+                p.max_bundle_size = extent.width;
+                p.local_memory_size = [device_ maxThreadgroupMemoryLength];
+#if TARGET_OS_IPHONE == 0
+                p.global_memory_size = [device_ recommendedMaxWorkingSetSize];
+#endif
+                p.memory_alignment = platform::memory_alignment;
+            }
+        }
+
+        /// Buffers are created on page aligned host memory, the host
+        /// accesses them directly if the device gives them shared storage.
+        bool query_shared_storage_()
+        {
+                const std::size_t size = platform::memory_alignment;
+                void* page = nullptr;
+                if (posix_memalign(&page, size, size) != 0)
+                {
+                        return false;
+                }
+                id<MTLBuffer> buffer = [device_ newBufferWithBytesNoCopy:page
+                                                                 length:size
+                                                                options:0
+                                                            deallocator:nil];
+                bool shared = buffer != nil &&
+                        [buffer storageMode] == MTLStorageModeShared;
+                buffer = nil;
+                free(page);
+                return shared;
+        }
+
         /// Initialized flag
         bool initialized_;
 
@@ -139,6 +213,9 @@ private:
 
         /// Device handle
         id<MTLDevice> device_;
+
+        /// Device properties
+        device_properties properties_;
 };
 
 } // namespace metal
@@ -4,11 +4,13 @@
 #include <boost/aura/base/metal/device.hpp>
 #include <boost/aura/base/metal/feed.hpp>
 #include <boost/aura/memory_tag.hpp>
-#include <boost/aura/platform.hpp>
 
 #include <boost/core/ignore_unused.hpp>
 
 #include <cstddef>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 #if ! __has_feature(objc_arc)
 #error This file must be compiled with ARC. Either turn on ARC for the project or use -fobjc-arc flag
@@ -80,6 +82,51 @@ template <typename T>
 using device_ptr =
         boost::aura::detail::base_device_ptr<T, device_ptr_base_type<T>>;
 
+/// Kernel argument, the buffer of device memory or the bytes of a value.
+/// Values are set with setBytes, so no buffer is created for them.
+struct arg_t
+{
+        id<MTLBuffer> buffer;
+        std::vector<unsigned char> bytes;
+};
+
+/// Argument of a value.
+template <typename T>
+arg_t make_arg(const T& a)
+{
+        static_assert(std::is_trivially_copyable<T>::value,
+                "kernel arguments must be device memory or values");
+        arg_t arg;
+        auto p = reinterpret_cast<const unsigned char*>(&a);
+        arg.bytes.assign(p, p + sizeof(T));
+        return arg;
+}
+
+/// Argument of device memory.
+template <typename T>
+arg_t make_arg(const device_ptr_base_type<T>& a)
+{
+        arg_t arg;
+        arg.buffer = a.device_buffer;
+        return arg;
+}
+
+/// Set argument index of encoder.
+inline void encode_arg(
+        id<MTLComputeCommandEncoder> enc, const arg_t& a, std::size_t index)
+{
+        if (a.bytes.empty())
+        {
+                [enc setBuffer:a.buffer offset:0 atIndex:index];
+        }
+        else
+        {
+                [enc setBytes:a.bytes.data()
+                       length:a.bytes.size()
+                      atIndex:index];
+        }
+}
+
 
 namespace detail
 {
@@ -94,8 +141,8 @@ device_ptr<T> device_malloc(std::size_t size, device& d,
         memory_access_tag tag = memory_access_tag::rw)
 {
     @autoreleasepool {
-        constexpr std::size_t metal_memory_alignment =
-                platform::memory_alignment;
+        const std::size_t metal_memory_alignment =
+                d.get_properties().memory_alignment;
         std::size_t num_bytes = size * sizeof(T);
         // Compute aligned array size.
         size_t aligned_size = num_bytes +
@@ -138,11 +185,69 @@ void device_free(device_ptr<T>& ptr)
         ptr.reset();
 }
 
-/// Set device memory (bytes).
+/// Alignment (bytes) of device memory regions that alias an allocation.
+inline std::size_t device_region_alignment(device& d)
+{
+        return d.get_properties().memory_alignment;
+}
+
+/// Create region of an allocation (the region is not tracked).
+template <typename T>
+device_ptr<T> device_region(
+        device_ptr<T>& ptr, std::size_t offset_bytes, std::size_t size_bytes)
+{
+    @autoreleasepool {
+        auto host_ptr = reinterpret_cast<char*>(ptr.get_host_ptr()) +
+                offset_bytes;
+        typename device_ptr<T>::base_type m;
+        m.device_buffer =
+                [ptr.get_device().get_base_device()
+                        newBufferWithBytesNoCopy:host_ptr
+                                          length:size_bytes
+                                         options:0
+                                     deallocator:nil];
+        AURA_METAL_CHECK_ERROR(m.device_buffer);
+        // Region shares ownership of the allocation.
+        m.host_ptr = std::shared_ptr<T>(ptr.get_safe_host_ptr(),
+                reinterpret_cast<T*>(host_ptr));
+        return device_ptr<T>(m, ptr.get_device(),
+                ptr.get_memory_access_tag(), ptr.is_shared_memory());
+    }
+}
+
+/// Free region of an allocation.
+template <typename T>
+void device_region_free(device_ptr<T>& ptr)
+{
+        ptr.reset();
+}
+
+/// Map device memory to host.
+/// Returns nullptr, memory is shared with the host.
+template <typename T>
+T* device_map(const device_ptr<T>& ptr, std::size_t num,
+        memory_access_tag tag, feed& f)
+{
+        boost::ignore_unused(ptr, num, tag, f);
+        return nullptr;
+}
+
+/// Unmap device memory mapped with device_map.
+template <typename T>
+void device_unmap(const device_ptr<T>& ptr, T* host_ptr, feed& f)
+{
+        boost::ignore_unused(ptr, host_ptr, f);
+}
+
+/// Set device memory (bytes), not supported while f is capturing.
 template <typename T>
 void device_memset(device_ptr<T> ptr, char value, std::size_t num, feed& f)
 {
-        boost::ignore_unused(f);
+        if (f.get_capture() != nullptr)
+        {
+                throw std::string("can not set memory while feed is "
+                                  "capturing");
+        }
         if (ptr.is_shared_memory())
         {
                 std::memset(reinterpret_cast<void*>(ptr.get_host_ptr()),
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <boost/aura/base/metal/feed.hpp>
+#include <boost/aura/base/metal/safecall.hpp>
+#include <boost/aura/base/worker_pool.hpp>
+
+#include <functional>
+
+#import <Metal/Metal.h>
+
+#if ! __has_feature(objc_arc)
+#error This file must be compiled with ARC. Either turn on ARC for the project or use -fobjc-arc flag
+#endif
+
+namespace boost
+{
+namespace aura
+{
+namespace base_detail
+{
+namespace metal
+{
+
+/// Marker in a feed, completes once all prior commands in the feed are done.
+/// Metal command buffers complete in order, so the event tracks the most
+/// recent command buffer of the feed.
+class event
+{
+public:
+        /// Create empty event.
+        inline explicit event()
+                : command_buffer_(nil)
+        {
+        }
+
+        /// Record event in feed.
+        inline explicit event(feed& f)
+                : command_buffer_(f.get_last_command_buffer())
+        {
+        }
+
+        /// Prevent copies.
+        event(const event&) = delete;
+        void operator=(const event&) = delete;
+
+        /// Move construct.
+        event(event&& other)
+                : command_buffer_(other.command_buffer_)
+        {
+                other.command_buffer_ = nil;
+        }
+
+        /// Move assign.
+        event& operator=(event&& other)
+        {
+                command_buffer_ = other.command_buffer_;
+                other.command_buffer_ = nil;
+                return *this;
+        }
+
+        /// Query if all commands before the event have finished.
+        bool query() const
+        {
+                return command_buffer_ == nil ||
+                        [command_buffer_ status] >=
+                        MTLCommandBufferStatusCompleted;
+        }
+
+        /// Wait until all commands before the event have finished.
+        void synchronize() const
+        {
+            @autoreleasepool {
+                if (command_buffer_ != nil)
+                {
+                        [command_buffer_ waitUntilCompleted];
+                }
+            }
+        }
+
+        /// Call callback once the event has completed.
+        /// Committed command buffers do not accept completion handlers, so
+        /// the callback is run from the worker pool.
+        void then(std::function<void()> callback) const
+        {
+                if (query())
+                {
+                        callback();
+                        return;
+                }
+                id<MTLCommandBuffer> command_buffer = command_buffer_;
+                boost::aura::detail::worker_pool::instance().submit(
+                        [command_buffer, callback]()
+                        {
+                            @autoreleasepool {
+                                [command_buffer waitUntilCompleted];
+                                callback();
+                            }
+                        });
+        }
+
+private:
+        /// Command buffer the event waits for.
+        id<MTLCommandBuffer> command_buffer_;
+};
+
+inline event feed::record() { return event(*this); }
+
+/// Metal command queues can not wait for each other without shared events,
+/// so the host waits.
+inline void feed::wait(const event& e) { e.synchronize(); }
+
+} // metal
+} // base_detail
+} // aura
+} // boost
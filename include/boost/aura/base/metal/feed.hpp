@@ -1,5 +1,6 @@
 #pragma once
 
+#include <boost/aura/base/feed_order.hpp>
 #include <boost/aura/base/metal/device.hpp>
 #include <boost/aura/base/metal/safecall.hpp>
 
@@ -7,6 +8,8 @@
 
 #include <list>
 
+#include <boost/core/ignore_unused.hpp>
+
 #if ! __has_feature(objc_arc)
 #error This file must be compiled with ARC. Either turn on ARC for the project or use -fobjc-arc flag
 #endif
@@ -31,20 +34,28 @@ struct command_buffer
 
 } // detail
 
+class event;
+class graph;
+
 class feed
 {
 public:
         /// @copydoc boost::aura::base::cuda::feed::feed()
         inline explicit feed()
                 : device_(nullptr)
+                , capture_(nullptr)
         {
         }
 
-        /// @copydoc boost::aura::base::cuda::feed::feed(device&)
-        inline explicit feed(device& d)
+        /// @copydoc boost::aura::base::cuda::feed::feed(device&, feed_order)
+        inline explicit feed(
+                device& d, feed_order order = feed_order::in_order)
                 : device_(&d)
                 , feed_([device_->get_base_device() newCommandQueue])
+                , capture_(nullptr)
         {
+                // Command buffers of a queue execute in order.
+                boost::ignore_unused(order);
                 AURA_METAL_CHECK_ERROR(feed_);
         }
 
@@ -52,8 +63,10 @@ public:
         feed(feed&& f)
                 : device_(f.device_)
                 , feed_(f.feed_)
+                , capture_(f.capture_)
         {
                 f.device_ = nil;
+                f.capture_ = nullptr;
         }
 
         /// @copydoc boost::aura::base::cuda::feed::operator=()
@@ -62,7 +75,9 @@ public:
                 finalize();
                 device_ = f.device_;
                 feed_ = f.feed_;
+                capture_ = f.capture_;
                 f.device_ = nil;
+                f.capture_ = nullptr;
                 return *this;
         }
 
@@ -82,6 +97,21 @@ public:
             }
         }
 
+        /// @copydoc boost::aura::base::opencl::feed::record()
+        inline event record();
+
+        /// @copydoc boost::aura::base::opencl::feed::wait()
+        inline void wait(const event& e);
+
+        /// @copydoc boost::aura::base::opencl::feed::begin_capture()
+        void begin_capture(graph& g) { capture_ = &g; }
+
+        /// @copydoc boost::aura::base::opencl::feed::end_capture()
+        void end_capture() { capture_ = nullptr; }
+
+        /// @copydoc boost::aura::base::opencl::feed::get_capture()
+        graph* get_capture() const { return capture_; }
+
         /// @copydoc boost::aura::base::cuda::device::get_base_device()
         inline id<MTLDevice> get_base_device() const
         {
@@ -112,6 +142,17 @@ public:
             }
         }
 
+        /// Return most recent command buffer (nil if there is none).
+        /// @note Metal specific.
+        id<MTLCommandBuffer> get_last_command_buffer() const
+        {
+                if (command_buffers_.empty())
+                {
+                        return nil;
+                }
+                return command_buffers_.back().command_buffer;
+        }
+
 private:
         /// Finalize object.
         void finalize()
@@ -131,6 +172,9 @@ private:
 
         /// Feed handle.
         id<MTLCommandQueue> feed_;
+
+        /// Graph commands are recorded in.
+        graph* capture_;
 };
 
 /**
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <boost/aura/base/metal/device_ptr.hpp>
+#include <boost/aura/base/metal/feed.hpp>
+
+#import <Metal/Metal.h>
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#if ! __has_feature(objc_arc)
+#error This file must be compiled with ARC. Either turn on ARC for the project or use -fobjc-arc flag
+#endif
+
+namespace boost
+{
+namespace aura
+{
+namespace base_detail
+{
+namespace metal
+{
+
+/// Sequence of copies and kernel launches recorded from a feed.
+///
+/// Metal has no command graphs, commands are replayed one by one. Kernels
+/// and host memory used by captured commands must outlive the graph.
+class graph
+{
+public:
+        /// Create empty graph.
+        inline explicit graph() {}
+
+        /// Prevent copies.
+        graph(const graph&) = delete;
+        void operator=(const graph&) = delete;
+
+        /// Move construct.
+        graph(graph&& other) = default;
+
+        /// Move assign.
+        graph& operator=(graph&& other) = default;
+
+        /// Release all commands.
+        void reset()
+        {
+                nodes_.clear();
+                kernel_nodes_.clear();
+        }
+
+        /// @copydoc boost::aura::base::opencl::graph::launch()
+        void launch(feed& f)
+        {
+                for (auto& n : nodes_)
+                {
+                        n(f);
+                }
+        }
+
+        /// @copydoc boost::aura::base::opencl::graph::set_arg()
+        template <typename T>
+        void set_arg(std::size_t kernel_node, std::size_t index, const T& value)
+        {
+                kernel_nodes_.at(kernel_node)(index, make_arg(value));
+        }
+
+        /// Number of commands.
+        std::size_t size() const { return nodes_.size(); }
+
+        /// Number of kernel launches.
+        std::size_t num_kernel_nodes() const { return kernel_nodes_.size(); }
+
+        /// Record command.
+        void add_node(std::function<void(feed&)> command)
+        {
+                nodes_.push_back(std::move(command));
+        }
+
+        /// Record kernel launch, set_arg replaces its arguments.
+        void add_kernel_node(std::function<void(feed&)> command,
+                std::function<void(std::size_t, const arg_t&)> set_arg)
+        {
+                nodes_.push_back(std::move(command));
+                kernel_nodes_.push_back(std::move(set_arg));
+        }
+
+private:
+        /// Captured commands in order.
+        std::vector<std::function<void(feed&)>> nodes_;
+
+        /// Argument setter of each kernel launch.
+        std::vector<std::function<void(std::size_t, const arg_t&)>>
+                kernel_nodes_;
+};
+
+} // metal
+} // base_detail
+} // aura
+} // boost
@@ -1,13 +1,18 @@
 #pragma once
 
 #include <boost/aura/base/base_mesh_bundle.hpp>
+#include <boost/aura/base/metal/device_ptr.hpp>
 #include <boost/aura/base/metal/feed.hpp>
+#include <boost/aura/base/metal/graph.hpp>
 #include <boost/aura/base/metal/kernel.hpp>
 #include <boost/aura/base/metal/safecall.hpp>
 #include <boost/aura/meta/tsizeof.hpp>
 
 #import <Metal/Metal.h>
 
+#include <memory>
+#include <vector>
+
 #if ! __has_feature(objc_arc)
 #error This file must be compiled with ARC. Either turn on ARC for the project or use -fobjc-arc flag
 #endif
@@ -21,44 +26,64 @@ namespace base_detail
 namespace metal
 {
 
-typedef id<MTLBuffer> arg_t;
 template <unsigned long N>
 using args_tt = std::array<arg_t, N>;
 
-// Alias for returned packed arguments.
-template <int N>
-using args_t = args_tt<N>;
+/// Packed arguments.
+template <typename... Targs>
+struct args_t
+{
+        args_tt<sizeof...(Targs)> buffers;
+};
 
 /// Copy arguments to memory block recursively.
 template <typename T0>
 void fill_args_(args_tt<0>::iterator it, const T0 a0)
 {
-        *it = a0.device_buffer;
+        *it = make_arg(a0);
 }
 
 template <typename T0, typename... Targs>
 void fill_args_(args_tt<0>::iterator it, const T0 a0, const Targs... ar)
 {
-        *it = a0.device_buffer;
+        *it = make_arg(a0);
         fill_args_(++it, ar...);
 }
 
 /// Pack arguments.
 template <typename... Targs>
-args_t<sizeof...(Targs)> args_impl(const Targs... ar)
+args_t<Targs...> args_impl(const Targs... ar)
 {
-        args_tt<sizeof...(Targs)> pa;
-        fill_args_(pa.begin(), ar...);
+        args_t<Targs...> pa;
+        fill_args_(pa.buffers.begin(), ar...);
         return pa;
 }
 
 namespace detail
 {
 
-template <unsigned long N, typename MeshType, typename BundleType>
+template <typename MeshType, typename BundleType, typename... Targs>
 inline void invoke_impl(kernel& k, const MeshType& m, const BundleType& b,
-        const args_t<N>&& a, feed& f)
+        const args_t<Targs...>&& a, feed& f)
 {
+        if (f.get_capture() != nullptr)
+        {
+                auto args = std::make_shared<args_t<Targs...>>(a);
+                kernel* kp = &k;
+                MeshType mc = m;
+                BundleType bc = b;
+                f.get_capture()->add_kernel_node(
+                        [kp, mc, bc, args](feed& f2)
+                        {
+                                invoke_impl(*kp, mc, bc,
+                                        args_t<Targs...>(*args), f2);
+                        },
+                        [args](std::size_t index, const arg_t& arg)
+                        {
+                                args->buffers.at(index) = arg;
+                        });
+                return;
+        }
     // Only Cocoa main thread / GCD threads have autorelease pools in place by default.
     @autoreleasepool {
         // Metal base expects mesh size to be not the overal number of threads.
@@ -80,9 +105,9 @@ inline void invoke_impl(kernel& k, const MeshType& m, const BundleType& b,
         [enc setComputePipelineState:pstate];
 
         // Set parameters.
-        for (std::size_t i = 0; i < a.size(); i++)
+        for (std::size_t i = 0; i < a.buffers.size(); i++)
         {
-                [enc setBuffer:a[i] offset:0 atIndex:i];
+                encode_arg(enc, a.buffers[i], i);
         }
 
 #if AURA_DEBUG_MESH_BUNDLE
@@ -104,6 +129,55 @@ inline void invoke_impl(kernel& k, const MeshType& m, const BundleType& b,
 }
 
 
+/// Launch kernel once for each argument pack.
+/// All launches are encoded with one pipeline state into one command
+/// encoder.
+template <typename MeshType, typename BundleType, typename... Targs>
+inline void invoke_many_impl(kernel& k, const MeshType& m,
+        const BundleType& b, const std::vector<args_t<Targs...>>& packs,
+        feed& f)
+{
+        if (f.get_capture() != nullptr)
+        {
+                for (const auto& a : packs)
+                {
+                        invoke_impl(k, m, b, args_t<Targs...>(a), f);
+                }
+                return;
+        }
+    @autoreleasepool {
+        auto mesh_bundle = adjust_mesh_bundle(m, b, mesh_bundle_operation::divide);
+        command_buffer& cmdb = f.get_command_buffer();
+        AURA_METAL_CHECK_ERROR(cmdb.command_buffer);
+
+        id<MTLComputePipelineState> pstate = [f.get_device().get_base_device()
+                newComputePipelineStateWithFunction:k.get_base_kernel()
+                                              error:nil];
+        AURA_METAL_CHECK_ERROR(pstate);
+
+        id<MTLComputeCommandEncoder> enc =
+                [cmdb.command_buffer computeCommandEncoder];
+        AURA_METAL_CHECK_ERROR(enc);
+        [enc setComputePipelineState:pstate];
+
+        MTLSize threadGroups = MTLSizeMake(mesh_bundle.first[0],
+                mesh_bundle.first[1], mesh_bundle.first[2]);
+        MTLSize threadsPerGroup = MTLSizeMake(mesh_bundle.second[0],
+                mesh_bundle.second[1], mesh_bundle.second[2]);
+        for (const auto& a : packs)
+        {
+                for (std::size_t i = 0; i < a.buffers.size(); i++)
+                {
+                        encode_arg(enc, a.buffers[i], i);
+                }
+                [enc dispatchThreadgroups:threadGroups
+                        threadsPerThreadgroup:threadsPerGroup];
+        }
+        [enc endEncoding];
+        [cmdb.command_buffer commit];
+    }
+}
+
 } // namespace detail
 
 } // metal
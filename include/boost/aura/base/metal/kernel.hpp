@@ -1,8 +1,15 @@
 #pragma once
 
+#include <boost/aura/base/bundle_limits.hpp>
+#include <boost/aura/base/kernel_signature.hpp>
 #include <boost/aura/base/metal/library.hpp>
 #include <boost/aura/base/metal/safecall.hpp>
 
+#include <memory>
+#include <vector>
+
+#include <boost/core/ignore_unused.hpp>
+
 #if ! __has_feature(objc_arc)
 #error This file must be compiled with ARC. Either turn on ARC for the project or use -fobjc-arc flag
 #endif
@@ -25,6 +32,8 @@ public:
         /// @copydoc boost::aura::base::cuda::kernel(const std::string& name,
         /// library& l)
         inline explicit kernel(const std::string& name, library& l)
+                : name_(name)
+                , library_hash_(l.get_hash())
         {
             @autoreleasepool {
                 NSString* kernel_name = @(name.c_str());
@@ -35,6 +44,15 @@ public:
             }
         }
 
+        /// @copydoc boost::aura::base::cuda::kernel(const std::string& name,
+        /// std::shared_ptr<library> l)
+        inline explicit kernel(
+                const std::string& name, std::shared_ptr<library> l)
+                : kernel(name, *l)
+        {
+                library_ = std::move(l);
+        }
+
         /// Prevent copies.
         kernel(const kernel&) = delete;
         void operator=(const kernel&) = delete;
@@ -43,6 +61,9 @@ public:
         kernel(kernel&& other)
                 : initialized_(other.initialized_)
                 , kernel_(other.kernel_)
+                , name_(std::move(other.name_))
+                , library_hash_(std::move(other.library_hash_))
+                , library_(std::move(other.library_))
         {
                 other.initialized_ = false;
         }
@@ -54,6 +75,9 @@ public:
 
                 initialized_ = other.initialized_;
                 kernel_ = other.kernel_;
+                name_ = std::move(other.name_);
+                library_hash_ = std::move(other.library_hash_);
+                library_ = std::move(other.library_);
 
                 other.initialized_ = false;
                 return *this;
@@ -67,6 +91,7 @@ public:
                         kernel_ = nil;
                         initialized_ = false;
                 }
+                library_.reset();
         }
 
         /// Destroy kernel.
@@ -75,6 +100,15 @@ public:
         /// Access kernel (base).
         id<MTLFunction> get_base_kernel() { return kernel_; }
 
+        /// @copydoc boost::aura::base::cuda::kernel::get_name()
+        const std::string& get_name() const { return name_; }
+
+        /// @copydoc boost::aura::base::cuda::kernel::get_library_hash()
+        const std::string& get_library_hash() const
+        {
+                return library_hash_;
+        }
+
 
 private:
         /// Initialized flag
@@ -82,8 +116,42 @@ private:
 
         /// Kernel handle.
         id<MTLFunction> kernel_;
+
+        /// Kernel name.
+        std::string name_;
+
+        /// Content hash of the library the kernel was created from.
+        std::string library_hash_;
+
+        /// Library kept alive by this kernel (if created from a shared one).
+        std::shared_ptr<library> library_;
 };
 
+/// @copydoc boost::aura::base::opencl::get_bundle_limits()
+inline bundle_limits get_bundle_limits(kernel& k, device& d)
+{
+    @autoreleasepool {
+        id<MTLComputePipelineState> pstate = [d.get_base_device()
+                newComputePipelineStateWithFunction:k.get_base_kernel()
+                                              error:nil];
+        AURA_METAL_CHECK_ERROR(pstate);
+        bundle_limits l;
+        l.max_size = [pstate maxTotalThreadsPerThreadgroup];
+        l.max_extent = d.get_properties().max_bundle_extent;
+        l.preferred_multiple = [pstate threadExecutionWidth];
+        l.device_name = d.get_properties().name;
+        return l;
+    }
+}
+
+/// Check that kernel parameters match params.
+/// The Metal base has no parameter info, nothing is checked.
+inline void check_signature(
+        kernel& k, const std::vector<kernel_param>& params)
+{
+        boost::ignore_unused(k, params);
+}
+
 } // namespace metal
 } // namespace base_detail
 } // namespace aura
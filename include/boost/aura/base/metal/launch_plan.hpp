@@ -0,0 +1,71 @@
+#pragma once
+
+#include <boost/aura/base/metal/feed.hpp>
+#include <boost/aura/base/metal/invoke.hpp>
+#include <boost/aura/base/metal/kernel.hpp>
+
+#import <Metal/Metal.h>
+
+#include <cstddef>
+#include <utility>
+
+#if ! __has_feature(objc_arc)
+#error This file must be compiled with ARC. Either turn on ARC for the project or use -fobjc-arc flag
+#endif
+
+namespace boost
+{
+namespace aura
+{
+namespace base_detail
+{
+namespace metal
+{
+
+/// @copydoc boost::aura::base_detail::opencl::launch_plan
+/// Metal encodes every launch, the plan saves argument packing only. The
+/// kernel must outlive the plan.
+template <typename... Targs>
+class launch_plan
+{
+public:
+        /// Prepare launch.
+        launch_plan(kernel& k, const mesh& m, const bundle& b,
+                args_t<Targs...>&& a)
+                : kernel_(&k)
+                , mesh_(m)
+                , bundle_(b)
+                , args_(std::move(a))
+        {
+        }
+
+        /// Replace argument I.
+        template <std::size_t I, typename T>
+        void set_arg(const T& value)
+        {
+                args_.buffers.at(I) = make_arg(value);
+        }
+
+        /// Enqueue launch to feed.
+        void enqueue(feed& f)
+        {
+                detail::invoke_impl(
+                        *kernel_, mesh_, bundle_, args_t<Targs...>(args_), f);
+        }
+
+private:
+        /// Kernel to launch.
+        kernel* kernel_;
+
+        /// Mesh and bundle.
+        mesh mesh_;
+        bundle bundle_;
+
+        /// Current arguments.
+        args_t<Targs...> args_;
+};
+
+} // metal
+} // base_detail
+} // aura
+} // boost
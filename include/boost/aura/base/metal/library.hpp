@@ -1,6 +1,8 @@
 #pragma once
 
 #include <boost/aura/base/alang.hpp>
+#include <boost/aura/base/content_hash.hpp>
+#include <boost/aura/base/deferred_build.hpp>
 #include <boost/aura/base/metal/alang.hpp>
 #include <boost/aura/base/metal/device.hpp>
 #include <boost/aura/base/metal/safecall.hpp>
@@ -58,12 +60,29 @@ public:
                 create_from_string(kernelstring, options, inject_aura_preamble);
         }
 
+        /// Create library from string, Metal builds synchronously.
+        inline explicit library(const std::string& kernelstring, device& d,
+                bool inject_aura_preamble, const std::string& options,
+                deferred_build_t)
+                : library(kernelstring, d, inject_aura_preamble, options)
+        {
+        }
+
+        /// Create library from file, Metal builds synchronously.
+        inline explicit library(boost::aura::path p, device& d,
+                bool inject_aura_preamble, const std::string& options,
+                deferred_build_t)
+                : library(p, d, inject_aura_preamble, options)
+        {
+        }
+
         /// Move construct.
         library(library&& other)
                 : initialized_(other.initialized_)
                 , device_(other.device_)
                 , library_(other.library_)
                 , log_(other.log_)
+                , hash_(std::move(other.hash_))
         {
                 other.initialized_ = false;
                 other.device_ = nullptr;
@@ -80,6 +99,7 @@ public:
                 device_ = other.device_;
                 library_ = other.library_;
                 log_ = other.log_;
+                hash_ = std::move(other.hash_);
 
                 other.initialized_ = false;
                 other.device_ = nullptr;
@@ -95,6 +115,9 @@ public:
                 return *device_;
         }
 
+        /// Content hash of source (with preamble) and options.
+        const std::string& get_hash() const { return hash_; }
+
         /// Access library.
         id<MTLLibrary> get_base_library()
         {
@@ -108,6 +131,12 @@ public:
                 return library_;
         }
 
+        /// Wait for build (libraries are always built on construction).
+        void wait() const { AURA_CHECK_INITIALIZED(initialized_); }
+
+        /// Query if the library is built.
+        bool ready() const { return true; }
+
         /// Destructor.
         ~library() { reset(); }
 
@@ -121,6 +150,7 @@ public:
                 }
                 device_ = nullptr;
                 log_ = "";
+                hash_ = "";
         }
 
 private:
@@ -146,6 +176,9 @@ private:
                                 std::string("\n") + kernelstring_with_preamble;
                 }
 
+                hash_ = boost::aura::detail::content_hash(
+                        {kernelstring_with_preamble, opt});
+
                 NSError* err;
                 library_ = [device_->get_base_device()
                         newLibraryWithSource:
@@ -174,6 +207,9 @@ private:
 
         /// Library compile log
         std::string log_;
+
+        /// Content hash of source (with preamble) and options.
+        std::string hash_;
 };
 
 
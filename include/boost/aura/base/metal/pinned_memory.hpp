@@ -0,0 +1,58 @@
+#pragma once
+
+#include <boost/aura/base/metal/device.hpp>
+#include <boost/aura/base/metal/safecall.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+
+namespace boost
+{
+namespace aura
+{
+namespace base_detail
+{
+namespace metal
+{
+
+/// Pinned host memory.
+/// Metal devices share memory with the host, page aligned memory can be
+/// used by the device directly.
+template <typename T>
+struct pinned_memory
+{
+        /// Host pointer.
+        T* host_ptr { nullptr };
+
+        /// Size in bytes.
+        std::size_t size_bytes { 0 };
+};
+
+/// Allocate pinned host memory.
+template <typename T>
+pinned_memory<T> pinned_malloc(std::size_t size, device& d)
+{
+        const std::size_t alignment = d.get_properties().memory_alignment;
+        pinned_memory<T> m;
+        m.size_bytes = std::max<std::size_t>(size * sizeof(T), 1);
+        m.size_bytes += (alignment - m.size_bytes % alignment) % alignment;
+        void* ptr = nullptr;
+        int err = posix_memalign(&ptr, alignment, m.size_bytes);
+        AURA_METAL_CHECK_ERROR((err == 0));
+        m.host_ptr = reinterpret_cast<T*>(ptr);
+        return m;
+}
+
+/// Free pinned host memory.
+template <typename T>
+void pinned_free(pinned_memory<T>& m)
+{
+        free(m.host_ptr);
+        m = pinned_memory<T>();
+}
+
+} // metal
+} // base_detail
+} // aura
+} // boost
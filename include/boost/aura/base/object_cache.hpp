@@ -0,0 +1,102 @@
+#pragma once
+
+#include <exception>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace boost
+{
+namespace aura
+{
+namespace detail
+{
+
+/// Objects (e.g. built-in kernels) kept alive as long as their device.
+class object_cache
+{
+public:
+        /// Create empty cache.
+        object_cache() {}
+
+        /// Prevent copies.
+        object_cache(const object_cache&) = delete;
+        void operator=(const object_cache&) = delete;
+
+        /// Get object stored under key, create it if there is none.
+        /// Objects are created without holding the lock, so creating one
+        /// can use the cache. Other threads asking for the same key wait
+        /// for the object; if create throws, they get the exception and
+        /// the next get tries again.
+        template <typename T>
+        std::shared_ptr<T> get(const std::string& key,
+                const std::function<std::shared_ptr<T>()>& create)
+        {
+                std::promise<std::shared_ptr<void>> promise;
+                std::shared_future<std::shared_ptr<void>> object;
+                bool creating = false;
+                {
+                        std::lock_guard<std::mutex> guard(mutex_);
+                        auto it = objects_.find(key);
+                        if (it == objects_.end())
+                        {
+                                auto future = promise.get_future().share();
+                                it = objects_.emplace(key, future).first;
+                                creating = true;
+                        }
+                        object = it->second;
+                }
+                if (creating)
+                {
+                        try
+                        {
+                                promise.set_value(create());
+                        }
+                        catch (...)
+                        {
+                                {
+                                        std::lock_guard<std::mutex> guard(
+                                                mutex_);
+                                        objects_.erase(key);
+                                }
+                                promise.set_exception(
+                                        std::current_exception());
+                        }
+                }
+                return std::static_pointer_cast<T>(object.get());
+        }
+
+        /// Number of objects.
+        std::size_t size() const
+        {
+                std::lock_guard<std::mutex> guard(mutex_);
+                return objects_.size();
+        }
+
+        /// Release all objects.
+        void clear()
+        {
+                std::map<std::string,
+                        std::shared_future<std::shared_ptr<void>>>
+                        objects;
+                {
+                        std::lock_guard<std::mutex> guard(mutex_);
+                        objects.swap(objects_);
+                }
+        }
+
+private:
+        /// Mutex protecting objects_.
+        mutable std::mutex mutex_;
+
+        /// Objects by key.
+        std::map<std::string, std::shared_future<std::shared_ptr<void>>>
+                objects_;
+};
+
+} // namespace detail
+} // namespace aura
+} // namespace boost
@@ -20,6 +20,10 @@ struct alang_header
 #define AURA_KERNEL __kernel
 #define AURA_CONSTANT __constant
 #define AURA_DEVMEM __global
+#define AURA_SHARED __local
+#define AURA_SYNC barrier(CLK_LOCAL_MEM_FENCE)
+#define AURA_VALUE(type) type
+#define AURA_DEVICE_FUNCTION
 
 #define AURA_MESH_ID_ARG
 #define AURA_MESH_ID_0 get_global_id(0)
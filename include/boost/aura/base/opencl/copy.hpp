@@ -1,7 +1,9 @@
 #pragma once
 
 #include <boost/aura/base/opencl/device_ptr.hpp>
+#include <boost/aura/base/opencl/event.hpp>
 #include <boost/aura/base/opencl/feed.hpp>
+#include <boost/aura/base/opencl/graph.hpp>
 
 #include <iterator>
 
@@ -18,11 +20,34 @@ namespace opencl
 template <typename InputIt, typename T>
 void copy(InputIt first, InputIt last, device_ptr<T> dst_first, feed& f)
 {
+        if (f.get_capture() != nullptr)
+        {
+                auto buffer = dst_first.get_base_ptr().device_buffer;
+                auto offset = dst_first.get_offset() * sizeof(T);
+                auto size = std::distance(first, last) * sizeof(T);
+                const void* src = &(*first);
+                f.get_capture()->add_node(
+                        [=](cl_command_queue q, cl_uint num_events,
+                                const cl_event* wait_list, cl_event* e)
+                        {
+                                AURA_OPENCL_SAFE_CALL(clEnqueueWriteBuffer(q,
+                                        buffer, CL_FALSE, offset, size, src,
+                                        num_events, wait_list, e));
+                        },
+                        {}, {buffer}, host_range(src, size));
+                return;
+        }
+        detail::feed_command c(f, {},
+                {dst_first.get_base_ptr().device_buffer},
+                host_range(&(*first),
+                        std::distance(first, last) * sizeof(T)),
+                host_range());
         AURA_OPENCL_SAFE_CALL(clEnqueueWriteBuffer(f.get_base_feed(),
                 dst_first.get_base_ptr().device_buffer, CL_FALSE,
                 dst_first.get_offset() * sizeof(T),
-                std::distance(first, last) * sizeof(T), &(*first), 0, NULL,
-                NULL));
+                std::distance(first, last) * sizeof(T), &(*first),
+                c.num_events(), c.wait_list(), c.event_ptr()));
+        c.commit();
 }
 
 
@@ -31,11 +56,34 @@ template <typename T, typename OutputIt>
 void copy(const device_ptr<T> first, const device_ptr<T> last,
         OutputIt dst_first, feed& f)
 {
+        if (f.get_capture() != nullptr)
+        {
+                auto buffer = first.get_base_ptr().device_buffer;
+                auto offset = first.get_offset() * sizeof(T);
+                auto size = std::distance(first, last) * sizeof(T);
+                void* dst = &(*dst_first);
+                f.get_capture()->add_node(
+                        [=](cl_command_queue q, cl_uint num_events,
+                                const cl_event* wait_list, cl_event* e)
+                        {
+                                AURA_OPENCL_SAFE_CALL(clEnqueueReadBuffer(q,
+                                        buffer, CL_FALSE, offset, size, dst,
+                                        num_events, wait_list, e));
+                        },
+                        {buffer}, {}, host_range(),
+                        host_range(dst, size));
+                return;
+        }
+        detail::feed_command c(f, {first.get_base_ptr().device_buffer}, {},
+                host_range(),
+                host_range(&(*dst_first),
+                        std::distance(first, last) * sizeof(T)));
         AURA_OPENCL_SAFE_CALL(clEnqueueReadBuffer(f.get_base_feed(),
                 first.get_base_ptr().device_buffer, CL_FALSE,
                 first.get_offset() * sizeof(T),
-                std::distance(first, last) * sizeof(T), &(*dst_first), 0, NULL,
-                NULL));
+                std::distance(first, last) * sizeof(T), &(*dst_first),
+                c.num_events(), c.wait_list(), c.event_ptr()));
+        c.commit();
 }
 
 /// Copy device to device memory.
@@ -43,12 +91,105 @@ template <typename T>
 void copy(const device_ptr<T> first, const device_ptr<T> last,
         device_ptr<T> dst_first, feed& f)
 {
+        if (f.get_capture() != nullptr)
+        {
+                auto src = first.get_base_ptr().device_buffer;
+                auto dst = dst_first.get_base_ptr().device_buffer;
+                auto src_offset = first.get_offset() * sizeof(T);
+                auto dst_offset = dst_first.get_offset() * sizeof(T);
+                auto size = std::distance(first, last) * sizeof(T);
+                f.get_capture()->add_node(
+                        [=](cl_command_queue q, cl_uint num_events,
+                                const cl_event* wait_list, cl_event* e)
+                        {
+                                AURA_OPENCL_SAFE_CALL(clEnqueueCopyBuffer(q,
+                                        src, dst, src_offset, dst_offset, size,
+                                        num_events, wait_list, e));
+                        },
+                        {src}, {dst});
+                return;
+        }
+        detail::feed_command c(f, {first.get_base_ptr().device_buffer},
+                {dst_first.get_base_ptr().device_buffer});
         AURA_OPENCL_SAFE_CALL(clEnqueueCopyBuffer(f.get_base_feed(),
                 first.get_base_ptr().device_buffer,
                 dst_first.get_base_ptr().device_buffer,
                 first.get_offset() * sizeof(T),
                 dst_first.get_offset() * sizeof(T),
-                std::distance(first, last) * sizeof(T), 0, 0, 0));
+                std::distance(first, last) * sizeof(T), c.num_events(),
+                c.wait_list(), c.event_ptr()));
+        c.commit();
+}
+
+/// Copy host memory to device, returns event that completes with the copy.
+/// Capturing feeds record the copy and return an empty event.
+template <typename InputIt, typename T>
+event copy_async(InputIt first, InputIt last, device_ptr<T> dst_first,
+        feed& f)
+{
+        if (f.get_capture() != nullptr)
+        {
+                copy(first, last, dst_first, f);
+                return event();
+        }
+        detail::feed_command c(f, {},
+                {dst_first.get_base_ptr().device_buffer},
+                host_range(&(*first),
+                        std::distance(first, last) * sizeof(T)),
+                host_range(), true);
+        AURA_OPENCL_SAFE_CALL(clEnqueueWriteBuffer(f.get_base_feed(),
+                dst_first.get_base_ptr().device_buffer, CL_FALSE,
+                dst_first.get_offset() * sizeof(T),
+                std::distance(first, last) * sizeof(T), &(*first),
+                c.num_events(), c.wait_list(), c.event_ptr()));
+        return event(c.commit());
+}
+
+/// Copy device memory to host, returns event that completes with the copy.
+/// Capturing feeds record the copy and return an empty event.
+template <typename T, typename OutputIt>
+event copy_async(const device_ptr<T> first, const device_ptr<T> last,
+        OutputIt dst_first, feed& f)
+{
+        if (f.get_capture() != nullptr)
+        {
+                copy(first, last, dst_first, f);
+                return event();
+        }
+        detail::feed_command c(f, {first.get_base_ptr().device_buffer}, {},
+                host_range(),
+                host_range(&(*dst_first),
+                        std::distance(first, last) * sizeof(T)),
+                true);
+        AURA_OPENCL_SAFE_CALL(clEnqueueReadBuffer(f.get_base_feed(),
+                first.get_base_ptr().device_buffer, CL_FALSE,
+                first.get_offset() * sizeof(T),
+                std::distance(first, last) * sizeof(T), &(*dst_first),
+                c.num_events(), c.wait_list(), c.event_ptr()));
+        return event(c.commit());
+}
+
+/// Copy device to device memory, returns event that completes with the
+/// copy. Capturing feeds record the copy and return an empty event.
+template <typename T>
+event copy_async(const device_ptr<T> first, const device_ptr<T> last,
+        device_ptr<T> dst_first, feed& f)
+{
+        if (f.get_capture() != nullptr)
+        {
+                copy(first, last, dst_first, f);
+                return event();
+        }
+        detail::feed_command c(f, {first.get_base_ptr().device_buffer},
+                {dst_first.get_base_ptr().device_buffer}, true);
+        AURA_OPENCL_SAFE_CALL(clEnqueueCopyBuffer(f.get_base_feed(),
+                first.get_base_ptr().device_buffer,
+                dst_first.get_base_ptr().device_buffer,
+                first.get_offset() * sizeof(T),
+                dst_first.get_offset() * sizeof(T),
+                std::distance(first, last) * sizeof(T), c.num_events(),
+                c.wait_list(), c.event_ptr()));
+        return event(c.commit());
 }
 
 } // opencl
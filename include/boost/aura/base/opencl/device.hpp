@@ -2,6 +2,8 @@
 
 #include <boost/aura/base/allocation_tracker.hpp>
 #include <boost/aura/base/check_initialized.hpp>
+#include <boost/aura/base/device_properties.hpp>
+#include <boost/aura/base/object_cache.hpp>
 #include <boost/aura/base/opencl/safecall.hpp>
 #include <boost/aura/platform.hpp>
 
@@ -13,6 +15,8 @@
 #include "CL/cl.h"
 #endif
 
+#include <algorithm>
+#include <string>
 #include <vector>
 
 namespace boost
@@ -24,6 +28,49 @@ namespace base_detail
 namespace opencl
 {
 
+namespace detail
+{
+
+/// Query a string property of a device.
+inline std::string get_device_info_string(
+        cl_device_id device, cl_device_info param)
+{
+        std::size_t size = 0;
+        AURA_OPENCL_SAFE_CALL(clGetDeviceInfo(device, param, 0, NULL, &size));
+        std::string value(size, '\0');
+        AURA_OPENCL_SAFE_CALL(
+                clGetDeviceInfo(device, param, size, &value[0], NULL));
+        // Strip terminating null character(s).
+        value.resize(value.find_last_not_of('\0') + 1);
+        return value;
+}
+
+/// Query a string property of a platform.
+inline std::string get_platform_info_string(
+        cl_platform_id platform, cl_platform_info param)
+{
+        std::size_t size = 0;
+        AURA_OPENCL_SAFE_CALL(
+                clGetPlatformInfo(platform, param, 0, NULL, &size));
+        std::string value(size, '\0');
+        AURA_OPENCL_SAFE_CALL(
+                clGetPlatformInfo(platform, param, size, &value[0], NULL));
+        value.resize(value.find_last_not_of('\0') + 1);
+        return value;
+}
+
+/// Query a scalar property of a device.
+template <typename T>
+inline T get_device_info(cl_device_id device, cl_device_info param)
+{
+        T value = T();
+        AURA_OPENCL_SAFE_CALL(
+                clGetDeviceInfo(device, param, sizeof(value), &value, NULL));
+        return value;
+}
+
+} // namespace detail
+
 class device
 {
 public:
@@ -107,6 +154,7 @@ public:
                         context_, CL_MEM_READ_WRITE, 2, 0, &errorcode);
                 AURA_OPENCL_CHECK_ERROR(errorcode);
 #endif // CL_VERSION_1_2
+                query_properties_();
                 initialized_ = true;
         }
 
@@ -137,7 +185,10 @@ public:
                 , ordinal_(other.ordinal_)
                 , device_(other.device_)
                 , context_(other.context_)
+                , properties_(std::move(other.properties_))
         {
+                // Cached objects refer to the other device object.
+                other.object_cache.clear();
                 other.initialized_ = false;
                 other.ordinal_ = -1;
         }
@@ -146,11 +197,13 @@ public:
         device& operator=(device&& other)
         {
                 reset();
+                other.object_cache.clear();
 
                 initialized_ = other.initialized_;
                 ordinal_ = other.ordinal_;
                 device_ = other.device_;
                 context_ = other.context_;
+                properties_ = std::move(other.properties_);
 
                 other.initialized_ = false;
                 other.ordinal_ = -1;
@@ -162,6 +215,7 @@ public:
         {
                 if (initialized_)
                 {
+                        object_cache.clear();
 #ifndef CL_VERSION_1_2
                         AURA_OPENCL_SAFE_CALL(clReleaseMemObject(dummy_mem_));
 #endif // CL_VERSION_1_2
@@ -212,16 +266,90 @@ public:
         /// Query initialized state.
         inline bool initialized() const { return initialized_; }
 
+        /// @copydoc boost::aura::base::cuda::device::get_properties()
+        inline const device_properties& get_properties() const
+        {
+                AURA_CHECK_INITIALIZED(initialized_);
+                return properties_;
+        }
+
         /// Shared memory.
         bool supports_shared_memory() const
         {
-                return platform::supports_shared_memory;
+                return properties_.supports_shared_memory;
+        }
+
+        /// Query if mapping device memory is zero-copy (device memory is
+        /// host memory, e.g. on CPU devices and integrated GPUs).
+        bool supports_zero_copy_map() const
+        {
+                AURA_CHECK_INITIALIZED(initialized_);
+                return properties_.is_cpu || properties_.unified_memory;
         }
 
         /// Allocation tracker.
         boost::aura::detail::allocation_tracker allocation_tracker;
 
+        /// Objects that live as long as the device (built-in kernels).
+        boost::aura::detail::object_cache object_cache;
+
 private:
+        /// Query device properties.
+        void query_properties_()
+        {
+                using detail::get_device_info;
+                auto& p = properties_;
+                p.name = detail::get_device_info_string(device_, CL_DEVICE_NAME);
+                p.vendor = detail::get_device_info_string(
+                        device_, CL_DEVICE_VENDOR);
+                p.is_cpu = (get_device_info<cl_device_type>(
+                                    device_, CL_DEVICE_TYPE) &
+                                   CL_DEVICE_TYPE_CPU) != 0;
+#ifdef CL_VERSION_1_1
+                p.unified_memory = get_device_info<cl_bool>(device_,
+                                           CL_DEVICE_HOST_UNIFIED_MEMORY) ==
+                        CL_TRUE;
+#endif // CL_VERSION_1_1
+                // Buffers have no host address on any device, the host maps
+                // them (zero-copy on CPUs and unified memory devices).
+                p.supports_shared_memory = false;
+                p.compute_units = get_device_info<cl_uint>(
+                        device_, CL_DEVICE_MAX_COMPUTE_UNITS);
+                p.max_bundle_size = get_device_info<std::size_t>(
+                        device_, CL_DEVICE_MAX_WORK_GROUP_SIZE);
+                // Devices may have more than 3 dimensions.
+                cl_uint dims = get_device_info<cl_uint>(
+                        device_, CL_DEVICE_MAX_WORK_ITEM_DIMENSIONS);
+                std::vector<std::size_t> extent(std::max<cl_uint>(dims, 3), 1);
+                AURA_OPENCL_SAFE_CALL(clGetDeviceInfo(device_,
+                        CL_DEVICE_MAX_WORK_ITEM_SIZES,
+                        sizeof(std::size_t) * dims, &extent[0], NULL));
+                std::copy(extent.begin(), extent.begin() + 3,
+                        p.max_bundle_extent.begin());
+                p.local_memory_size = get_device_info<cl_ulong>(
+                        device_, CL_DEVICE_LOCAL_MEM_SIZE);
+                p.global_memory_size = get_device_info<cl_ulong>(
+                        device_, CL_DEVICE_GLOBAL_MEM_SIZE);
+                p.cache_line_size = get_device_info<cl_uint>(
+                        device_, CL_DEVICE_GLOBAL_MEM_CACHELINE_SIZE);
+                p.memory_alignment = std::max<std::size_t>(
+                        get_device_info<cl_uint>(
+                                device_, CL_DEVICE_MEM_BASE_ADDR_ALIGN) / 8,
+                        1);
+                p.preferred_vector_width_char = get_device_info<cl_uint>(
+                        device_, CL_DEVICE_PREFERRED_VECTOR_WIDTH_CHAR);
+                p.preferred_vector_width_short = get_device_info<cl_uint>(
+                        device_, CL_DEVICE_PREFERRED_VECTOR_WIDTH_SHORT);
+                p.preferred_vector_width_int = get_device_info<cl_uint>(
+                        device_, CL_DEVICE_PREFERRED_VECTOR_WIDTH_INT);
+                p.preferred_vector_width_long = get_device_info<cl_uint>(
+                        device_, CL_DEVICE_PREFERRED_VECTOR_WIDTH_LONG);
+                p.preferred_vector_width_float = get_device_info<cl_uint>(
+                        device_, CL_DEVICE_PREFERRED_VECTOR_WIDTH_FLOAT);
+                p.preferred_vector_width_double = get_device_info<cl_uint>(
+                        device_, CL_DEVICE_PREFERRED_VECTOR_WIDTH_DOUBLE);
+        }
+
         /// Initialized flag
         bool initialized_;
 
@@ -234,6 +362,9 @@ private:
         /// Context handle
         cl_context context_;
 
+        /// Device properties
+        device_properties properties_;
+
 #ifndef CL_VERSION_1_2
           cl_mem dummy_mem_;
 #endif // CL_VERSION_1_2
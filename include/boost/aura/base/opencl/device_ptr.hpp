@@ -6,7 +6,10 @@
 #include <boost/aura/memory_tag.hpp>
 
 
+#include <algorithm>
 #include <cstddef>
+#include <string>
+#include <vector>
 
 namespace boost
 {
@@ -126,10 +129,122 @@ void device_free(device_ptr<T>& ptr)
         ptr.reset();
 }
 
-/// Set device memory (bytes).
+/// Alignment (bytes) of device memory regions that alias an allocation.
+inline std::size_t device_region_alignment(device& d)
+{
+        return d.get_properties().memory_alignment;
+}
+
+/// Create region of an allocation, offset must be aligned to
+/// device_region_alignment (the region is not tracked).
+template <typename T>
+device_ptr<T> device_region(
+        device_ptr<T>& ptr, std::size_t offset_bytes, std::size_t size_bytes)
+{
+        int errorcode = 0;
+        cl_buffer_region region;
+        region.origin = offset_bytes;
+        region.size = size_bytes;
+        typename device_ptr<T>::base_type m;
+        m.device_buffer = clCreateSubBuffer(ptr.get_base_ptr().device_buffer,
+                0, CL_BUFFER_CREATE_TYPE_REGION, &region, &errorcode);
+        AURA_OPENCL_CHECK_ERROR(errorcode);
+        return device_ptr<T>(m, ptr.get_device(),
+                ptr.get_memory_access_tag(), ptr.is_shared_memory());
+}
+
+/// Free region of an allocation.
+template <typename T>
+void device_region_free(device_ptr<T>& ptr)
+{
+        AURA_OPENCL_SAFE_CALL(
+                clReleaseMemObject(ptr.get_base_ptr().device_buffer));
+        ptr.reset();
+}
+
+/// Translates an Aura memory tag to OpenCL map flags.
+inline cl_map_flags translate_map_tag(memory_access_tag tag)
+{
+        switch (tag)
+        {
+        case memory_access_tag::ro:
+                return CL_MAP_READ;
+        case memory_access_tag::wo:
+#ifdef CL_VERSION_1_2
+                // Old content is not needed, driver does not copy it.
+                return CL_MAP_WRITE_INVALIDATE_REGION;
+#else
+                return CL_MAP_WRITE;
+#endif
+        default:
+                return CL_MAP_READ | CL_MAP_WRITE;
+        }
+}
+
+/// Buffer a kernel argument refers to (nullptr for values).
+template <typename T>
+cl_mem arg_buffer(const T&)
+{
+        return nullptr;
+}
+
+template <typename T>
+cl_mem arg_buffer(const device_ptr_base_type<T>& a)
+{
+        return a.device_buffer;
+}
+
+inline cl_mem arg_buffer(const cl_mem& a) { return a; }
+
+/// Map device memory to host (blocks until the memory is mapped).
+/// Returns nullptr if the base does not support mapping.
+template <typename T>
+T* device_map(const device_ptr<T>& ptr, std::size_t num,
+        memory_access_tag tag, feed& f)
+{
+        auto buffer = ptr.get_base_ptr().device_buffer;
+        std::vector<cl_mem> reads;
+        std::vector<cl_mem> writes;
+        if (tag == memory_access_tag::ro)
+        {
+                reads.push_back(buffer);
+        }
+        else
+        {
+                writes.push_back(buffer);
+        }
+        detail::feed_command c(f, reads, writes);
+        int errorcode = 0;
+        void* host_ptr = clEnqueueMapBuffer(f.get_base_feed(), buffer,
+                CL_TRUE, translate_map_tag(tag), ptr.get_offset() * sizeof(T),
+                num * sizeof(T), c.num_events(), c.wait_list(),
+                c.event_ptr(), &errorcode);
+        AURA_OPENCL_CHECK_ERROR(errorcode);
+        c.commit();
+        return reinterpret_cast<T*>(host_ptr);
+}
+
+/// Unmap device memory mapped with device_map.
+template <typename T>
+void device_unmap(const device_ptr<T>& ptr, T* host_ptr, feed& f)
+{
+        detail::feed_command c(f, {}, {ptr.get_base_ptr().device_buffer});
+        AURA_OPENCL_SAFE_CALL(clEnqueueUnmapMemObject(f.get_base_feed(),
+                ptr.get_base_ptr().device_buffer, host_ptr, c.num_events(),
+                c.wait_list(), c.event_ptr()));
+        c.commit();
+}
+
+/// Set device memory (bytes), not supported while f is capturing.
 template <typename T>
 void device_memset(device_ptr<T>& ptr, char value, std::size_t num, feed& f)
 {
+        if (f.get_capture() != nullptr)
+        {
+                throw std::string("can not set memory while feed is "
+                                  "capturing");
+        }
+        detail::feed_command c(f, {}, {ptr.get_base_ptr().device_buffer});
 #ifdef CL_VERSION_1_2
         AURA_OPENCL_SAFE_CALL(
                 clEnqueueFillBuffer(
@@ -139,9 +254,9 @@ void device_memset(device_ptr<T>& ptr, char value, std::size_t num, feed& f)
                         1,
                         0,
                         num,
-                        0,
-                        NULL,
-                        NULL
+                        c.num_events(),
+                        c.wait_list(),
+                        c.event_ptr()
                 )
         );
 #else
@@ -154,12 +269,13 @@ void device_memset(device_ptr<T>& ptr, char value, std::size_t num, feed& f)
                         ptr.get_offset() * sizeof(T),
                         num,
                         &(tmp[0]),
-                        0,
-                        NULL,
-                        NULL
+                        c.num_events(),
+                        c.wait_list(),
+                        c.event_ptr()
                 )
         );
 #endif
+        c.commit();
 }
 
 } // opencl
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <boost/aura/base/opencl/feed.hpp>
+#include <boost/aura/base/opencl/safecall.hpp>
+
+#include <functional>
+#include <memory>
+
+namespace boost
+{
+namespace aura
+{
+namespace base_detail
+{
+namespace opencl
+{
+
+namespace detail
+{
+
+/// Called by the driver once an event has completed.
+inline void CL_CALLBACK event_notify(cl_event, cl_int, void* user_data)
+{
+        std::unique_ptr<std::function<void()>> callback(
+                reinterpret_cast<std::function<void()>*>(user_data));
+        try
+        {
+                (*callback)();
+        }
+        catch (...)
+        {
+                // Exceptions must not propagate into the driver.
+        }
+}
+
+} // namespace detail
+
+/// Marker in a feed, completes once all prior commands in the feed are done.
+class event
+{
+public:
+        /// Create empty event.
+        inline explicit event()
+                : event_(nullptr)
+        {
+        }
+
+        /// Record event in feed.
+        inline explicit event(feed& f)
+        {
+#ifdef CL_VERSION_1_2
+                AURA_OPENCL_SAFE_CALL(clEnqueueMarkerWithWaitList(
+                        f.get_base_feed(), 0, NULL, &event_));
+#else
+                AURA_OPENCL_SAFE_CALL(
+                        clEnqueueMarker(f.get_base_feed(), &event_));
+#endif
+        }
+
+        /// Take ownership of base event.
+        inline explicit event(cl_event e)
+                : event_(e)
+        {
+        }
+
+        /// Prevent copies.
+        event(const event&) = delete;
+        void operator=(const event&) = delete;
+
+        /// Move construct.
+        event(event&& other)
+                : event_(other.event_)
+        {
+                other.event_ = nullptr;
+        }
+
+        /// Move assign.
+        event& operator=(event&& other)
+        {
+                finalize();
+                event_ = other.event_;
+                other.event_ = nullptr;
+                return *this;
+        }
+
+        /// Destroy event.
+        inline ~event() { finalize(); }
+
+        /// Query if all commands before the event have finished.
+        bool query() const
+        {
+                if (nullptr == event_)
+                {
+                        return true;
+                }
+                cl_int status = 0;
+                AURA_OPENCL_SAFE_CALL(clGetEventInfo(event_,
+                        CL_EVENT_COMMAND_EXECUTION_STATUS, sizeof(status),
+                        &status, NULL));
+                // Negative status (error) counts as finished.
+                return status <= CL_COMPLETE;
+        }
+
+        /// Wait until all commands before the event have finished.
+        void synchronize() const
+        {
+                if (nullptr != event_)
+                {
+                        AURA_OPENCL_SAFE_CALL(clWaitForEvents(1, &event_));
+                }
+        }
+
+        /// Call callback once the event has completed.
+        /// The callback runs on a driver thread and must not block.
+        void then(std::function<void()> callback) const
+        {
+                if (nullptr == event_)
+                {
+                        callback();
+                        return;
+                }
+                auto user_data = new std::function<void()>(std::move(callback));
+                auto err = clSetEventCallback(
+                        event_, CL_COMPLETE, detail::event_notify, user_data);
+                if (err != CL_SUCCESS)
+                {
+                        delete user_data;
+                }
+                AURA_OPENCL_CHECK_ERROR(err);
+        }
+
+        /// Access base event.
+        cl_event get_base_event() const { return event_; }
+
+private:
+        /// Finalize object.
+        void finalize()
+        {
+                if (nullptr != event_)
+                {
+                        AURA_OPENCL_SAFE_CALL(clReleaseEvent(event_));
+                        event_ = nullptr;
+                }
+        }
+
+        /// Event handle.
+        cl_event event_;
+};
+
+inline event feed::record() { return event(*this); }
+
+inline void feed::wait(const event& e)
+{
+        cl_event base_event = e.get_base_event();
+        if (nullptr == base_event)
+        {
+                return;
+        }
+#ifdef CL_VERSION_1_2
+        AURA_OPENCL_SAFE_CALL(
+                clEnqueueBarrierWithWaitList(feed_, 1, &base_event, NULL));
+#else
+        AURA_OPENCL_SAFE_CALL(clEnqueueWaitForEvents(feed_, 1, &base_event));
+#endif
+}
+
+} // opencl
+} // base_detail
+} // aura
+} // boost
@@ -1,8 +1,14 @@
 #pragma once
 
 #include <boost/aura/base/opencl/device.hpp>
+#include <boost/aura/base/feed_order.hpp>
 #include <boost/aura/base/opencl/safecall.hpp>
 
+#include <algorithm>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
 namespace boost
 {
 namespace aura
@@ -12,12 +18,46 @@ namespace base_detail
 namespace opencl
 {
 
+class event;
+class graph;
+
+/// Host memory accessed by a command (empty if none).
+struct host_range
+{
+        const void* data = nullptr;
+        std::size_t size = 0;
+
+        host_range() {}
+        host_range(const void* data, std::size_t size)
+                : data(data)
+                , size(size)
+        {
+        }
+
+        /// Query if ranges share a byte.
+        bool overlaps(const host_range& other) const
+        {
+                auto a = static_cast<const char*>(data);
+                auto b = static_cast<const char*>(other.data);
+                return size > 0 && other.size > 0 && a < b + other.size &&
+                        b < a + size;
+        }
+};
+
+/// Commands in out-of-order feeds are ordered by the memory they access:
+/// a command waits for the last write to the memory it reads and for all
+/// accesses to the memory it writes. Buffers are identified by cl_mem,
+/// so regions of one buffer are tracked independently. Host memory of
+/// copies is tracked by address range. Accesses are forgotten once their
+/// commands have completed.
 class feed
 {
 public:
         /// Create empty feed object without device.
         inline explicit feed()
                 : device_(nullptr)
+                , order_(feed_order::in_order)
+                , capture_(nullptr)
         {
         }
 
@@ -25,13 +65,37 @@ public:
          * Create device feed for device.
          *
          * @param d device to create feed for
+         * @param order execute commands in order or ordered by the buffers
+         * they access
          */
-        inline explicit feed(device& d)
+        inline explicit feed(
+                device& d, feed_order order = feed_order::in_order)
                 : device_(&d)
+                , order_(order)
+                , capture_(nullptr)
         {
                 int errorcode = 0;
+                cl_command_queue_properties properties = 0;
+                if (order_ == feed_order::out_of_order)
+                {
+                        // Fall back to in order if the device can not.
+                        cl_command_queue_properties supported;
+                        AURA_OPENCL_SAFE_CALL(clGetDeviceInfo(
+                                device_->get_base_device(),
+                                CL_DEVICE_QUEUE_PROPERTIES,
+                                sizeof(supported), &supported, NULL));
+                        if (supported & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE)
+                        {
+                                properties =
+                                        CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE;
+                        }
+                        else
+                        {
+                                order_ = feed_order::in_order;
+                        }
+                }
                 feed_ = clCreateCommandQueue(device_->get_base_context(),
-                        device_->get_base_device(), 0, &errorcode);
+                        device_->get_base_device(), properties, &errorcode);
                 AURA_OPENCL_CHECK_ERROR(errorcode);
         }
 
@@ -43,8 +107,14 @@ public:
         feed(feed&& f)
                 : device_(f.device_)
                 , feed_(f.feed_)
+                , order_(f.order_)
+                , accesses_(std::move(f.accesses_))
+                , host_accesses_(std::move(f.host_accesses_))
+                , prune_size_(f.prune_size_)
+                , capture_(f.capture_)
         {
                 f.device_ = nullptr;
+                f.capture_ = nullptr;
         }
 
         /**
@@ -57,7 +127,13 @@ public:
                 finalize();
                 device_ = f.device_;
                 feed_ = f.feed_;
+                order_ = f.order_;
+                accesses_ = std::move(f.accesses_);
+                host_accesses_ = std::move(f.host_accesses_);
+                prune_size_ = f.prune_size_;
+                capture_ = f.capture_;
                 f.device_ = nullptr;
+                f.capture_ = nullptr;
                 return *this;
         }
 
@@ -65,7 +141,126 @@ public:
         inline ~feed() { finalize(); }
 
         /// Wait until all commands in the feed have finished.
-        inline void synchronize() { AURA_OPENCL_SAFE_CALL(clFinish(feed_)); }
+        inline void synchronize()
+        {
+                AURA_OPENCL_SAFE_CALL(clFinish(feed_));
+                clear_accesses_();
+        }
+
+        /// Query if commands execute out of order.
+        bool is_out_of_order() const
+        {
+                return order_ == feed_order::out_of_order;
+        }
+
+        /// Record copies and kernel launches in graph instead of executing
+        /// them, until end_capture() is called.
+        void begin_capture(graph& g) { capture_ = &g; }
+
+        /// Stop recording commands.
+        void end_capture() { capture_ = nullptr; }
+
+        /// Graph commands are recorded in, nullptr if not capturing.
+        graph* get_capture() const { return capture_; }
+
+        /// Events a command that reads and writes buffers and host memory
+        /// must wait for. Returns an empty list for in-order feeds.
+        std::vector<cl_event> dependencies(const std::vector<cl_mem>& reads,
+                const std::vector<cl_mem>& writes,
+                host_range host_read = host_range(),
+                host_range host_write = host_range()) const
+        {
+                std::vector<cl_event> result;
+                if (!is_out_of_order())
+                {
+                        return result;
+                }
+                for (const auto& h : host_accesses_)
+                {
+                        if (h.write != nullptr &&
+                                (h.range.overlaps(host_read) ||
+                                        h.range.overlaps(host_write)))
+                        {
+                                result.push_back(h.write);
+                        }
+                        if (h.range.overlaps(host_write))
+                        {
+                                result.insert(result.end(), h.reads.begin(),
+                                        h.reads.end());
+                        }
+                }
+                for (auto m : reads)
+                {
+                        auto it = accesses_.find(m);
+                        if (it != accesses_.end() &&
+                                it->second.write != nullptr)
+                        {
+                                result.push_back(it->second.write);
+                        }
+                }
+                for (auto m : writes)
+                {
+                        auto it = accesses_.find(m);
+                        if (it == accesses_.end())
+                        {
+                                continue;
+                        }
+                        if (it->second.write != nullptr)
+                        {
+                                result.push_back(it->second.write);
+                        }
+                        result.insert(result.end(), it->second.reads.begin(),
+                                it->second.reads.end());
+                }
+                return result;
+        }
+
+        /// Remember event of command that reads and writes buffers and
+        /// host memory.
+        void track(const std::vector<cl_mem>& reads,
+                const std::vector<cl_mem>& writes, cl_event e,
+                host_range host_read = host_range(),
+                host_range host_write = host_range())
+        {
+                if (!is_out_of_order())
+                {
+                        return;
+                }
+                for (auto m : writes)
+                {
+                        accesses_[m].add_write(e);
+                }
+                for (auto m : reads)
+                {
+                        accesses_[m].add_read(e);
+                }
+                if (host_write.size > 0)
+                {
+                        host_access_(host_write).add_write(e);
+                }
+                if (host_read.size > 0)
+                {
+                        host_access_(host_read).add_read(e);
+                }
+                if (accesses_.size() + host_accesses_.size() >= prune_size_)
+                {
+                        prune_();
+                }
+        }
+
+        /// Number of buffers and host ranges with outstanding accesses.
+        std::size_t num_tracked() const
+        {
+                return accesses_.size() + host_accesses_.size();
+        }
+
+        /// Record event, completes once all commands so far have finished.
+        /// @note Defined in event.hpp.
+        inline event record();
+
+        /// Make subsequent commands wait for event (does not block host).
+        /// @note Defined in event.hpp.
+        inline void wait(const event& e);
 
         /// @copydoc boost::aura::base::cuda::device::get_base_device()
         inline cl_device_id get_base_device() const
@@ -92,11 +287,172 @@ public:
 
 
 private:
+        /// Outstanding accesses to a buffer or host range.
+        struct access_t
+        {
+                /// Last command writing the buffer.
+                cl_event write = nullptr;
+
+                /// Commands reading the buffer since the last write.
+                std::vector<cl_event> reads;
+
+                /// Release all events.
+                void release()
+                {
+                        if (write != nullptr)
+                        {
+                                AURA_OPENCL_SAFE_CALL(clReleaseEvent(write));
+                                write = nullptr;
+                        }
+                        for (auto e : reads)
+                        {
+                                AURA_OPENCL_SAFE_CALL(clReleaseEvent(e));
+                        }
+                        reads.clear();
+                }
+
+                /// Replace all accesses by write e.
+                void add_write(cl_event e)
+                {
+                        release();
+                        AURA_OPENCL_SAFE_CALL(clRetainEvent(e));
+                        write = e;
+                }
+
+                /// Add read e, dropping completed reads once the list grows.
+                void add_read(cl_event e)
+                {
+                        if (write == e)
+                        {
+                                // Memory is read and written.
+                                return;
+                        }
+                        if (reads.size() >= 8)
+                        {
+                                prune_reads();
+                        }
+                        AURA_OPENCL_SAFE_CALL(clRetainEvent(e));
+                        reads.push_back(e);
+                }
+
+                /// Release completed reads.
+                void prune_reads()
+                {
+                        auto it = reads.begin();
+                        while (it != reads.end())
+                        {
+                                if (is_complete(*it))
+                                {
+                                        AURA_OPENCL_SAFE_CALL(
+                                                clReleaseEvent(*it));
+                                        it = reads.erase(it);
+                                }
+                                else
+                                {
+                                        ++it;
+                                }
+                        }
+                }
+
+                /// Release completed accesses, returns true if none are
+                /// left.
+                bool prune()
+                {
+                        prune_reads();
+                        if (write != nullptr && is_complete(write))
+                        {
+                                AURA_OPENCL_SAFE_CALL(clReleaseEvent(write));
+                                write = nullptr;
+                        }
+                        return write == nullptr && reads.empty();
+                }
+
+                /// Query if command of event has completed.
+                static bool is_complete(cl_event e)
+                {
+                        cl_int status;
+                        AURA_OPENCL_SAFE_CALL(clGetEventInfo(e,
+                                CL_EVENT_COMMAND_EXECUTION_STATUS,
+                                sizeof(cl_int), &status, NULL));
+                        return status == CL_COMPLETE;
+                }
+        };
+
+        /// Outstanding accesses to a host range.
+        struct host_access_t : access_t
+        {
+                host_range range;
+        };
+
+        /// Accesses to exactly range, added if there are none.
+        access_t& host_access_(host_range range)
+        {
+                for (auto& h : host_accesses_)
+                {
+                        if (h.range.data == range.data &&
+                                h.range.size == range.size)
+                        {
+                                return h;
+                        }
+                }
+                host_accesses_.emplace_back();
+                host_accesses_.back().range = range;
+                return host_accesses_.back();
+        }
+
+        /// Forget completed accesses. Called when the number of tracked
+        /// buffers and ranges has doubled since the last call, so buffers
+        /// that are no longer used (or freed) do not accumulate.
+        void prune_()
+        {
+                for (auto it = accesses_.begin(); it != accesses_.end();)
+                {
+                        if (it->second.prune())
+                        {
+                                it = accesses_.erase(it);
+                        }
+                        else
+                        {
+                                ++it;
+                        }
+                }
+                for (auto it = host_accesses_.begin();
+                        it != host_accesses_.end();)
+                {
+                        if (it->prune())
+                        {
+                                it = host_accesses_.erase(it);
+                        }
+                        else
+                        {
+                                ++it;
+                        }
+                }
+                prune_size_ = std::max(min_prune_size_(), 2 * num_tracked());
+        }
+
+        /// Forget all accesses.
+        void clear_accesses_()
+        {
+                for (auto& a : accesses_)
+                {
+                        a.second.release();
+                }
+                accesses_.clear();
+                for (auto& h : host_accesses_)
+                {
+                        h.release();
+                }
+                host_accesses_.clear();
+                prune_size_ = min_prune_size_();
+        }
+
         /// Finalize object.
         void finalize()
         {
                 if (nullptr != device_)
                 {
+                        clear_accesses_();
                         AURA_OPENCL_SAFE_CALL(clReleaseCommandQueue(feed_));
                 }
         }
@@ -106,8 +462,100 @@ private:
 
         /// Stream handle
         cl_command_queue feed_;
+
+        /// Order of command execution.
+        feed_order order_;
+
+        /// Outstanding accesses per buffer (out-of-order feeds only).
+        std::unordered_map<cl_mem, access_t> accesses_;
+
+        /// Outstanding accesses per host range (out-of-order feeds only).
+        std::vector<host_access_t> host_accesses_;
+
+        /// Number of tracked buffers and ranges that triggers pruning.
+        static std::size_t min_prune_size_() { return 64; }
+        std::size_t prune_size_ = min_prune_size_();
+
+        /// Graph commands are recorded in.
+        graph* capture_;
 };
 
+namespace detail
+{
+
+/// Wait list and event of a command enqueued to a feed.
+class feed_command
+{
+public:
+        /// Prepare command that reads and writes buffers.
+        feed_command(feed& f, std::vector<cl_mem> reads,
+                std::vector<cl_mem> writes, bool keep_event = false)
+                : feed_command(f, std::move(reads), std::move(writes),
+                          host_range(), host_range(), keep_event)
+        {
+        }
+
+        /// Prepare command that reads and writes buffers and host memory.
+        feed_command(feed& f, std::vector<cl_mem> reads,
+                std::vector<cl_mem> writes, host_range host_read,
+                host_range host_write, bool keep_event = false)
+                : feed_(f)
+                , reads_(std::move(reads))
+                , writes_(std::move(writes))
+                , host_read_(host_read)
+                , host_write_(host_write)
+                , wait_list_(f.dependencies(
+                          reads_, writes_, host_read_, host_write_))
+                , keep_event_(keep_event)
+                , event_(nullptr)
+        {
+        }
+
+        /// Number of events in wait list.
+        cl_uint num_events() const { return wait_list_.size(); }
+
+        /// Wait list, NULL if empty.
+        const cl_event* wait_list() const
+        {
+                return wait_list_.empty() ? NULL : &wait_list_[0];
+        }
+
+        /// Event to enqueue the command with, NULL if not needed.
+        cl_event* event_ptr()
+        {
+                return keep_event_ || feed_.is_out_of_order() ? &event_ : NULL;
+        }
+
+        /// Track enqueued command.
+        /// Returns its event if it was kept (the caller owns it).
+        cl_event commit()
+        {
+                if (event_ == nullptr)
+                {
+                        return nullptr;
+                }
+                feed_.track(reads_, writes_, event_, host_read_, host_write_);
+                if (!keep_event_)
+                {
+                        AURA_OPENCL_SAFE_CALL(clReleaseEvent(event_));
+                        return nullptr;
+                }
+                return event_;
+        }
+
+private:
+        feed& feed_;
+        std::vector<cl_mem> reads_;
+        std::vector<cl_mem> writes_;
+        host_range host_read_;
+        host_range host_write_;
+        std::vector<cl_event> wait_list_;
+        bool keep_event_;
+        cl_event event_;
+};
+
+} // namespace detail
+
 } // opencl
 } // base_detail
 } // aura
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <boost/aura/base/opencl/device_ptr.hpp>
+#include <boost/aura/base/opencl/feed.hpp>
+#include <boost/aura/base/opencl/kernel.hpp>
+#include <boost/aura/base/opencl/safecall.hpp>
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace boost
+{
+namespace aura
+{
+namespace base_detail
+{
+namespace opencl
+{
+
+/// Sequence of copies and kernel launches recorded from a feed.
+///
+/// Kernel launches get their own kernel object with arguments set at
+/// capture time, so a replay only enqueues commands. Copies keep the host
+/// pointers they were captured with, which must stay valid.
+class graph
+{
+public:
+        /// Create empty graph.
+        inline explicit graph() {}
+
+        /// Prevent copies.
+        graph(const graph&) = delete;
+        void operator=(const graph&) = delete;
+
+        /// Move construct.
+        graph(graph&& other)
+                : nodes_(std::move(other.nodes_))
+                , kernel_nodes_(std::move(other.kernel_nodes_))
+        {
+                other.nodes_.clear();
+                other.kernel_nodes_.clear();
+        }
+
+        /// Move assign.
+        graph& operator=(graph&& other)
+        {
+                reset();
+                nodes_ = std::move(other.nodes_);
+                kernel_nodes_ = std::move(other.kernel_nodes_);
+                other.nodes_.clear();
+                other.kernel_nodes_.clear();
+                return *this;
+        }
+
+        /// Destroy graph.
+        inline ~graph() { reset(); }
+
+        /// Release all commands.
+        void reset()
+        {
+                for (auto& n : nodes_)
+                {
+                        if (n.kernel != nullptr)
+                        {
+                                AURA_OPENCL_SAFE_CALL(clReleaseKernel(n.kernel));
+                        }
+                }
+                nodes_.clear();
+                kernel_nodes_.clear();
+        }
+
+        /// Enqueue all commands to feed.
+        void launch(feed& f)
+        {
+                auto queue = f.get_base_feed();
+                for (auto& n : nodes_)
+                {
+                        if (!f.is_out_of_order())
+                        {
+                                n.enqueue(queue, 0, NULL, NULL);
+                                continue;
+                        }
+                        detail::feed_command c(f, n.reads, n.writes,
+                                n.host_read, n.host_write);
+                        n.enqueue(queue, c.num_events(), c.wait_list(),
+                                c.event_ptr());
+                        c.commit();
+                }
+        }
+
+        /// Replace argument of captured kernel launch.
+        /// @param kernel_node index of the launch among captured launches
+        /// @param index argument index
+        /// @param value new argument value (memory or scalar)
+        template <typename T>
+        void set_arg(std::size_t kernel_node, std::size_t index, const T& value)
+        {
+                auto& n = nodes_.at(kernel_nodes_.at(kernel_node));
+                AURA_OPENCL_SAFE_CALL(
+                        clSetKernelArg(n.kernel, index, sizeof(T), &value));
+                n.buffers.at(index) = arg_buffer(value);
+                n.writes.clear();
+                for (auto b : n.buffers)
+                {
+                        if (b != nullptr)
+                        {
+                                n.writes.push_back(b);
+                        }
+                }
+        }
+
+        /// Number of commands.
+        std::size_t size() const { return nodes_.size(); }
+
+        /// Number of kernel launches.
+        std::size_t num_kernel_nodes() const { return kernel_nodes_.size(); }
+
+        /// Record command that reads and writes buffers and host memory.
+        /// Used by commands issued to a capturing feed.
+        void add_node(std::function<void(cl_command_queue, cl_uint,
+                              const cl_event*, cl_event*)> enqueue,
+                std::vector<cl_mem> reads, std::vector<cl_mem> writes,
+                host_range host_read = host_range(),
+                host_range host_write = host_range())
+        {
+                node_t n;
+                n.enqueue = std::move(enqueue);
+                n.reads = std::move(reads);
+                n.writes = std::move(writes);
+                n.host_read = host_read;
+                n.host_write = host_write;
+                nodes_.push_back(std::move(n));
+        }
+
+        /// Record kernel launch, the kernel is cloned with its arguments.
+        /// Used by kernel launches issued to a capturing feed.
+        void add_kernel_node(cl_kernel k,
+                const std::vector<std::pair<const void*, std::size_t>>& args,
+                std::vector<cl_mem> buffers, std::array<std::size_t, 3> mesh,
+                std::array<std::size_t, 3> bundle)
+        {
+                node_t n;
+                n.kernel = detail::clone_kernel(k);
+                for (std::size_t i = 0; i < args.size(); i++)
+                {
+                        AURA_OPENCL_SAFE_CALL(clSetKernelArg(n.kernel, i,
+                                args[i].second, args[i].first));
+                }
+                n.buffers = std::move(buffers);
+                for (auto b : n.buffers)
+                {
+                        if (b != nullptr)
+                        {
+                                n.writes.push_back(b);
+                        }
+                }
+                auto clone = n.kernel;
+                n.enqueue = [clone, mesh, bundle](cl_command_queue q,
+                        cl_uint num_events, const cl_event* wait_list,
+                        cl_event* e)
+                {
+                        AURA_OPENCL_SAFE_CALL(clEnqueueNDRangeKernel(q, clone,
+                                mesh.size(), NULL, &mesh[0], &bundle[0],
+                                num_events, wait_list, e));
+                };
+                kernel_nodes_.push_back(nodes_.size());
+                nodes_.push_back(std::move(n));
+        }
+
+private:
+        /// Captured command.
+        struct node_t
+        {
+                /// Enqueue command with wait list and event.
+                std::function<void(cl_command_queue, cl_uint, const cl_event*,
+                        cl_event*)>
+                        enqueue;
+
+                /// Buffers the command reads.
+                std::vector<cl_mem> reads;
+
+                /// Buffers the command writes.
+                std::vector<cl_mem> writes;
+
+                /// Host memory the command reads and writes.
+                host_range host_read;
+                host_range host_write;
+
+                /// Kernel owned by the node (kernel launches only).
+                cl_kernel kernel = nullptr;
+
+                /// Buffer of each kernel argument (nullptr for values).
+                std::vector<cl_mem> buffers;
+        };
+
+        /// Captured commands in order.
+        std::vector<node_t> nodes_;
+
+        /// Index of each kernel launch in nodes_.
+        std::vector<std::size_t> kernel_nodes_;
+};
+
+} // opencl
+} // base_detail
+} // aura
+} // boost
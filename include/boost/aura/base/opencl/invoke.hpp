@@ -1,12 +1,15 @@
 #pragma once
 
 #include <boost/aura/base/base_mesh_bundle.hpp>
+#include <boost/aura/base/opencl/device_ptr.hpp>
 #include <boost/aura/base/opencl/feed.hpp>
+#include <boost/aura/base/opencl/graph.hpp>
 #include <boost/aura/base/opencl/kernel.hpp>
 #include <boost/aura/base/opencl/safecall.hpp>
-#include <boost/aura/meta/tsizeof.hpp>
 
-#include <cstring>
+#include <array>
+#include <tuple>
+#include <vector>
 
 namespace boost
 {
@@ -17,56 +20,101 @@ namespace base_detail
 namespace opencl
 {
 
-typedef std::pair<void*, std::size_t> arg_t;
+/// Kernel argument, buffer is set if the argument is device memory.
+struct arg_t
+{
+        const void* ptr;
+        std::size_t size;
+        cl_mem buffer;
+};
+
 template <std::size_t N>
 using args_tt = std::array<arg_t, N>;
 
-// alias for returned packed arguments
-template <std::size_t N>
-using args_t = std::pair<char*, args_tt<N>>;
+/// Packed arguments, stored inline with the alignment of each type.
+template <typename... Targs>
+struct args_t
+{
+        std::tuple<Targs...> values;
+};
 
-/// Copy arguments to memory block recursively
-template <typename ArgsItr, typename T0>
-void fill_args_(char* p, ArgsItr it, const T0 a0)
+/// Fill argument table recursively
+template <std::size_t I, std::size_t N>
+struct fill_args_
 {
-        std::memcpy(p, &a0, sizeof(T0));
-        *it = std::make_pair(p, sizeof(T0));
-}
+        template <typename Tuple>
+        static void apply(const Tuple& t, arg_t* table)
+        {
+                const auto& v = std::get<I>(t);
+                table[I] = arg_t{&v, sizeof(v), arg_buffer(v)};
+                fill_args_<I + 1, N>::apply(t, table);
+        }
+};
 
-template <typename ArgsItr, typename T0, typename... Targs>
-void fill_args_(char* p, ArgsItr it, const T0 a0, const Targs... ar)
+template <std::size_t N>
+struct fill_args_<N, N>
 {
-        std::memcpy(p, &a0, sizeof(T0));
-        *it = std::make_pair(p, sizeof(T0));
-        fill_args_(p + sizeof(T0), ++it, ar...);
-}
+        template <typename Tuple>
+        static void apply(const Tuple&, arg_t*)
+        {
+        }
+};
 
 /// Pack arguments
 template <typename... Targs>
-args_t<sizeof...(Targs)> args_impl(const Targs... ar)
+args_t<Targs...> args_impl(const Targs... ar)
+{
+        return args_t<Targs...>{std::make_tuple(ar...)};
+}
+
+/// Table of pointers to packed arguments (valid while a is alive)
+template <typename... Targs>
+args_tt<sizeof...(Targs)> arg_table(const args_t<Targs...>& a)
 {
-        args_tt<sizeof...(Targs)> pa;
-        char* p = (char*)malloc(tsizeof<Targs...>::sz);
-        char* ptr = p;
-        fill_args_(p, pa.begin(), ar...);
-        return std::make_pair(ptr, pa);
+        args_tt<sizeof...(Targs)> table;
+        fill_args_<0, sizeof...(Targs)>::apply(a.values, table.data());
+        return table;
 }
 
 namespace detail
 {
 
-template <unsigned long N>
-inline void invoke_impl(
-        kernel& k, const mesh& m, const bundle& b, const args_t<N>&& a, feed& f)
+template <typename... Targs>
+inline void invoke_impl(kernel& k, const mesh& m, const bundle& b,
+        const args_t<Targs...>&& a, feed& f)
 {
-        // set parameters
-        for (std::size_t i = 0; i < a.second.size(); i++)
+        auto table = arg_table(a);
+        auto mesh_bundle = adjust_mesh_bundle(m, b, mesh_bundle_operation::none);
+
+        if (f.get_capture() != nullptr)
         {
-                AURA_OPENCL_SAFE_CALL(clSetKernelArg(k.get_base_kernel(), i,
-                        a.second[i].second, a.second[i].first));
+                std::vector<std::pair<const void*, std::size_t>> args;
+                std::vector<cl_mem> buffers;
+                for (const auto& arg : table)
+                {
+                        args.emplace_back(arg.ptr, arg.size);
+                        buffers.push_back(arg.buffer);
+                }
+                f.get_capture()->add_kernel_node(k.get_base_kernel(), args,
+                        std::move(buffers), mesh_bundle.first,
+                        mesh_bundle.second);
+                return;
         }
 
-        auto mesh_bundle = adjust_mesh_bundle(m, b, mesh_bundle_operation::none);
+        // set parameters that changed since the last launch
+        auto bound = k.bind(table);
+        auto base_kernel = bound.get();
+        std::vector<cl_mem> buffers;
+        for (std::size_t i = 0; i < table.size(); i++)
+        {
+                if (table[i].buffer != nullptr && f.is_out_of_order())
+                {
+                        buffers.push_back(table[i].buffer);
+                }
+        }
+        // Kernels may write every buffer they get (in-order feeds do not
+        // track buffers, so the launch does not allocate).
+        feed_command c(f, {}, std::move(buffers));
 
 #if AURA_DEBUG_MESH_BUNDLE
         std::cout << mesh_bundle.first[0] << " " << mesh_bundle.first[1] << " "
@@ -77,9 +125,66 @@ inline void invoke_impl(
 
         // call kernel
         AURA_OPENCL_SAFE_CALL(clEnqueueNDRangeKernel(f.get_base_feed(),
-                k.get_base_kernel(), mesh_bundle.first.size(), NULL,
-                &mesh_bundle.first[0], &mesh_bundle.second[0], 0, NULL, NULL));
-        free(a.first);
+                base_kernel, mesh_bundle.first.size(), NULL,
+                &mesh_bundle.first[0], &mesh_bundle.second[0], c.num_events(),
+                c.wait_list(), c.event_ptr()));
+        c.commit();
+}
+
+/// Launch kernel once for each argument pack.
+/// The mesh is adjusted once and only arguments that differ from the
+/// previous launch are set.
+template <typename... Targs>
+inline void invoke_many_impl(kernel& k, const mesh& m, const bundle& b,
+        const std::vector<args_t<Targs...>>& packs, feed& f)
+{
+        auto mesh_bundle = adjust_mesh_bundle(m, b, mesh_bundle_operation::none);
+
+        std::vector<std::pair<const void*, std::size_t>> args;
+        std::vector<cl_mem> buffers;
+        for (const auto& a : packs)
+        {
+                auto table = arg_table(a);
+                args.clear();
+                buffers.clear();
+                if (f.get_capture() != nullptr)
+                {
+                        for (const auto& arg : table)
+                        {
+                                args.emplace_back(arg.ptr, arg.size);
+                                buffers.push_back(arg.buffer);
+                        }
+                        f.get_capture()->add_kernel_node(k.get_base_kernel(),
+                                args, buffers, mesh_bundle.first,
+                                mesh_bundle.second);
+                        continue;
+                }
+
+                auto bound = k.bind(table);
+                auto base_kernel = bound.get();
+                if (!f.is_out_of_order())
+                {
+                        AURA_OPENCL_SAFE_CALL(clEnqueueNDRangeKernel(
+                                f.get_base_feed(), base_kernel,
+                                mesh_bundle.first.size(), NULL,
+                                &mesh_bundle.first[0], &mesh_bundle.second[0],
+                                0, NULL, NULL));
+                        continue;
+                }
+                for (const auto& arg : table)
+                {
+                        if (arg.buffer != nullptr)
+                        {
+                                buffers.push_back(arg.buffer);
+                        }
+                }
+                feed_command c(f, {}, buffers);
+                AURA_OPENCL_SAFE_CALL(clEnqueueNDRangeKernel(f.get_base_feed(),
+                        base_kernel, mesh_bundle.first.size(), NULL,
+                        &mesh_bundle.first[0], &mesh_bundle.second[0],
+                        c.num_events(), c.wait_list(), c.event_ptr()));
+                c.commit();
+        }
 }
 
 } // namespace detail
@@ -1,8 +1,18 @@
 #pragma once
 
+#include <boost/aura/base/bundle_limits.hpp>
+#include <boost/aura/base/kernel_signature.hpp>
 #include <boost/aura/base/opencl/library.hpp>
 #include <boost/aura/base/opencl/safecall.hpp>
 
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
 namespace boost
 {
 namespace aura
@@ -12,15 +22,114 @@ namespace base_detail
 namespace opencl
 {
 
+namespace detail
+{
+
+/// Create kernel object with the same function as k.
+inline cl_kernel clone_kernel(cl_kernel k)
+{
+        cl_program program;
+        AURA_OPENCL_SAFE_CALL(clGetKernelInfo(
+                k, CL_KERNEL_PROGRAM, sizeof(program), &program, NULL));
+        std::size_t length;
+        AURA_OPENCL_SAFE_CALL(
+                clGetKernelInfo(k, CL_KERNEL_FUNCTION_NAME, 0, NULL, &length));
+        std::string name(length, '\0');
+        AURA_OPENCL_SAFE_CALL(clGetKernelInfo(
+                k, CL_KERNEL_FUNCTION_NAME, length, &name[0], NULL));
+        int errorcode = 0;
+        auto clone = clCreateKernel(program, name.c_str(), &errorcode);
+        AURA_OPENCL_CHECK_ERROR(errorcode);
+        return clone;
+}
+
+/// Kernel object and the argument values last set on it. Buffers set on
+/// it are retained, so their handles are not reused while they are set.
+struct bound_kernel
+{
+        cl_kernel kernel;
+        std::vector<std::vector<char>> args;
+        std::vector<cl_mem> buffers;
+
+        /// Release buffer of argument i (if it is a buffer).
+        void release_buffer(std::size_t i)
+        {
+                if (buffers[i] != nullptr)
+                {
+                        AURA_OPENCL_SAFE_CALL(clReleaseMemObject(buffers[i]));
+                        buffers[i] = nullptr;
+                }
+        }
+
+        /// Release kernel object and buffers.
+        void release()
+        {
+                for (std::size_t i = 0; i < buffers.size(); i++)
+                {
+                        release_buffer(i);
+                }
+                AURA_OPENCL_SAFE_CALL(clReleaseKernel(kernel));
+        }
+};
+
+} // namespace detail
+
+/// Kernel arguments are bound through bind(), which hands out a kernel
+/// object no other thread uses until the returned binding is destroyed.
+/// Kernel objects are pooled, so there are as many as threads launching
+/// the kernel at the same time. All of them are clones, the kernel object
+/// returned by get_base_kernel() is not pooled. Each keeps the values last
+/// set on it, and values equal to them are not set again. Buffers are
+/// retained while they are set, so a freed buffer keeps its handle until
+/// it is replaced and a new buffer never gets the handle of a set one.
 class kernel
 {
 public:
+        /// Kernel object returned by bind(), given back to the kernel when
+        /// destroyed (after the launch is enqueued).
+        class binding
+        {
+        public:
+                binding(kernel& k, detail::bound_kernel* b)
+                        : kernel_(&k)
+                        , bound_(b)
+                {
+                }
+
+                binding(binding&& other)
+                        : kernel_(other.kernel_)
+                        , bound_(other.bound_)
+                {
+                        other.bound_ = nullptr;
+                }
+
+                binding(const binding&) = delete;
+                void operator=(const binding&) = delete;
+
+                ~binding()
+                {
+                        if (bound_ != nullptr)
+                        {
+                                kernel_->release_(bound_);
+                        }
+                }
+
+                /// Kernel object to enqueue.
+                cl_kernel get() const { return bound_->kernel; }
+
+        private:
+                kernel* kernel_;
+                detail::bound_kernel* bound_;
+        };
+
         /// @copydoc boost::aura::base::cuda::kernel()
         inline explicit kernel() {}
 
         /// @copydoc boost::aura::base::cuda::kernel(const std::string& name,
         /// library& l)
         inline explicit kernel(const std::string& name, library& l)
+                : name_(name)
+                , library_hash_(l.get_hash())
         {
                 int errorcode = 0;
                 kernel_ = clCreateKernel(
@@ -29,6 +138,15 @@ public:
                 initialized_ = true;
         }
 
+        /// Create kernel from shared library, the kernel keeps the library
+        /// alive.
+        inline explicit kernel(
+                const std::string& name, std::shared_ptr<library> l)
+                : kernel(name, *l)
+        {
+                library_ = std::move(l);
+        }
+
         /// Prevent copies.
         kernel(const kernel&) = delete;
         void operator=(const kernel&) = delete;
@@ -37,7 +155,16 @@ public:
         kernel(kernel&& other)
                 : initialized_(other.initialized_)
                 , kernel_(other.kernel_)
+                , name_(std::move(other.name_))
+                , library_hash_(std::move(other.library_hash_))
+                , library_(std::move(other.library_))
+                , skipped_args_(other.skipped_args_.load())
         {
+                std::lock_guard<std::mutex> guard(other.mutex_);
+                bound_ = std::move(other.bound_);
+                free_ = std::move(other.free_);
+                other.bound_.clear();
+                other.free_.clear();
                 other.initialized_ = false;
         }
 
@@ -46,9 +173,18 @@ public:
         {
                 reset();
 
+                std::lock_guard<std::mutex> guard(other.mutex_);
                 initialized_ = other.initialized_;
                 kernel_ = other.kernel_;
+                name_ = std::move(other.name_);
+                library_hash_ = std::move(other.library_hash_);
+                library_ = std::move(other.library_);
+                bound_ = std::move(other.bound_);
+                free_ = std::move(other.free_);
+                skipped_args_ = other.skipped_args_.load();
 
+                other.bound_.clear();
+                other.free_.clear();
                 other.initialized_ = false;
                 return *this;
         }
@@ -58,9 +194,16 @@ public:
         {
                 if (initialized_)
                 {
+                        for (auto& b : bound_)
+                        {
+                                b->release();
+                        }
+                        bound_.clear();
+                        free_.clear();
                         AURA_OPENCL_SAFE_CALL(clReleaseKernel(kernel_));
                         initialized_ = false;
                 }
+                library_.reset();
         }
 
         /// Destroy kernel.
@@ -69,14 +212,196 @@ public:
         /// Access kernel (base).
         cl_kernel get_base_kernel() { return kernel_; }
 
+        /// @copydoc boost::aura::base::cuda::kernel::get_name()
+        const std::string& get_name() const { return name_; }
+
+        /// @copydoc boost::aura::base::cuda::kernel::get_library_hash()
+        const std::string& get_library_hash() const
+        {
+                return library_hash_;
+        }
+
+        /// Bind arguments (elements with ptr, size and buffer) to a kernel
+        /// object and return it. Values equal to the ones last set on the
+        /// kernel object are not set again.
+        template <typename Table>
+        binding bind(const Table& table)
+        {
+                auto b = acquire_();
+                binding result(*this, b);
+                if (b->args.size() < table.size())
+                {
+                        b->args.resize(table.size());
+                        b->buffers.resize(table.size(), nullptr);
+                }
+                for (std::size_t i = 0; i < table.size(); i++)
+                {
+                        auto& shadow = b->args[i];
+                        auto p = static_cast<const char*>(table[i].ptr);
+                        if (table[i].buffer == b->buffers[i] &&
+                                shadow.size() == table[i].size &&
+                                std::memcmp(&shadow[0], p, table[i].size) == 0)
+                        {
+                                skipped_args_++;
+                                continue;
+                        }
+                        AURA_OPENCL_SAFE_CALL(clSetKernelArg(
+                                b->kernel, i, table[i].size, p));
+                        shadow.assign(p, p + table[i].size);
+                        if (table[i].buffer != nullptr)
+                        {
+                                AURA_OPENCL_SAFE_CALL(
+                                        clRetainMemObject(table[i].buffer));
+                        }
+                        b->release_buffer(i);
+                        b->buffers[i] = table[i].buffer;
+                }
+                return result;
+        }
+
+        /// Number of arguments bind() did not set because they were
+        /// already set.
+        std::size_t num_skipped_args() const { return skipped_args_; }
+
+        /// Number of kernel objects (at most the number of threads that
+        /// launched the kernel at the same time).
+        std::size_t num_kernel_objects()
+        {
+                std::lock_guard<std::mutex> guard(mutex_);
+                return bound_.size();
+        }
+
 private:
+        /// Take a free kernel object, or clone a new one.
+        detail::bound_kernel* acquire_()
+        {
+                std::lock_guard<std::mutex> guard(mutex_);
+                if (!free_.empty())
+                {
+                        auto b = free_.back();
+                        free_.pop_back();
+                        return b;
+                }
+                std::unique_ptr<detail::bound_kernel> b(
+                        new detail::bound_kernel());
+                b->kernel = detail::clone_kernel(kernel_);
+                bound_.push_back(std::move(b));
+                return bound_.back().get();
+        }
+
+        /// Give kernel object back.
+        void release_(detail::bound_kernel* b)
+        {
+                std::lock_guard<std::mutex> guard(mutex_);
+                free_.push_back(b);
+        }
+
         /// Initialized flag
         bool initialized_{false};
 
         /// Kernel handle.
         cl_kernel kernel_;
+
+        /// Kernel name.
+        std::string name_;
+
+        /// Content hash of the library the kernel was created from.
+        std::string library_hash_;
+
+        /// Library kept alive by this kernel (if created from a shared one).
+        std::shared_ptr<library> library_;
+
+        /// Protects bound_ and free_.
+        std::mutex mutex_;
+
+        /// Kernel objects and their arguments.
+        std::vector<std::unique_ptr<detail::bound_kernel>> bound_;
+
+        /// Kernel objects not used by a thread.
+        std::vector<detail::bound_kernel*> free_;
+
+        /// Arguments not set by bind() because they were already set.
+        std::atomic<std::size_t> skipped_args_ { 0 };
 };
 
+/// Bundle limits of kernel on device.
+inline bundle_limits get_bundle_limits(kernel& k, device& d)
+{
+        bundle_limits l;
+        AURA_OPENCL_SAFE_CALL(clGetKernelWorkGroupInfo(k.get_base_kernel(),
+                d.get_base_device(), CL_KERNEL_WORK_GROUP_SIZE,
+                sizeof(l.max_size), &l.max_size, NULL));
+        AURA_OPENCL_SAFE_CALL(clGetKernelWorkGroupInfo(k.get_base_kernel(),
+                d.get_base_device(),
+                CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE,
+                sizeof(l.preferred_multiple), &l.preferred_multiple, NULL));
+        l.max_extent = d.get_properties().max_bundle_extent;
+        l.device_name = d.get_properties().name;
+        return l;
+}
+
+/// Check that kernel parameters match params, throws if they do not.
+/// Address spaces and type names are only checked if the driver provides
+/// argument info (OpenCL 1.2). Libraries built from source on OpenCL 1.2
+/// devices with the kernel_arg_info option have it, other libraries (and
+/// libraries loaded from the binary cache) usually do not, for them only
+/// the count is checked.
+inline void check_signature(
+        kernel& k, const std::vector<kernel_param>& params)
+{
+        auto base_kernel = k.get_base_kernel();
+        cl_uint num_args;
+        AURA_OPENCL_SAFE_CALL(clGetKernelInfo(base_kernel, CL_KERNEL_NUM_ARGS,
+                sizeof(num_args), &num_args, NULL));
+        if (num_args != params.size())
+        {
+                std::ostringstream os;
+                os << "Kernel expects " << num_args << " arguments, signature "
+                   << "has " << params.size();
+                throw os.str();
+        }
+#ifdef CL_VERSION_1_2
+        for (cl_uint i = 0; i < num_args; i++)
+        {
+                cl_kernel_arg_address_qualifier address;
+                auto err = clGetKernelArgInfo(base_kernel, i,
+                        CL_KERNEL_ARG_ADDRESS_QUALIFIER, sizeof(address),
+                        &address, NULL);
+                if (err == CL_KERNEL_ARG_INFO_NOT_AVAILABLE)
+                {
+                        return;
+                }
+                AURA_OPENCL_CHECK_ERROR(err);
+                bool is_memory = address == CL_KERNEL_ARG_ADDRESS_GLOBAL ||
+                        address == CL_KERNEL_ARG_ADDRESS_CONSTANT;
+                std::size_t length;
+                AURA_OPENCL_SAFE_CALL(clGetKernelArgInfo(base_kernel, i,
+                        CL_KERNEL_ARG_TYPE_NAME, 0, NULL, &length));
+                std::string type_name(length, '\0');
+                AURA_OPENCL_SAFE_CALL(clGetKernelArgInfo(base_kernel, i,
+                        CL_KERNEL_ARG_TYPE_NAME, length, &type_name[0], NULL));
+                type_name.resize(std::strlen(type_name.c_str()));
+
+                std::string expected = params[i].type_name;
+                if (!expected.empty() && params[i].is_memory)
+                {
+                        expected += "*";
+                }
+                if (is_memory != params[i].is_memory ||
+                        (!expected.empty() && expected != type_name))
+                {
+                        std::ostringstream os;
+                        os << "Kernel argument " << i << " is "
+                           << (is_memory ? "memory " : "value ") << type_name
+                           << ", signature has "
+                           << (params[i].is_memory ? "memory " : "value ")
+                           << expected;
+                        throw os.str();
+                }
+        }
+#endif
+}
+
 } // namespace opencl
 } // namespace base_detail
 } // namespace aura
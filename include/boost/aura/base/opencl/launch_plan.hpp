@@ -0,0 +1,158 @@
+#pragma once
+
+#include <boost/aura/base/base_mesh_bundle.hpp>
+#include <boost/aura/base/opencl/feed.hpp>
+#include <boost/aura/base/opencl/graph.hpp>
+#include <boost/aura/base/opencl/invoke.hpp>
+#include <boost/aura/base/opencl/kernel.hpp>
+#include <boost/aura/base/opencl/safecall.hpp>
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace boost
+{
+namespace aura
+{
+namespace base_detail
+{
+namespace opencl
+{
+
+/// Kernel launch prepared once and enqueued many times.
+///
+/// The plan owns a kernel object with all arguments set and the adjusted
+/// mesh and bundle, so an enqueue is a single clEnqueueNDRangeKernel.
+/// Plans are not thread safe.
+template <typename... Targs>
+class launch_plan
+{
+public:
+        /// Prepare launch.
+        launch_plan(kernel& k, const mesh& m, const bundle& b,
+                args_t<Targs...>&& a)
+                : kernel_(detail::clone_kernel(k.get_base_kernel()))
+                , args_(std::move(a))
+                , mesh_bundle_(adjust_mesh_bundle(
+                          m, b, mesh_bundle_operation::none))
+        {
+                auto table = arg_table(args_);
+                for (std::size_t i = 0; i < table.size(); i++)
+                {
+                        AURA_OPENCL_SAFE_CALL(clSetKernelArg(
+                                kernel_, i, table[i].size, table[i].ptr));
+                }
+                update_buffers_();
+        }
+
+        /// Prevent copies.
+        launch_plan(const launch_plan&) = delete;
+        void operator=(const launch_plan&) = delete;
+
+        /// Move construct.
+        launch_plan(launch_plan&& other)
+                : kernel_(other.kernel_)
+                , args_(std::move(other.args_))
+                , mesh_bundle_(other.mesh_bundle_)
+                , buffers_(std::move(other.buffers_))
+        {
+                other.kernel_ = nullptr;
+        }
+
+        /// Destroy plan.
+        ~launch_plan() { finalize(); }
+
+        /// Replace argument I.
+        template <std::size_t I>
+        void set_arg(const typename std::tuple_element<I,
+                std::tuple<Targs...>>::type& value)
+        {
+                auto& v = std::get<I>(args_.values);
+                // Buffers of old and new value, either can be null.
+                bool buffer_changed = arg_buffer(v) != arg_buffer(value);
+                v = value;
+                AURA_OPENCL_SAFE_CALL(
+                        clSetKernelArg(kernel_, I, sizeof(v), &v));
+                if (buffer_changed)
+                {
+                        update_buffers_();
+                }
+        }
+
+        /// Enqueue launch to feed.
+        void enqueue(feed& f)
+        {
+                if (f.get_capture() != nullptr)
+                {
+                        auto table = arg_table(args_);
+                        std::vector<std::pair<const void*, std::size_t>> args;
+                        std::vector<cl_mem> buffers;
+                        for (const auto& arg : table)
+                        {
+                                args.emplace_back(arg.ptr, arg.size);
+                                buffers.push_back(arg.buffer);
+                        }
+                        f.get_capture()->add_kernel_node(kernel_, args,
+                                std::move(buffers), mesh_bundle_.first,
+                                mesh_bundle_.second);
+                        return;
+                }
+                if (!f.is_out_of_order())
+                {
+                        AURA_OPENCL_SAFE_CALL(clEnqueueNDRangeKernel(
+                                f.get_base_feed(), kernel_,
+                                mesh_bundle_.first.size(), NULL,
+                                &mesh_bundle_.first[0],
+                                &mesh_bundle_.second[0], 0, NULL, NULL));
+                        return;
+                }
+                detail::feed_command c(f, {}, buffers_);
+                AURA_OPENCL_SAFE_CALL(clEnqueueNDRangeKernel(f.get_base_feed(),
+                        kernel_, mesh_bundle_.first.size(), NULL,
+                        &mesh_bundle_.first[0], &mesh_bundle_.second[0],
+                        c.num_events(), c.wait_list(), c.event_ptr()));
+                c.commit();
+        }
+
+private:
+        /// Finalize object.
+        void finalize()
+        {
+                if (kernel_ != nullptr)
+                {
+                        AURA_OPENCL_SAFE_CALL(clReleaseKernel(kernel_));
+                }
+        }
+
+        /// Collect buffer arguments (for out-of-order feeds).
+        void update_buffers_()
+        {
+                buffers_.clear();
+                for (const auto& arg : arg_table(args_))
+                {
+                        if (arg.buffer != nullptr)
+                        {
+                                buffers_.push_back(arg.buffer);
+                        }
+                }
+        }
+
+        /// Kernel object owned by the plan.
+        cl_kernel kernel_;
+
+        /// Current arguments.
+        args_t<Targs...> args_;
+
+        /// Adjusted mesh and bundle.
+        std::pair<mesh, bundle> mesh_bundle_;
+
+        /// Buffer arguments.
+        std::vector<cl_mem> buffers_;
+};
+
+} // opencl
+} // base_detail
+} // aura
+} // boost
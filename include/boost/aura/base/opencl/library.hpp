@@ -1,12 +1,22 @@
 #pragma once
 
 #include <boost/aura/base/alang.hpp>
+#include <boost/aura/base/content_hash.hpp>
+#include <boost/aura/base/deferred_build.hpp>
+#include <boost/aura/base/kernel_signature.hpp>
 #include <boost/aura/base/opencl/alang.hpp>
 #include <boost/aura/base/opencl/device.hpp>
 #include <boost/aura/base/opencl/safecall.hpp>
+#include <boost/aura/binary_cache.hpp>
 #include <boost/aura/io.hpp>
 
+#include <condition_variable>
+#include <cstdio>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 namespace boost
 {
@@ -17,6 +27,77 @@ namespace base_detail
 namespace opencl
 {
 
+namespace detail
+{
+
+/// State of a library build that runs in the background.
+struct build_state
+{
+        std::mutex mutex;
+        std::condition_variable cv;
+
+        /// Set by set_done() once the build is done.
+        bool done { false };
+
+        /// Set once the build log was fetched and the result checked.
+        bool finished { false };
+        bool failed { false };
+
+        /// Binary cache key (empty if the cache is disabled).
+        std::string cache_key;
+
+        /// Keeps the state alive for the driver callback until the build
+        /// is done.
+        std::shared_ptr<build_state> callback_ref;
+
+        /// Mark build done and drop the callback reference. Called by the
+        /// callback, or by the library if the build ended without it; the
+        /// reference is released once, by whichever comes first.
+        void set_done()
+        {
+                std::shared_ptr<build_state> ref;
+                {
+                        std::lock_guard<std::mutex> guard(mutex);
+                        done = true;
+                        ref = std::move(callback_ref);
+                }
+                cv.notify_all();
+        }
+};
+
+/// Called by the driver once a deferred program build has finished.
+inline void CL_CALLBACK build_notify(cl_program, void* user_data)
+{
+        reinterpret_cast<build_state*>(user_data)->set_done();
+}
+
+/// Build options, with kernel_arg_info (requested for typed_kernel)
+/// removed on devices that do not support it (before OpenCL 1.2).
+inline std::string get_build_options(cl_device_id d, const std::string& opt)
+{
+        auto pos = opt.find(boost::aura::kernel_arg_info);
+        if (pos == std::string::npos)
+        {
+                return opt;
+        }
+#ifdef CL_VERSION_1_2
+        // Device version is "OpenCL <major>.<minor> <vendor info>".
+        int major = 0;
+        int minor = 0;
+        std::sscanf(get_device_info_string(d, CL_DEVICE_VERSION).c_str(),
+                "OpenCL %d.%d", &major, &minor);
+        if (major > 1 || (major == 1 && minor >= 2))
+        {
+                return opt;
+        }
+#else
+        (void)d;
+#endif
+        return std::string(opt).erase(
+                pos, std::string(boost::aura::kernel_arg_info).size());
+}
+
+} // namespace detail
 
 class library
 {
@@ -52,12 +133,39 @@ public:
                 create_from_string(kernelstring, options, inject_aura_preamble);
         }
 
+        /// Create library from string, return before the build finished.
+        /// The driver builds in the background (if it supports it), the
+        /// library waits for the build when it is first used.
+        inline explicit library(const std::string& kernelstring, device& d,
+                bool inject_aura_preamble, const std::string& options,
+                deferred_build_t)
+                : initialized_(true)
+                , device_(&d)
+        {
+                create_from_string(
+                        kernelstring, options, inject_aura_preamble, true);
+        }
+
+        /// Create library from file, return before the build finished.
+        inline explicit library(boost::aura::path p, device& d,
+                bool inject_aura_preamble, const std::string& options,
+                deferred_build_t)
+                : initialized_(true)
+                , device_(&d)
+        {
+                auto kernelstring = boost::aura::read_all(p);
+                create_from_string(
+                        kernelstring, options, inject_aura_preamble, true);
+        }
+
         /// Move construct.
         library(library&& other)
                 : initialized_(other.initialized_)
                 , device_(other.device_)
                 , library_(other.library_)
                 , log_(other.log_)
+                , hash_(std::move(other.hash_))
+                , build_(std::move(other.build_))
         {
                 other.initialized_ = false;
                 other.device_ = nullptr;
@@ -74,6 +182,8 @@ public:
                 device_ = other.device_;
                 library_ = other.library_;
                 log_ = other.log_;
+                hash_ = std::move(other.hash_);
+                build_ = std::move(other.build_);
 
                 other.initialized_ = false;
                 other.device_ = nullptr;
@@ -89,19 +199,74 @@ public:
                 return *device_;
         }
 
-        /// Access library.
+        /// Content hash of source (with preamble) and options.
+        const std::string& get_hash() const { return hash_; }
+
+        /// Access library (waits for a deferred build).
         cl_program get_base_library()
         {
-                AURA_CHECK_INITIALIZED(initialized_);
+                wait();
                 return library_;
         }
 
         cl_program get_base_library() const
         {
-                AURA_CHECK_INITIALIZED(initialized_);
+                wait();
                 return library_;
         }
 
+        /// Wait for a deferred build, throws if the build failed.
+        void wait() const
+        {
+                AURA_CHECK_INITIALIZED(initialized_);
+                if (!build_)
+                {
+                        return;
+                }
+                std::unique_lock<std::mutex> lock(build_->mutex);
+                build_->cv.wait(lock, [this]() { return build_->done; });
+                if (!build_->finished)
+                {
+                        build_->finished = true;
+                        cl_build_status status = CL_BUILD_ERROR;
+                        AURA_OPENCL_SAFE_CALL(clGetProgramBuildInfo(library_,
+                                device_->get_base_device(),
+                                CL_PROGRAM_BUILD_STATUS, sizeof(status),
+                                &status, NULL));
+                        build_->failed = status != CL_BUILD_SUCCESS;
+                        finish_build(build_->failed ? "" : build_->cache_key);
+                }
+                if (build_->failed)
+                {
+                        AURA_OPENCL_CHECK_ERROR(CL_BUILD_PROGRAM_FAILURE);
+                }
+        }
+
+        /// Query if the library is built (does not block).
+        bool ready() const
+        {
+                if (!build_)
+                {
+                        return true;
+                }
+                std::lock_guard<std::mutex> guard(build_->mutex);
+                return build_->done;
+        }
+
+        /// Access the compiled device binary.
+        std::vector<unsigned char> get_binary() const
+        {
+                wait();
+                std::size_t size = 0;
+                AURA_OPENCL_SAFE_CALL(clGetProgramInfo(library_,
+                        CL_PROGRAM_BINARY_SIZES, sizeof(size), &size, NULL));
+                std::vector<unsigned char> binary(size);
+                unsigned char* ptr = binary.data();
+                AURA_OPENCL_SAFE_CALL(clGetProgramInfo(library_,
+                        CL_PROGRAM_BINARIES, sizeof(ptr), &ptr, NULL));
+                return binary;
+        }
+
         /// Destructor.
         ~library() { reset(); }
 
@@ -110,18 +275,31 @@ public:
         {
                 if (initialized_)
                 {
+                        if (build_)
+                        {
+                                // Program must outlive its build.
+                                std::unique_lock<std::mutex> lock(
+                                        build_->mutex);
+                                build_->cv.wait(lock,
+                                        [this]() { return build_->done; });
+                        }
                         AURA_OPENCL_SAFE_CALL(clReleaseProgram(library_));
                         initialized_ = false;
                 }
+                build_.reset();
                 device_ = nullptr;
                 log_ = "";
+                hash_ = "";
         }
 
 private:
         /// Create a library from a string.
         void create_from_string(const std::string& kernelstring,
-                const std::string& opt, bool inject_aura_preamble)
+                const std::string& options, bool inject_aura_preamble,
+                bool deferred = false)
         {
+                auto opt = detail::get_build_options(
+                        device_->get_base_device(), options);
                 shared_alang_header salh;
                 alang_header alh;
 
@@ -134,12 +312,63 @@ private:
                                 salh.get() + std::string("\n") + alh.get() +
                                 std::string("\n") + kernelstring_with_preamble;
                 }
+
+                hash_ = boost::aura::detail::content_hash(
+                        {kernelstring_with_preamble, opt});
+
+                // Try to load the binary from the binary cache.
+                auto& cache = boost::aura::binary_cache::instance();
+                std::string cache_key;
+                if (cache.enabled())
+                {
+                        cache_key = get_cache_key(
+                                kernelstring_with_preamble, opt);
+                        std::vector<unsigned char> binary;
+                        if (cache.load(cache_key, binary))
+                        {
+                                if (create_from_binary(binary, opt))
+                                {
+                                        return;
+                                }
+                                cache.report_rejected();
+                        }
+                }
+
                 int errorcode = 0;
                 std::size_t len = kernelstring_with_preamble.length();
                 const char* strings = kernelstring_with_preamble.c_str();
                 library_ =
                         clCreateProgramWithSource(device_->get_base_context(),
                                 1, &strings, &len, &errorcode);
+
+                if (deferred)
+                {
+                        AURA_OPENCL_CHECK_ERROR(errorcode);
+                        build_ = std::make_shared<detail::build_state>();
+                        build_->cache_key = cache_key;
+                        build_->callback_ref = build_;
+                        if (clBuildProgram(library_, 1,
+                                    &device_->get_base_device(), opt.c_str(),
+                                    detail::build_notify,
+                                    build_.get()) != CL_SUCCESS)
+                        {
+                                // If the build still runs the callback marks
+                                // it done, otherwise it ended (the callback
+                                // was called or never will be). Status is
+                                // checked in wait().
+                                cl_build_status status = CL_BUILD_ERROR;
+                                clGetProgramBuildInfo(library_,
+                                        device_->get_base_device(),
+                                        CL_PROGRAM_BUILD_STATUS,
+                                        sizeof(status), &status, NULL);
+                                if (status != CL_BUILD_IN_PROGRESS)
+                                {
+                                        build_->set_done();
+                                }
+                        }
+                        return;
+                }
+
                 try
                 {
                         AURA_OPENCL_CHECK_ERROR(errorcode);
@@ -165,6 +394,12 @@ private:
 
                         throw;
                 }
+                finish_build(cache_key);
+        }
+
+        /// Fetch build log and store binary in cache (if key is not empty).
+        void finish_build(const std::string& cache_key) const
+        {
                 size_t log_size;
                 AURA_OPENCL_SAFE_CALL(clGetProgramBuildInfo(library_,
                         device_->get_base_device(), CL_PROGRAM_BUILD_LOG, 0,
@@ -177,6 +412,70 @@ private:
                         log_size, &(log_[0]), NULL));
 
                 std::cout << log_ << std::endl;
+
+                if (!cache_key.empty())
+                {
+                        std::size_t size = 0;
+                        AURA_OPENCL_SAFE_CALL(clGetProgramInfo(library_,
+                                CL_PROGRAM_BINARY_SIZES, sizeof(size), &size,
+                                NULL));
+                        std::vector<unsigned char> binary(size);
+                        unsigned char* ptr = binary.data();
+                        AURA_OPENCL_SAFE_CALL(clGetProgramInfo(library_,
+                                CL_PROGRAM_BINARIES, sizeof(ptr), &ptr, NULL));
+                        if (!binary.empty())
+                        {
+                                boost::aura::binary_cache::instance().store(
+                                        cache_key, binary);
+                        }
+                }
+        }
+
+        /// Create a library from a cached binary, return false on failure.
+        bool create_from_binary(const std::vector<unsigned char>& binary,
+                const std::string& opt)
+        {
+                int errorcode = 0;
+                int binary_status = 0;
+                std::size_t len = binary.size();
+                const unsigned char* binaries = binary.data();
+                library_ = clCreateProgramWithBinary(
+                        device_->get_base_context(), 1,
+                        &device_->get_base_device(), &len, &binaries,
+                        &binary_status, &errorcode);
+                if (errorcode != CL_SUCCESS)
+                {
+                        return false;
+                }
+                // Stale or incompatible binary, caller builds from source.
+                if (binary_status != CL_SUCCESS ||
+                        clBuildProgram(library_, 1,
+                                &device_->get_base_device(), opt.c_str(),
+                                NULL, NULL) != CL_SUCCESS)
+                {
+                        AURA_OPENCL_SAFE_CALL(clReleaseProgram(library_));
+                        return false;
+                }
+                return true;
+        }
+
+        /// Cache key, identifies source, options, device and driver.
+        std::string get_cache_key(
+                const std::string& kernelstring, const std::string& opt) const
+        {
+                cl_device_id d = device_->get_base_device();
+                cl_platform_id p;
+                AURA_OPENCL_SAFE_CALL(clGetDeviceInfo(
+                        d, CL_DEVICE_PLATFORM, sizeof(p), &p, NULL));
+                return boost::aura::binary_cache::make_key({"opencl",
+                        kernelstring, opt,
+                        detail::get_device_info_string(d, CL_DEVICE_NAME),
+                        detail::get_device_info_string(d, CL_DEVICE_VENDOR),
+                        detail::get_device_info_string(d, CL_DEVICE_VERSION),
+                        detail::get_device_info_string(d, CL_DRIVER_VERSION),
+                        detail::get_platform_info_string(p, CL_PLATFORM_NAME),
+                        detail::get_platform_info_string(
+                                p, CL_PLATFORM_VERSION)});
         }
 
         /// Initialized flag
@@ -189,7 +488,13 @@ private:
         cl_program library_;
 
         /// Library compile log
-        std::string log_;
+        mutable std::string log_;
+
+        /// Content hash of source (with preamble) and options.
+        std::string hash_;
+
+        /// State of deferred build (nullptr if library was built eagerly).
+        std::shared_ptr<detail::build_state> build_;
 };
 
 
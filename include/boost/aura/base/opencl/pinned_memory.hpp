@@ -0,0 +1,123 @@
+#pragma once
+
+#include <boost/aura/base/opencl/device.hpp>
+#include <boost/aura/base/opencl/safecall.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+
+namespace boost
+{
+namespace aura
+{
+namespace base_detail
+{
+namespace opencl
+{
+
+namespace detail
+{
+
+/// Command queue that maps and unmaps pinned memory, shared by all pinned
+/// allocations of a device.
+struct pinned_queue
+{
+        explicit pinned_queue(device& d)
+        {
+                int errorcode = 0;
+                queue = clCreateCommandQueue(d.get_base_context(),
+                        d.get_base_device(), 0, &errorcode);
+                AURA_OPENCL_CHECK_ERROR(errorcode);
+        }
+
+        pinned_queue(const pinned_queue&) = delete;
+        void operator=(const pinned_queue&) = delete;
+
+        ~pinned_queue() { release(); }
+
+        /// Release the queue.
+        void release()
+        {
+                if (queue)
+                {
+                        AURA_OPENCL_SAFE_CALL(clReleaseCommandQueue(queue));
+                        queue = nullptr;
+                }
+        }
+
+        cl_command_queue queue { nullptr };
+};
+
+/// Queue for pinned memory of device, created on first use.
+inline std::shared_ptr<pinned_queue> get_pinned_queue(device& d)
+{
+        return d.object_cache.get<pinned_queue>("opencl_pinned_queue",
+                [&]() { return std::make_shared<pinned_queue>(d); });
+}
+
+} // namespace detail
+
+/// Pinned (page-locked) host memory.
+/// Backed by a CL_MEM_ALLOC_HOST_PTR buffer that stays mapped, transfers
+/// from and to the mapped pointer use DMA without a staging copy.
+template <typename T>
+struct pinned_memory
+{
+        /// Mapped host pointer.
+        T* host_ptr { nullptr };
+
+        /// Buffer that owns the memory.
+        cl_mem buffer { nullptr };
+
+        /// Queue used to map and unmap the buffer (shared, outlives the
+        /// device if the memory does).
+        std::shared_ptr<detail::pinned_queue> queue;
+
+        /// Size in bytes.
+        std::size_t size_bytes { 0 };
+};
+
+/// Allocate pinned host memory.
+template <typename T>
+pinned_memory<T> pinned_malloc(std::size_t size, device& d)
+{
+        int errorcode = 0;
+        pinned_memory<T> m;
+        m.size_bytes = std::max<std::size_t>(size * sizeof(T), 1);
+        m.buffer = clCreateBuffer(d.get_base_context(),
+                CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR, m.size_bytes, 0,
+                &errorcode);
+        AURA_OPENCL_CHECK_ERROR(errorcode);
+        try
+        {
+                m.queue = detail::get_pinned_queue(d);
+                m.host_ptr = reinterpret_cast<T*>(clEnqueueMapBuffer(
+                        m.queue->queue, m.buffer, CL_TRUE,
+                        CL_MAP_READ | CL_MAP_WRITE, 0, m.size_bytes, 0, NULL,
+                        NULL, &errorcode));
+                AURA_OPENCL_CHECK_ERROR(errorcode);
+        }
+        catch (...)
+        {
+                clReleaseMemObject(m.buffer);
+                throw;
+        }
+        return m;
+}
+
+/// Free pinned host memory.
+template <typename T>
+void pinned_free(pinned_memory<T>& m)
+{
+        AURA_OPENCL_SAFE_CALL(clEnqueueUnmapMemObject(
+                m.queue->queue, m.buffer, m.host_ptr, 0, NULL, NULL));
+        AURA_OPENCL_SAFE_CALL(clFinish(m.queue->queue));
+        AURA_OPENCL_SAFE_CALL(clReleaseMemObject(m.buffer));
+        m = pinned_memory<T>();
+}
+
+} // opencl
+} // base_detail
+} // aura
+} // boost
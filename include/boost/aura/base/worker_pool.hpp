@@ -0,0 +1,122 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace boost
+{
+namespace aura
+{
+namespace detail
+{
+
+/// Fixed size pool of worker threads that execute submitted tasks.
+class worker_pool
+{
+public:
+        /// Create pool with num_threads workers.
+        explicit worker_pool(std::size_t num_threads)
+        {
+                num_threads = std::max<std::size_t>(num_threads, 1);
+                for (std::size_t i = 0; i < num_threads; i++)
+                {
+                        threads_.emplace_back([this]() { run_(); });
+                }
+        }
+
+        /// Process-wide pool with one worker per hardware thread.
+        static worker_pool& instance()
+        {
+                static worker_pool pool(std::thread::hardware_concurrency());
+                return pool;
+        }
+
+        /// Prevent copies.
+        worker_pool(const worker_pool&) = delete;
+        void operator=(const worker_pool&) = delete;
+
+        /// Finish queued tasks and join workers.
+        ~worker_pool()
+        {
+                {
+                        std::lock_guard<std::mutex> guard(mutex_);
+                        stop_ = true;
+                }
+                cv_.notify_all();
+                for (auto& t : threads_)
+                {
+                        t.join();
+                }
+        }
+
+        /// Number of worker threads.
+        std::size_t size() const { return threads_.size(); }
+
+        /// Submit task, returns future of its result.
+        template <typename F>
+        auto submit(F f) -> std::future<typename std::result_of<F()>::type>
+        {
+                typedef typename std::result_of<F()>::type result_type;
+                auto task = std::make_shared<std::packaged_task<result_type()>>(
+                        std::move(f));
+                auto future = task->get_future();
+                {
+                        std::lock_guard<std::mutex> guard(mutex_);
+                        tasks_.emplace_back([task]() { (*task)(); });
+                }
+                cv_.notify_one();
+                return future;
+        }
+
+private:
+        /// Worker loop.
+        void run_()
+        {
+                while (true)
+                {
+                        std::function<void()> task;
+                        {
+                                std::unique_lock<std::mutex> lock(mutex_);
+                                cv_.wait(lock, [this]()
+                                        {
+                                                return stop_ || !tasks_.empty();
+                                        });
+                                if (tasks_.empty())
+                                {
+                                        return;
+                                }
+                                task = std::move(tasks_.front());
+                                tasks_.pop_front();
+                        }
+                        // Exceptions are stored in the future of the task.
+                        task();
+                }
+        }
+
+        /// Mutex protecting the task queue.
+        std::mutex mutex_;
+
+        /// Signals new tasks and shutdown.
+        std::condition_variable cv_;
+
+        /// Queued tasks.
+        std::deque<std::function<void()>> tasks_;
+
+        /// Flag that indicates the pool is shutting down.
+        bool stop_ { false };
+
+        /// Worker threads.
+        std::vector<std::thread> threads_;
+};
+
+} // namespace detail
+} // namespace aura
+} // namespace boost
@@ -0,0 +1,352 @@
+#pragma once
+
+#include <boost/aura/base/content_hash.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace boost
+{
+namespace aura
+{
+
+/// Content-addressed on-disk cache for compiled device binaries.
+///
+/// Entries are written to a temporary file and renamed into place, so many
+/// processes can share one cache directory. Loading an entry refreshes its
+/// modification time; if the directory grows beyond max_size bytes the least
+/// recently used entries are evicted.
+///
+/// The process-wide instance is disabled unless AURA_BINARY_CACHE_DIR is set
+/// (AURA_BINARY_CACHE_MAX_SIZE optionally sets the size cap in bytes) or a
+/// directory is set through set_directory().
+class binary_cache
+{
+public:
+        /// Default size cap (256 MiB).
+        static constexpr std::uintmax_t default_max_size = 256 * 1024 * 1024;
+
+        /// Create cache in directory (empty directory disables the cache).
+        explicit binary_cache(const std::string& directory = "",
+                std::uintmax_t max_size = default_max_size)
+                : directory_(directory)
+                , max_size_(max_size)
+        {
+        }
+
+        /// Prevent copies.
+        binary_cache(const binary_cache&) = delete;
+        void operator=(const binary_cache&) = delete;
+
+        /// Process-wide cache used by library.
+        static binary_cache& instance()
+        {
+                static binary_cache cache(get_env_("AURA_BINARY_CACHE_DIR"),
+                        get_env_size_("AURA_BINARY_CACHE_MAX_SIZE",
+                                default_max_size));
+                return cache;
+        }
+
+        /// Set cache directory (empty string disables the cache).
+        void set_directory(const std::string& directory)
+        {
+                std::lock_guard<std::mutex> guard(mutex_);
+                directory_ = directory;
+        }
+
+        /// Set the maximum size of the cache directory in bytes.
+        void set_max_size(std::uintmax_t max_size)
+        {
+                std::lock_guard<std::mutex> guard(mutex_);
+                max_size_ = max_size;
+        }
+
+        /// Access directory.
+        std::string get_directory() const
+        {
+                std::lock_guard<std::mutex> guard(mutex_);
+                return directory_;
+        }
+
+        /// Access size cap.
+        std::uintmax_t get_max_size() const
+        {
+                std::lock_guard<std::mutex> guard(mutex_);
+                return max_size_;
+        }
+
+        /// Query if cache is enabled.
+        bool enabled() const
+        {
+                std::lock_guard<std::mutex> guard(mutex_);
+                return !directory_.empty();
+        }
+
+        /// Create a cache key from the parts that identify a binary.
+        static std::string make_key(std::initializer_list<std::string> parts)
+        {
+                return detail::content_hash(parts);
+        }
+
+        /// Load binary stored under key, return false if there is none.
+        bool load(const std::string& key, std::vector<unsigned char>& binary)
+        {
+                namespace fs = boost::filesystem;
+                auto p = entry_path_(key);
+                if (p.empty())
+                {
+                        return false;
+                }
+
+                boost::system::error_code ec;
+                std::ifstream in(p.string(), std::ios::in | std::ios::binary);
+                auto file_size = fs::file_size(p, ec);
+                if (!in || ec)
+                {
+                        misses_++;
+                        return false;
+                }
+
+                char magic[magic_size_];
+                std::uint64_t size = 0;
+                in.read(magic, magic_size_);
+                in.read(reinterpret_cast<char*>(&size), sizeof(size));
+                // Entry must end exactly after the binary, the size is
+                // checked before it is used to allocate.
+                bool valid = in &&
+                        std::equal(magic, magic + magic_size_, magic_()) &&
+                        file_size >= header_size_ &&
+                        size == file_size - header_size_;
+                if (valid)
+                {
+                        binary.resize(size);
+                        in.read(reinterpret_cast<char*>(binary.data()), size);
+                        valid = static_cast<bool>(in);
+                }
+                in.close();
+
+                if (!valid)
+                {
+                        // Truncated or foreign file, drop it.
+                        binary.clear();
+                        fs::remove(p, ec);
+                        misses_++;
+                        return false;
+                }
+
+                // Mark as recently used for eviction.
+                fs::last_write_time(p, std::time(nullptr), ec);
+                hits_++;
+                return true;
+        }
+
+        /// Count the last successful load as a miss, called if the loaded
+        /// binary could not be used (e.g. it was built by another driver).
+        void report_rejected()
+        {
+                hits_--;
+                misses_++;
+        }
+
+        /// Number of loads that returned a binary that was used.
+        std::size_t num_hits() const { return hits_; }
+
+        /// Number of loads that found no valid entry or a rejected binary
+        /// (while enabled).
+        std::size_t num_misses() const { return misses_; }
+
+        /// Store binary under key (atomically replaces existing entries).
+        void store(const std::string& key,
+                const std::vector<unsigned char>& binary)
+        {
+                namespace fs = boost::filesystem;
+                auto p = entry_path_(key);
+                if (p.empty())
+                {
+                        return;
+                }
+
+                boost::system::error_code ec;
+                fs::create_directories(p.parent_path(), ec);
+                if (ec)
+                {
+                        return;
+                }
+
+                // Write to unique temporary file, then rename into place.
+                auto tmp = p.parent_path() /
+                        fs::unique_path(key + ".%%%%-%%%%-%%%%.tmp");
+                {
+                        std::ofstream out(tmp.string(),
+                                std::ios::out | std::ios::binary);
+                        std::uint64_t size = binary.size();
+                        out.write(magic_(), magic_size_);
+                        out.write(reinterpret_cast<const char*>(&size),
+                                sizeof(size));
+                        out.write(reinterpret_cast<const char*>(binary.data()),
+                                binary.size());
+                        out.close();
+                        if (!out)
+                        {
+                                fs::remove(tmp, ec);
+                                return;
+                        }
+                }
+                fs::rename(tmp, p, ec);
+                if (ec)
+                {
+                        fs::remove(tmp, ec);
+                        return;
+                }
+                evict();
+        }
+
+        /// Remove least recently used entries until cache fits size cap.
+        void evict()
+        {
+                namespace fs = boost::filesystem;
+                fs::path directory;
+                std::uintmax_t max_size;
+                {
+                        std::lock_guard<std::mutex> guard(mutex_);
+                        directory = directory_;
+                        max_size = max_size_;
+                }
+                if (directory.empty())
+                {
+                        return;
+                }
+
+                boost::system::error_code ec;
+                std::vector<std::pair<std::time_t, fs::path>> entries;
+                std::uintmax_t total_size = 0;
+                for (fs::directory_iterator it(directory, ec), end;
+                        !ec && it != end; it.increment(ec))
+                {
+                        if (it->path().extension() != extension_())
+                        {
+                                continue;
+                        }
+                        auto size = fs::file_size(it->path(), ec);
+                        auto time = fs::last_write_time(it->path(), ec);
+                        if (ec)
+                        {
+                                // Removed by another process.
+                                ec.clear();
+                                continue;
+                        }
+                        entries.emplace_back(time, it->path());
+                        total_size += size;
+                }
+                if (total_size <= max_size)
+                {
+                        return;
+                }
+
+                std::sort(entries.begin(), entries.end());
+                for (const auto& entry : entries)
+                {
+                        if (total_size <= max_size)
+                        {
+                                break;
+                        }
+                        auto size = fs::file_size(entry.second, ec);
+                        if (!ec && fs::remove(entry.second, ec))
+                        {
+                                total_size -= size;
+                        }
+                        ec.clear();
+                }
+        }
+
+        /// Remove all entries.
+        void clear()
+        {
+                namespace fs = boost::filesystem;
+                auto directory = fs::path(get_directory());
+                if (directory.empty())
+                {
+                        return;
+                }
+                boost::system::error_code ec;
+                for (fs::directory_iterator it(directory, ec), end;
+                        !ec && it != end; it.increment(ec))
+                {
+                        if (it->path().extension() == extension_())
+                        {
+                                boost::system::error_code rec;
+                                fs::remove(it->path(), rec);
+                        }
+                }
+        }
+
+private:
+        /// Path of entry for key (empty if cache is disabled).
+        boost::filesystem::path entry_path_(const std::string& key) const
+        {
+                std::lock_guard<std::mutex> guard(mutex_);
+                if (directory_.empty())
+                {
+                        return boost::filesystem::path();
+                }
+                return boost::filesystem::path(directory_) /
+                        (key + extension_());
+        }
+
+        /// File extension of cache entries.
+        static const char* extension_() { return ".aurabin"; }
+
+        /// Read environment variable (empty string if not set).
+        static std::string get_env_(const char* name)
+        {
+                const char* v = std::getenv(name);
+                return v ? std::string(v) : std::string();
+        }
+
+        /// Read size from environment variable.
+        static std::uintmax_t get_env_size_(
+                const char* name, std::uintmax_t default_value)
+        {
+                auto v = get_env_(name);
+                if (v.empty())
+                {
+                        return default_value;
+                }
+                return std::strtoull(v.c_str(), nullptr, 10);
+        }
+
+        /// Magic bytes at the beginning of each entry.
+        static const char* magic_() { return "AURABIN1"; }
+        enum
+        {
+                magic_size_ = 8,
+                header_size_ = magic_size_ + sizeof(std::uint64_t)
+        };
+
+        /// Mutex protecting configuration.
+        mutable std::mutex mutex_;
+
+        /// Cache directory.
+        std::string directory_;
+
+        /// Maximum size of cache directory in bytes.
+        std::uintmax_t max_size_;
+
+        /// Load statistics.
+        std::atomic<std::size_t> hits_ { 0 };
+        std::atomic<std::size_t> misses_ { 0 };
+};
+
+} // namespace aura
+} // namespace boost
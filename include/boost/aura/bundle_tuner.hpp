@@ -0,0 +1,340 @@
+#pragma once
+
+#include <boost/aura/base/bundle_limits.hpp>
+#include <boost/aura/feed.hpp>
+#include <boost/aura/invoke.hpp>
+#include <boost/aura/kernel.hpp>
+#include <boost/aura/mesh_bundle.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace boost
+{
+namespace aura
+{
+
+#if defined AURA_BASE_CUDA
+namespace base = base_detail::cuda;
+#elif defined AURA_BASE_OPENCL
+namespace base = base_detail::opencl;
+#elif defined AURA_BASE_METAL
+namespace base = base_detail::metal;
+#endif
+
+using base::get_bundle_limits;
+
+/// Tag that lets invoke pick the bundle, e.g.
+/// invoke(k, mesh({{1024, 1, 1}}), auto_bundle, args(...), f);
+struct auto_bundle_t
+{
+};
+const auto_bundle_t auto_bundle = auto_bundle_t();
+
+/// Finds the fastest bundle for a kernel, mesh and device by timing
+/// launches of all candidate bundles.
+///
+/// Results are kept per device name, library contents, kernel name and
+/// mesh, so kernels of edited or different libraries are tuned again. The
+/// process-wide instance stores them in the file AURA_BUNDLE_CACHE points
+/// to (results are kept in memory only if it is not set).
+class bundle_tuner
+{
+public:
+        /// Create tuner that stores results in file (empty file name keeps
+        /// results in memory).
+        explicit bundle_tuner(const std::string& file = "")
+                : file_(file)
+                , loaded_(false)
+        {
+        }
+
+        /// Prevent copies.
+        bundle_tuner(const bundle_tuner&) = delete;
+        void operator=(const bundle_tuner&) = delete;
+
+        /// Process-wide tuner used by invoke with auto_bundle.
+        static bundle_tuner& instance()
+        {
+                const char* v = std::getenv("AURA_BUNDLE_CACHE");
+                static bundle_tuner tuner(v ? std::string(v) : std::string());
+                return tuner;
+        }
+
+        /// Access file.
+        std::string get_file() const
+        {
+                std::lock_guard<std::mutex> guard(mutex_);
+                return file_;
+        }
+
+        /// Bundles that divide the mesh and fit the limits, best guess first.
+        /// Extents are powers of two; if some bundle sizes are a multiple of
+        /// the preferred multiple, only those are returned.
+        static std::vector<bundle> candidates(
+                const mesh& m, const bundle_limits& l)
+        {
+                std::vector<bundle> all;
+                for (std::size_t x = 1; x <= l.max_extent[0] && x <= m[0];
+                        x *= 2)
+                {
+                        for (std::size_t y = 1;
+                                y <= l.max_extent[1] && y <= m[1]; y *= 2)
+                        {
+                                for (std::size_t z = 1;
+                                        z <= l.max_extent[2] && z <= m[2];
+                                        z *= 2)
+                                {
+                                        if (x * y * z <= l.max_size &&
+                                                m[0] % x == 0 &&
+                                                m[1] % y == 0 && m[2] % z == 0)
+                                        {
+                                                all.push_back({{x, y, z}});
+                                        }
+                                }
+                        }
+                }
+
+                std::vector<bundle> preferred;
+                for (const auto& b : all)
+                {
+                        if (l.preferred_multiple > 0 &&
+                                size_(b) % l.preferred_multiple == 0)
+                        {
+                                preferred.push_back(b);
+                        }
+                }
+                auto& result = preferred.empty() ? all : preferred;
+                // Larger bundles first, wide in x before y and z.
+                std::stable_sort(result.begin(), result.end(),
+                        [](const bundle& a, const bundle& b)
+                        {
+                                if (size_(a) != size_(b))
+                                {
+                                        return size_(a) > size_(b);
+                                }
+                                return a[0] > b[0];
+                        });
+                return result;
+        }
+
+        /// Time kernel with all candidate bundles and store the fastest.
+        /// The kernel is launched several times with the same arguments,
+        /// so it must not depend on its own output. m is the number of all
+        /// threads.
+        template <typename... Targs>
+        bundle tune(kernel& k, const mesh& m,
+                const base::args_t<Targs...>& a, feed& f,
+                std::size_t repetitions = 3)
+        {
+                if (f.get_capture() != nullptr)
+                {
+                        throw std::string("can not tune bundle while feed "
+                                          "is capturing");
+                }
+                auto l = get_bundle_limits(k, f.get_device());
+                auto c = candidates(m, l);
+                bundle best = {{1, 1, 1}};
+                double best_time = std::numeric_limits<double>::max();
+                for (const auto& b : c)
+                {
+                        // First launch is warm up.
+                        invoke(k, m, b, base::args_t<Targs...>(a), f,
+                                mesh_definition::all_threads);
+                        wait_for(f);
+                        for (std::size_t i = 0; i < repetitions; i++)
+                        {
+                                auto start = std::chrono::
+                                        high_resolution_clock::now();
+                                invoke(k, m, b, base::args_t<Targs...>(a), f,
+                                        mesh_definition::all_threads);
+                                wait_for(f);
+                                auto stop = std::chrono::
+                                        high_resolution_clock::now();
+                                double t = std::chrono::duration<double>(
+                                        stop - start).count();
+                                if (t < best_time)
+                                {
+                                        best_time = t;
+                                        best = b;
+                                }
+                        }
+                }
+
+                std::lock_guard<std::mutex> guard(mutex_);
+                load_();
+                results_[key_(l, k, m)] = best;
+                save_();
+                return best;
+        }
+
+        /// Look up tuned bundle, return false if kernel was not tuned for
+        /// mesh on device or the tuned bundle exceeds the kernel limits.
+        bool lookup(kernel& k, const mesh& m, device& d, bundle& b)
+        {
+                auto l = get_bundle_limits(k, d);
+                auto key = key_(l, k, m);
+                std::lock_guard<std::mutex> guard(mutex_);
+                load_();
+                auto it = results_.find(key);
+                if (it == results_.end() || !fits_(it->second, l))
+                {
+                        return false;
+                }
+                b = it->second;
+                return true;
+        }
+
+        /// Tuned bundle, or the best guess if kernel was not tuned for mesh
+        /// on device.
+        bundle get(kernel& k, const mesh& m, device& d)
+        {
+                bundle b;
+                if (lookup(k, m, d, b))
+                {
+                        return b;
+                }
+                auto c = candidates(m, get_bundle_limits(k, d));
+                return c.empty() ? bundle({{1, 1, 1}}) : c.front();
+        }
+
+        /// Remove all results (the file is kept until the next tune).
+        void clear()
+        {
+                std::lock_guard<std::mutex> guard(mutex_);
+                results_.clear();
+                loaded_ = true;
+        }
+
+private:
+        /// Number of threads in bundle.
+        static std::size_t size_(const bundle& b) { return b[0] * b[1] * b[2]; }
+
+        /// Check if bundle fits limits.
+        static bool fits_(const bundle& b, const bundle_limits& l)
+        {
+                return size_(b) <= l.max_size && b[0] <= l.max_extent[0] &&
+                        b[1] <= l.max_extent[1] && b[2] <= l.max_extent[2];
+        }
+
+        /// Key of result.
+        static std::string key_(
+                const bundle_limits& l, kernel& k, const mesh& m)
+        {
+                std::ostringstream os;
+                os << l.device_name << "\t" << k.get_library_hash() << "\t"
+                   << k.get_name() << "\t" << m[0] << " " << m[1] << " "
+                   << m[2];
+                return os.str();
+        }
+
+        /// Read results from file once (caller holds mutex_).
+        void load_()
+        {
+                if (loaded_)
+                {
+                        return;
+                }
+                loaded_ = true;
+                if (file_.empty())
+                {
+                        return;
+                }
+                std::ifstream in(file_);
+                std::string line;
+                while (std::getline(in, line))
+                {
+                        // Line is key, tab, bundle.
+                        auto pos = line.rfind('\t');
+                        if (pos == std::string::npos)
+                        {
+                                continue;
+                        }
+                        std::istringstream is(line.substr(pos + 1));
+                        bundle b;
+                        if (is >> b[0] >> b[1] >> b[2])
+                        {
+                                results_[line.substr(0, pos)] = b;
+                        }
+                }
+        }
+
+        /// Write results to file (caller holds mutex_).
+        void save_()
+        {
+                namespace fs = boost::filesystem;
+                if (file_.empty())
+                {
+                        return;
+                }
+                // Write to unique temporary file, then rename into place.
+                fs::path p(file_);
+                auto tmp = p.parent_path() /
+                        fs::unique_path(p.filename().string() +
+                                ".%%%%-%%%%-%%%%.tmp");
+                {
+                        std::ofstream out(tmp.string());
+                        for (const auto& r : results_)
+                        {
+                                out << r.first << "\t" << r.second[0] << " "
+                                    << r.second[1] << " " << r.second[2]
+                                    << "\n";
+                        }
+                        out.close();
+                        boost::system::error_code ec;
+                        if (!out)
+                        {
+                                fs::remove(tmp, ec);
+                                return;
+                        }
+                        fs::rename(tmp, p, ec);
+                        if (ec)
+                        {
+                                fs::remove(tmp, ec);
+                        }
+                }
+        }
+
+        /// Mutex protecting results.
+        mutable std::mutex mutex_;
+
+        /// Result file.
+        std::string file_;
+
+        /// Flag if file was read.
+        bool loaded_;
+
+        /// Bundle per device, library, kernel and mesh.
+        std::map<std::string, bundle> results_;
+};
+
+/// invoke kernel without args using the tuned bundle, mesh is the number of
+/// all threads
+inline void invoke(kernel& k, const mesh& m, const auto_bundle_t&, feed& f)
+{
+        auto b = bundle_tuner::instance().get(k, m, f.get_device());
+        invoke(k, m, b, f, mesh_definition::all_threads);
+}
+
+/// invoke kernel with args using the tuned bundle, mesh is the number of
+/// all threads
+template <typename... Targs>
+inline void invoke(kernel& k, const mesh& m, const auto_bundle_t&,
+        const base::args_t<Targs...>&& a, feed& f)
+{
+        auto b = bundle_tuner::instance().get(k, m, f.get_device());
+        invoke(k, m, b, std::move(a), f, mesh_definition::all_threads);
+}
+
+} // namespace aura
+} // namespace boost
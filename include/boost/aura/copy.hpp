@@ -2,6 +2,7 @@
 
 #include <boost/aura/device_array.hpp>
 #include <boost/aura/feed.hpp>
+#include <boost/aura/host_array.hpp>
 
 #if defined AURA_BASE_CUDA
 #include <boost/aura/base/cuda/copy.hpp>
@@ -120,7 +121,141 @@ void copy(const device_array<T, Allocator, BoundsType>& src,
         base::copy(src.begin(), src.end(), dst.begin(), f);
 }
 
+/// copy from pinned host array to device array (DMA)
+template <typename T,
+        typename HostBoundsType,
+        typename Allocator,
+        typename BoundsType
+>
+void copy(const host_array<T, HostBoundsType>& src,
+        device_array<T, Allocator, BoundsType>& dst,
+        feed& f
+)
+{
+        base::copy(src.begin(), src.end(), dst.begin(), f);
+}
+
+/// copy from pinned host array to device ptr (DMA)
+template <typename T, typename HostBoundsType>
+void copy(const host_array<T, HostBoundsType>& src,
+        const device_ptr<T>& dst,
+        feed& f
+)
+{
+        base::copy(src.begin(), src.end(), dst, f);
+}
+
+/// copy from device array to pinned host array (DMA)
+template <typename T,
+        typename Allocator,
+        typename BoundsType,
+        typename HostBoundsType
+>
+void copy(const device_array<T, Allocator, BoundsType>& src,
+        host_array<T, HostBoundsType>& dst,
+        feed& f
+)
+{
+        base::copy(src.begin(), src.end(), dst.begin(), f);
+}
+
+/// copy from device ptr to pinned host array (DMA)
+template <typename T, typename HostBoundsType>
+void copy(const device_ptr<T>& src,
+        host_array<T, HostBoundsType>& dst,
+        feed& f
+)
+{
+        base::copy(src, src + dst.size(), dst.begin(), f);
+}
+
+/// copy asynchronously to device array from an iterator,
+/// returns event that completes with the copy
+template <typename Iterator,
+        typename T,
+        typename Allocator,
+        typename BoundsType
+>
+base::event copy_async(Iterator src,
+        device_array<T, Allocator, BoundsType>& dst,
+        base::feed& f
+)
+{
+        typedef typename std::iterator_traits<Iterator>::value_type T2;
+        static_assert(std::is_same<T, T2>::value,
+                "iterator value type and device_array type must match");
+        return base::copy_async(&(*src), &(*src) + dst.size(), dst.begin(), f);
+}
+
+/// copy asynchronously from std::vector to device array
+template <typename T,
+        typename Allocator,
+        typename BoundsType
+>
+base::event copy_async(const std::vector<T>& src,
+        device_array<T, Allocator, BoundsType>& dst,
+        feed& f
+)
+{
+        return base::copy_async(src.begin(), src.end(), dst.begin(), f);
+}
+
+/// copy asynchronously from device array to std::vector
+template <typename T,
+        typename Allocator,
+        typename BoundsType
+>
+base::event copy_async(const device_array<T, Allocator, BoundsType>& src,
+        std::vector<T>& dst,
+        feed& f
+)
+{
+        return base::copy_async(src.begin(), src.end(), &dst[0], f);
+}
+
+/// copy asynchronously from device array to device array
+template <typename T,
+        typename Allocator,
+        typename BoundsType
+>
+base::event copy_async(const device_array<T, Allocator, BoundsType>& src,
+        device_array<T, Allocator, BoundsType>& dst,
+        feed& f
+)
+{
+        return base::copy_async(src.begin(), src.end(), dst.begin(), f);
+}
+
+/// copy asynchronously from pinned host array to device array (DMA)
+template <typename T,
+        typename HostBoundsType,
+        typename Allocator,
+        typename BoundsType
+>
+base::event copy_async(const host_array<T, HostBoundsType>& src,
+        device_array<T, Allocator, BoundsType>& dst,
+        feed& f
+)
+{
+        return base::copy_async(src.begin(), src.end(), dst.begin(), f);
+}
+
+/// copy asynchronously from device array to pinned host array (DMA)
+template <typename T,
+        typename Allocator,
+        typename BoundsType,
+        typename HostBoundsType
+>
+base::event copy_async(const device_array<T, Allocator, BoundsType>& src,
+        host_array<T, HostBoundsType>& dst,
+        feed& f
+)
+{
+        return base::copy_async(src.begin(), src.end(), dst.begin(), f);
+}
+
 using base::copy;
+using base::copy_async;
 
 } // namespace aura
 } // namespace boost
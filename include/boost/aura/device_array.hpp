@@ -6,7 +6,14 @@
 #include <boost/aura/device_ptr.hpp>
 #include <boost/aura/feed.hpp>
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace boost
 {
@@ -39,7 +46,7 @@ public:
                 {
                         device_free(*p);
                 }
-                free(p);
+                delete p;
         }
 
 private:
@@ -145,6 +152,36 @@ public:
                         >(*this, f, mat);
         }
 
+        /// Map count elements starting at offset.
+        /// @param track_dirty Write back modified pages only.
+        mapped_device_memory<T, Allocator, BoundsType> map(std::size_t offset,
+                std::size_t count, feed& f,
+                memory_access_tag mat = memory_access_tag::rw,
+                bool track_dirty = false)
+        {
+                return mapped_device_memory<
+                                T, Allocator, BoundsType
+                        >(*this, offset, count, f, mat, track_dirty);
+        }
+
+        /// Map multiple ranges (offset, count).
+        std::vector<mapped_device_memory<T, Allocator, BoundsType>> map(
+                const std::vector<std::pair<std::size_t, std::size_t>>& ranges,
+                feed& f,
+                memory_access_tag mat = memory_access_tag::rw,
+                bool track_dirty = false)
+        {
+                std::vector<mapped_device_memory<T, Allocator, BoundsType>>
+                        maps;
+                maps.reserve(ranges.size());
+                for (const auto& range : ranges)
+                {
+                        maps.emplace_back(*this, range.first, range.second, f,
+                                mat, track_dirty);
+                }
+                return maps;
+        }
+
         /// Resize vector (optionally disallow shrinking).
         void resize(std::size_t size, device& d, bool shrink=true)
         {
@@ -297,6 +334,12 @@ private:
 };
 
 /// Device memory mapped to the host.
+/// Maps the whole array or a range of it. With dirty tracking, read-write
+/// memory that is not aliased by the host is written back per modified
+/// page instead of as a whole. Pages are compared with a copy taken at map
+/// time, so the host copy is held twice while mapped. Write-only maps start
+/// with uninitialized host memory and are always written back as a whole.
+/// Mapping waits for the feed, so it is rejected while the feed captures.
 template <typename T,
         typename Allocator = device_allocator<T>,
         typename BoundsType = bounds
@@ -309,6 +352,9 @@ public:
         typedef const T* const_iterator;
         typedef T value_type;
 
+        /// Granularity of dirty tracking (bytes).
+        static constexpr std::size_t page_size = 4096;
+
         // Prevent copies
         mapped_device_memory(const mapped_device_memory&) = delete;
         void operator=(const mapped_device_memory&) = delete;
@@ -317,59 +363,165 @@ public:
         mapped_device_memory(device_array<T, Allocator, BoundsType>& da,
                 feed& f,
                 memory_access_tag mat)
+                : mapped_device_memory(da, 0, da.size(), f, mat, false)
+        {}
+
+        /// Map count elements starting at offset.
+        /// @param track_dirty Write back modified pages only.
+        mapped_device_memory(device_array<T, Allocator, BoundsType>& da,
+                std::size_t offset,
+                std::size_t count,
+                feed& f,
+                memory_access_tag mat,
+                bool track_dirty)
                 : array_(da)
+                , offset_(offset)
+                , count_(count)
                 , feed_(f)
                 , memory_access_tag_(mat)
         {
+                assert(offset_ + count_ <= array_.size());
+                if (f.get_capture() != nullptr)
+                {
+                        throw std::string("can not map memory while feed is "
+                                          "capturing");
+                }
+                auto first = array_.begin() + offset_;
                 // If memory is shared, get the host ptr and store it.
                 if (array_.is_shared_memory())
                 {
-                        host_data_ = array_.get_safe_host_ptr();
+                        host_data_ = std::shared_ptr<T>(
+                                array_.get_safe_host_ptr(),
+                                array_.get_host_ptr() + offset_);
+                        return;
                 }
-                else
+                // Dirty tracking only pays off if mapping copies.
+                if (!track_dirty ||
+                        first.get_device().supports_zero_copy_map())
                 {
-                        allocate(array_.size());
-                        // If read or read-write, copy data to host.
-                        if (memory_access_tag_ == memory_access_tag::rw ||
-                                memory_access_tag_ == memory_access_tag::ro)
+                        if (T* host_ptr = device_map(first, count_,
+                                        memory_access_tag_, feed_))
                         {
-                                copy(array_, host_data_.get(), feed_);
-                                feed_.synchronize();
+                                // Memory is unmapped by destructor.
+                                host_data_ = std::shared_ptr<T>(
+                                        host_ptr, [](T*) {});
+                                is_mapped_ = true;
+                                return;
                         }
                 }
+                allocate(count_);
+                // If read or read-write, copy data to host.
+                if (memory_access_tag_ == memory_access_tag::rw ||
+                        memory_access_tag_ == memory_access_tag::ro)
+                {
+                        copy(first, first + count_, host_data_.get(), feed_);
+                        feed_.synchronize();
+                }
+                if (track_dirty && memory_access_tag_ == memory_access_tag::rw)
+                {
+                        auto data = reinterpret_cast<const unsigned char*>(
+                                host_data_.get());
+                        snapshot_.assign(data, data + count_ * sizeof(T));
+                }
         }
 
         mapped_device_memory(mapped_device_memory&& other)
                 : array_(other.array_)
-                , host_data_(other.host_data_)
+                , offset_(other.offset_)
+                , count_(other.count_)
+                , host_data_(std::move(other.host_data_))
                 , feed_(other.feed_)
                 , memory_access_tag_(other.memory_access_tag_)
-        {}
+                , is_mapped_(other.is_mapped_)
+                , snapshot_(std::move(other.snapshot_))
+        {
+                other.host_data_.reset();
+        }
 
         /// destroy object
         ~mapped_device_memory()
         {
+                if (!host_data_ || array_.is_shared_memory())
+                {
+                        // Moved from or nothing to write back.
+                        return;
+                }
+                auto first = array_.begin() + offset_;
+                if (is_mapped_)
+                {
+                        device_unmap(first, host_data_.get(), feed_);
+                        feed_.synchronize();
+                        return;
+                }
                 // Copy memory back if write, read-write.
-                if (memory_access_tag_ == memory_access_tag::rw ||
-                        memory_access_tag_ == memory_access_tag::wo)
+                if (memory_access_tag_ == memory_access_tag::ro)
+                {
+                        return;
+                }
+                if (snapshot_.empty())
+                {
+                        copy(host_data_.get(), host_data_.get() + count_,
+                                first, feed_);
+                        feed_.synchronize();
+                        return;
+                }
+                // Write back runs of modified pages.
+                auto page_elements = get_page_elements_();
+                auto num_pages = (count_ + page_elements - 1) / page_elements;
+                bool written = false;
+                for (std::size_t i = 0; i < num_pages;)
+                {
+                        if (!is_page_dirty_(i))
+                        {
+                                i++;
+                                continue;
+                        }
+                        auto j = i;
+                        while (j < num_pages && is_page_dirty_(j))
+                        {
+                                j++;
+                        }
+                        auto begin = i * page_elements;
+                        auto end = std::min(j * page_elements, count_);
+                        copy(host_data_.get() + begin, host_data_.get() + end,
+                                first + begin, feed_);
+                        written = true;
+                        i = j;
+                }
+                if (written)
                 {
-                        copy(host_data_.get(), array_, feed_);
                         feed_.synchronize();
                 }
         }
 
         /// Access bounds and size
-        BoundsType bounds() const { return array_.bounds_; }
+        BoundsType bounds() const
+        {
+                if (offset_ == 0 && count_ == array_.size())
+                {
+                        return array_.bounds();
+                }
+                return BoundsType({count_});
+        }
 
-        std::size_t size() const { return product(array_.bounds_); }
+        std::size_t size() const { return count_; }
+
+        /// Query if the host data aliases device memory (no copies).
+        bool is_zero_copy() const
+        {
+                return array_.is_shared_memory() ||
+                        (is_mapped_ &&
+                                array_.begin().get_device()
+                                        .supports_zero_copy_map());
+        }
 
         /// Begin
         iterator begin() { return host_data_.get(); }
-        const_iterator begin() const { return *host_data_.get(); }
+        const_iterator begin() const { return host_data_.get(); }
 
         /// End
-        iterator end() { return host_data_.get() + array_.size(); }
-        const_iterator end() const { return host_data_.get() + array_.size(); }
+        iterator end() { return host_data_.get() + count_; }
+        const_iterator end() const { return host_data_.get() + count_; }
 
 private:
         /// Allocate (if no direct access is possible).
@@ -387,9 +539,31 @@ private:
                 );
         }
 
+        /// Number of elements per page.
+        static std::size_t get_page_elements_()
+        {
+                return std::max<std::size_t>(page_size / sizeof(T), 1);
+        }
+
+        /// Compare page i of the host data with the snapshot.
+        bool is_page_dirty_(std::size_t i) const
+        {
+                auto page_bytes = get_page_elements_() * sizeof(T);
+                auto begin = i * page_bytes;
+                auto end = std::min(begin + page_bytes, snapshot_.size());
+                auto data = reinterpret_cast<const unsigned char*>(
+                        host_data_.get());
+                return std::memcmp(data + begin, snapshot_.data() + begin,
+                               end - begin) != 0;
+        }
+
         /// Device array (stored so we can copy data back).
         device_array<T, Allocator, BoundsType>& array_;
 
+        /// Mapped range.
+        std::size_t offset_;
+        std::size_t count_;
+
         /// Mapped data (either a copy or directly mapped).
         std::shared_ptr<T> host_data_;
 
@@ -398,8 +572,13 @@ private:
 
         /// Used to avoid copy operations if they are not necessary.
         memory_access_tag memory_access_tag_;
-};
 
+        /// Host data is mapped by the base (no shadow copy).
+        bool is_mapped_ { false };
+
+        /// Host data at map time (empty if dirty tracking is off).
+        std::vector<unsigned char> snapshot_;
+};
 
 } // namespace aura
 } // namespace boost
@@ -4,8 +4,16 @@
 
 #include <boost/aura/device.hpp>
 #include <boost/aura/device_ptr.hpp>
+#include <boost/aura/event.hpp>
+#include <boost/aura/feed.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <list>
+#include <memory>
 #include <mutex>
+#include <set>
 #include <unordered_map>
 #include <vector>
 
@@ -14,24 +22,90 @@ namespace boost
 namespace aura
 {
 
+/// Statistics of a device_pool_allocator.
+struct device_pool_allocator_statistics
+{
+        /// Allocations served from existing slabs.
+        std::size_t hits { 0 };
+
+        /// Allocations served from thread caches (without locking).
+        std::size_t thread_cache_hits { 0 };
+
+        /// Allocations that required a new slab.
+        std::size_t misses { 0 };
+
+        /// Number of slabs held.
+        std::size_t slabs { 0 };
+
+        /// Bytes held in slabs.
+        std::size_t reserved_bytes { 0 };
+
+        /// Bytes of blocks handed out to users.
+        std::size_t in_use_bytes { 0 };
+
+        /// Bytes requested by users.
+        std::size_t requested_bytes { 0 };
+
+        /// Largest block that can be handed out without a new slab.
+        std::size_t largest_free_block { 0 };
+
+        /// Fraction of allocations served without a new slab.
+        double hit_rate() const
+        {
+                auto total = thread_cache_hits + hits + misses;
+                return total == 0
+                        ? 0.
+                        : static_cast<double>(thread_cache_hits + hits) /
+                                total;
+        }
+
+        /// Fraction of in-use bytes lost to rounding to size classes.
+        double internal_fragmentation() const
+        {
+                return in_use_bytes == 0
+                        ? 0.
+                        : 1. - static_cast<double>(requested_bytes) /
+                                in_use_bytes;
+        }
+
+        /// Fraction of free bytes not available as largest block.
+        double external_fragmentation() const
+        {
+                auto free_bytes = reserved_bytes - in_use_bytes;
+                return free_bytes == 0
+                        ? 0.
+                        : 1. - static_cast<double>(largest_free_block) /
+                                free_bytes;
+        }
+};
+
 /// device_pool_allocator
-/// There is not really a pool in this allocator.
-/// This is more of a memoization: if a user
-/// alloc(1024), free(1024) and alloc(1024)
-/// the second alloc will just return the freed memory from before
-/// (it is not really freed). The allocator memoizes up to a limit;
-/// if the limit is hit it starts evicting/puring memory.
+/// Size-class allocator that carves regions out of large slabs of device
+/// memory. Requests are rounded up to power-of-two blocks; each slab is a
+/// buddy system, so a block is split on allocation and merged with its
+/// buddy on deallocation. A request for 1025 elements after freeing 1024
+/// elements is served from the slab without calling into the driver.
 ///
 /// In real-time pipelines allocation sizes are typically very similar
 /// (low to no variance) so this allocator should give a speed-up as
-/// subsequent alloc calls are cached.
+/// subsequent alloc calls are served from slabs.
+///
+/// Regions are created with device_region (sub-buffers in OpenCL, pointer
+/// arithmetic in CUDA) and can be used like any other allocation. The
+/// allocator holds slabs up to a limit; if the limit is hit it releases
+/// empty slabs.
+///
+/// Each thread keeps bounded magazines of freed blocks per size class in
+/// front of the slabs (the depot). Allocating a recently freed size on the
+/// same thread does not lock; empty magazines are refilled from and full
+/// magazines are flushed to the depot in batches. Blocks held in magazines
+/// count as in use.
 ///
-/// The allocator stores a multimapmap<size, vector<ptr>> for free memory
-/// blocks size can be looked up and the pointer can be looked up immediately.
-/// It can store multiple pointers for a specific size because there might be
-/// identical. It stores a multimap<pointer, size_t> for in-use memory so
-/// pointers can be looked up quickly when deallocation should occur and move
-/// the pointer over to the free map.
+/// Blocks can also be freed in feed order: deallocate(p, n, f) records an
+/// event in f instead of waiting for the feed. allocate(n, f) reuses such
+/// blocks immediately for work on the same feed; for other feeds they
+/// become available once the event has completed. Reused blocks keep their
+/// buffer, so out-of-order feeds order them like any other buffer.
 /// @tparam T Type the allocator allocates.
 template <class T>
 struct device_pool_allocator
@@ -47,75 +121,141 @@ struct device_pool_allocator
         /// Construct allocator.
         /// @param d Device.
         /// @param max_elements Maximum number of elements this pool can hold.
+        /// @param slab_elements Number of elements per slab (rounded up to a
+        /// power of two bytes, limited by max_elements).
+        /// @param magazine_size Blocks per size class cached by each thread
+        /// (0 disables thread caches).
         device_pool_allocator(device& d,
-                const std::size_t& max_elements = 10 * 1024 * 1024 / sizeof(T))
+                const std::size_t& max_elements = 10 * 1024 * 1024 / sizeof(T),
+                const std::size_t& slab_elements = 4 * 1024 * 1024 / sizeof(T),
+                const std::size_t& magazine_size = 16)
                 : device_(&d)
+                , initialized_(true)
                 , max_elements_(max_elements)
-        {}
+                , magazine_size_(magazine_size)
+                , id_(next_id_())
+                , owner_(std::make_shared<owner_t>(this))
+        {
+                min_block_ = next_pow2_(std::max<std::size_t>(
+                        device_region_alignment(d), 256));
+                slab_bytes_ = std::max(min_block_,
+                        std::min(next_pow2_(slab_elements * sizeof(T)),
+                                next_pow2_(max_elements * sizeof(T))));
+        }
 
         /// Move construct allocator.
-        template <class U>
-        device_pool_allocator(device_pool_allocator<U>&& other)
+        device_pool_allocator(device_pool_allocator&& other)
         {
-                std::lock(mutex_, other.mutex_);
-                std::lock_guard<std::mutex> guard0(
-                        mutex_, std::adopt_lock
-                );
-                std::lock_guard<std::mutex> guard1(
-                        other.mutex_, std::adopt_lock
-                );
+                // Thread caches lock owner before allocator, owner is held
+                // until the move is done.
+                std::unique_lock<std::mutex> owner_lock;
+                if (other.owner_)
+                {
+                        owner_lock = std::unique_lock<std::mutex>(
+                                other.owner_->mutex);
+                        other.owner_->allocator = this;
+                }
+                std::lock_guard<std::mutex> guard(other.mutex_);
 
                 device_ = other.device_;
-                max_elements_ = other.max_elements;
                 initialized_ = other.initialized_;
-                num_elements_ = other.num_elements_;
-                available_memory_ = other.available_memory_;
-                in_use_memory_ = other.in_use_memory_;
+                max_elements_ = other.max_elements_;
+                min_block_ = other.min_block_;
+                slab_bytes_ = other.slab_bytes_;
+                magazine_size_ = other.magazine_size_;
+                slabs_ = std::move(other.slabs_);
+                in_use_memory_ = std::move(other.in_use_memory_);
+                pending_ = std::move(other.pending_);
+                pending_count_ = other.pending_count_.load();
+                statistics_ = other.statistics_;
+                thread_cache_hits_ = other.thread_cache_hits_.load();
+                requested_bytes_ = other.requested_bytes_.exchange(0);
+
+                // Thread caches of other now belong to this allocator.
+                id_ = other.id_;
+                owner_ = std::move(other.owner_);
 
                 other.device_ = nullptr;
                 other.initialized_ = false;
-                other.num_elements = 0;
-                other.available_memory_.clear();
+                other.slabs_.clear();
                 other.in_use_memory_.clear();
+                other.pending_.clear();
+                other.pending_count_ = 0;
+                other.statistics_ = device_pool_allocator_statistics();
         }
 
         ~device_pool_allocator()
         {
+                if (owner_)
+                {
+                        // Thread caches no longer flush to this allocator.
+                        std::lock_guard<std::mutex> owner_guard(
+                                owner_->mutex);
+                        owner_->allocator = nullptr;
+                }
                 std::lock_guard<std::mutex> guard(mutex_);
 
+                // Feeds might still use blocks that were freed in feed order.
+                for (auto& pending : pending_)
+                {
+                        pending.e.synchronize();
+                }
+                pending_.clear();
+                purge_in_use_memory_();
                 // Allow no elements in the object and purge.
-                max_elements_= 0;
+                max_elements_ = 0;
                 purge_();
-                purge_in_use_memory_();
         }
 
         /// Allocate memory.
         pointer allocate(std::size_t n)
         {
-                std::lock_guard<std::mutex> guard(mutex_);
                 assert(device_);
-                assert(n < max_elements_);
-                pointer ptr;
+                auto bytes = std::max<std::size_t>(n * sizeof(T), 1);
+                auto order = order_(bytes);
+                requested_bytes_.fetch_add(bytes, std::memory_order_relaxed);
 
-                // Check if we have available memory of that size.
-                auto it = available_memory_.find(n);
+                thread_cache_t* cache = nullptr;
+                if (magazine_size_ > 0)
+                {
+                        cache = &get_thread_cache_();
+                        if (cache->magazines.size() <= order)
+                        {
+                                cache->magazines.resize(order + 1);
+                        }
+                        auto& magazine = cache->magazines[order];
+                        if (!magazine.empty())
+                        {
+                                auto ptr = magazine.back();
+                                magazine.pop_back();
+                                thread_cache_hits_.fetch_add(
+                                        1, std::memory_order_relaxed);
+                                return ptr;
+                        }
+                }
 
-                if (it != available_memory_.end())
+                std::lock_guard<std::mutex> guard(mutex_);
+                reclaim_pending_();
+                auto misses = statistics_.misses;
+                auto ptr = allocate_block_(order, true, cache);
+                if (statistics_.misses == misses)
                 {
-                        ptr = it->second;
-                        // Add to in_use.
-                        in_use_memory_[it->second] = it->first;
-                        available_memory_.erase(it);
+                        statistics_.hits++;
                 }
-                else
+
+                // Refill magazine with half a batch of free blocks.
+                if (cache)
                 {
-                        ptr = device_malloc<T>(n, *device_);
-                        num_elements_ += n;
-                        in_use_memory_[ptr] = n;
-                        if (num_elements_ >= max_elements_)
+                        auto& magazine = cache->magazines[order];
+                        while (magazine.size() < magazine_size_ / 2)
                         {
-                                assert(!available_memory_.empty());
-                                purge_();
+                                auto p = allocate_block_(
+                                        order, false, nullptr);
+                                if (p == nullptr)
+                                {
+                                        break;
+                                }
+                                magazine.push_back(p);
                         }
                 }
                 return ptr;
@@ -124,36 +264,425 @@ struct device_pool_allocator
         /// Deallocate memory.
         void deallocate(pointer& p, std::size_t n)
         {
+                assert(device_);
+                auto bytes = std::max<std::size_t>(n * sizeof(T), 1);
+                requested_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+                if (magazine_size_ > 0)
+                {
+                        auto order = order_(bytes);
+                        auto& cache = get_thread_cache_();
+                        if (cache.magazines.size() <= order)
+                        {
+                                cache.magazines.resize(order + 1);
+                        }
+                        auto& magazine = cache.magazines[order];
+                        if (magazine.size() >= magazine_size_)
+                        {
+                                // Flush half of the full magazine.
+                                std::lock_guard<std::mutex> guard(mutex_);
+                                while (magazine.size() > magazine_size_ / 2)
+                                {
+                                        deallocate_block_(magazine.back());
+                                        magazine.pop_back();
+                                }
+                        }
+                        magazine.push_back(p);
+                        p.reset();
+                        return;
+                }
+
                 std::lock_guard<std::mutex> guard(mutex_);
+                deallocate_block_(p);
+                p.reset();
+        }
+
+        /// Allocate memory for work on feed f.
+        /// Blocks freed in order of f are reused immediately.
+        pointer allocate(std::size_t n, feed& f)
+        {
+                if (pending_count_.load() > 0)
+                {
+                        auto bytes = std::max<std::size_t>(n * sizeof(T), 1);
+                        auto order = order_(bytes);
+                        std::lock_guard<std::mutex> guard(mutex_);
+                        for (auto it = pending_.begin(); it != pending_.end();
+                                ++it)
+                        {
+                                if (it->f == &f && it->order == order)
+                                {
+                                        auto ptr = it->ptr;
+                                        pending_.erase(it);
+                                        pending_count_--;
+                                        statistics_.hits++;
+                                        requested_bytes_.fetch_add(bytes,
+                                                std::memory_order_relaxed);
+                                        return ptr;
+                                }
+                        }
+                }
+                return allocate(n);
+        }
+
+        /// Deallocate memory that work in feed f might still use.
+        /// Does not wait for f: the block is reused immediately for work on
+        /// f and for other feeds once the work enqueued so far is done.
+        void deallocate(pointer& p, std::size_t n, feed& f)
+        {
                 assert(device_);
+                auto bytes = std::max<std::size_t>(n * sizeof(T), 1);
+                requested_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+                pending_t pending { p, order_(bytes), &f, event(f) };
+                std::lock_guard<std::mutex> guard(mutex_);
+                reclaim_pending_();
+                pending_.push_back(std::move(pending));
+                pending_count_++;
+                p.reset();
+        }
+
+        /// Return blocks cached by the calling thread to the depot.
+        void flush()
+        {
+                if (magazine_size_ == 0)
+                {
+                        return;
+                }
+                auto& cache = get_thread_cache_();
+                std::lock_guard<std::mutex> guard(mutex_);
+                flush_(cache);
+        }
+
+        /// Access allocation statistics.
+        device_pool_allocator_statistics get_statistics()
+        {
+                std::lock_guard<std::mutex> guard(mutex_);
+                auto statistics = statistics_;
+                statistics.thread_cache_hits = thread_cache_hits_.load();
+                statistics.requested_bytes = requested_bytes_.load();
+                statistics.slabs = slabs_.size();
+                for (const auto& slab : slabs_)
+                {
+                        for (std::size_t j = slab.free_blocks.size(); j > 0;
+                                j--)
+                        {
+                                if (!slab.free_blocks[j - 1].empty())
+                                {
+                                        statistics.largest_free_block =
+                                                std::max(statistics
+                                                        .largest_free_block,
+                                                        min_block_ << (j - 1));
+                                        break;
+                                }
+                        }
+                }
+                return statistics;
+        }
+
+private:
+        /// Slab of device memory that is split into blocks.
+        struct slab_t
+        {
+                /// Memory of slab.
+                pointer memory;
+
+                /// Offsets of free blocks, indexed by order.
+                std::vector<std::set<std::size_t>> free_blocks;
+        };
+
+        /// Block handed out to a user.
+        struct block_t
+        {
+                typename std::list<slab_t>::iterator slab;
+                std::size_t offset;
+                std::size_t order;
+        };
+
+        /// Block freed in feed order.
+        struct pending_t
+        {
+                pointer ptr;
+                std::size_t order;
+
+                /// Feed the block was freed on.
+                const feed* f;
+
+                /// Marks the end of the work that might use the block.
+                event e;
+        };
+
+        /// Allocator that thread caches flush to (nullptr once destroyed).
+        struct owner_t
+        {
+                explicit owner_t(device_pool_allocator* a)
+                        : allocator(a)
+                {
+                }
+
+                std::mutex mutex;
+                device_pool_allocator* allocator;
+        };
+
+        /// Magazines of one thread for one allocator.
+        struct thread_cache_t
+        {
+                /// Allocator the cached blocks belong to.
+                std::weak_ptr<owner_t> owner;
+
+                /// Cached blocks, indexed by order.
+                std::vector<std::vector<pointer>> magazines;
+        };
+
+        /// Thread caches of one thread, flushed when the thread exits.
+        struct thread_caches_t
+        {
+                ~thread_caches_t()
+                {
+                        for (auto& entry : caches)
+                        {
+                                auto owner = entry.second.owner.lock();
+                                if (!owner)
+                                {
+                                        continue;
+                                }
+                                std::lock_guard<std::mutex> owner_guard(
+                                        owner->mutex);
+                                if (owner->allocator)
+                                {
+                                        std::lock_guard<std::mutex> guard(
+                                                owner->allocator->mutex_);
+                                        owner->allocator->flush_(
+                                                entry.second);
+                                }
+                        }
+                }
+
+                /// Caches by allocator id.
+                std::unordered_map<std::size_t, thread_cache_t> caches;
+        };
+
+        /// Unique allocator id (ids are never reused).
+        static std::size_t next_id_()
+        {
+                static std::atomic<std::size_t> id(0);
+                return id++;
+        }
+
+        /// Access magazines of calling thread.
+        thread_cache_t& get_thread_cache_()
+        {
+                static thread_local thread_caches_t thread_caches;
+                auto it = thread_caches.caches.find(id_);
+                if (it != thread_caches.caches.end())
+                {
+                        return it->second;
+                }
+                // Drop caches of destroyed allocators.
+                for (auto c = thread_caches.caches.begin();
+                        c != thread_caches.caches.end();)
+                {
+                        if (c->second.owner.expired())
+                        {
+                                c = thread_caches.caches.erase(c);
+                        }
+                        else
+                        {
+                                ++c;
+                        }
+                }
+                auto& cache = thread_caches.caches[id_];
+                cache.owner = owner_;
+                return cache;
+        }
+
+        /// Return cached blocks to depot (mutex_ must be held).
+        void flush_(thread_cache_t& cache)
+        {
+                for (auto& magazine : cache.magazines)
+                {
+                        for (auto& p : magazine)
+                        {
+                                deallocate_block_(p);
+                        }
+                        magazine.clear();
+                }
+        }
+
+        /// Allocate block from depot (mutex_ must be held).
+        /// @param grow Allow new slabs, otherwise return nullptr if the
+        /// slabs are exhausted.
+        /// @param cache Magazines of the calling thread, returned to the
+        /// depot before a new slab is allocated.
+        pointer allocate_block_(
+                std::size_t order, bool grow, thread_cache_t* cache)
+        {
+                // Best fit: smallest free block that is large enough.
+                auto slab = slabs_.end();
+                std::size_t found = 0;
+                for (auto it = slabs_.begin(); it != slabs_.end(); ++it)
+                {
+                        for (std::size_t j = order;
+                                j < it->free_blocks.size() &&
+                                (slab == slabs_.end() || j < found);
+                                j++)
+                        {
+                                if (!it->free_blocks[j].empty())
+                                {
+                                        slab = it;
+                                        found = j;
+                                        break;
+                                }
+                        }
+                }
+
+                if (slab == slabs_.end() && !grow)
+                {
+                        return pointer();
+                }
+
+                if (slab == slabs_.end() && cache)
+                {
+                        flush_(*cache);
+                        return allocate_block_(order, grow, nullptr);
+                }
+
+                if (slab == slabs_.end())
+                {
+                        slab = create_slab_(
+                                std::max(slab_bytes_, min_block_ << order));
+                        found = slab->free_blocks.size() - 1;
+                        statistics_.misses++;
+                }
+
+                // Split block until it has the requested size.
+                auto& free_blocks = slab->free_blocks;
+                auto offset = *free_blocks[found].begin();
+                free_blocks[found].erase(free_blocks[found].begin());
+                while (found > order)
+                {
+                        found--;
+                        free_blocks[found].insert(
+                                offset + (min_block_ << found));
+                }
+
+                auto block_bytes = min_block_ << order;
+                pointer ptr = device_region(slab->memory, offset, block_bytes);
+                in_use_memory_[ptr] = block_t { slab, offset, order };
+                statistics_.in_use_bytes += block_bytes;
+
+                if (statistics_.reserved_bytes > max_elements_ * sizeof(T))
+                {
+                        purge_();
+                }
+                return ptr;
+        }
+
+        /// Return blocks whose feed work finished to depot (mutex_ must be
+        /// held).
+        void reclaim_pending_()
+        {
+                for (auto it = pending_.begin(); it != pending_.end();)
+                {
+                        if (!it->e.query())
+                        {
+                                ++it;
+                                continue;
+                        }
+                        deallocate_block_(it->ptr);
+                        it = pending_.erase(it);
+                        pending_count_--;
+                }
+        }
+
+        /// Return block to depot (mutex_ must be held).
+        void deallocate_block_(pointer& p)
+        {
                 auto it = in_use_memory_.find(p);
 
                 // in_use_memory_ must contain this pointer.
-                if (it != in_use_memory_.end())
+                if (it == in_use_memory_.end())
                 {
-                        assert(it->second == n);
-                        available_memory_.emplace(std::make_pair(n, it->first));
-                        in_use_memory_.erase(it);
+                        assert(false);
+                        return;
                 }
-                else
+                auto block = it->second;
+                pointer ptr = it->first;
+                in_use_memory_.erase(it);
+                device_region_free(ptr);
+                statistics_.in_use_bytes -= min_block_ << block.order;
+                release_block_(block);
+        }
+
+        /// Round up to power of two.
+        static std::size_t next_pow2_(std::size_t v)
+        {
+                std::size_t p = 1;
+                while (p < v)
                 {
-                        assert(false);
+                        p <<= 1;
                 }
-                p.reset();
+                return p;
         }
 
-private:
-        /// Method used to purge the allocator if it has grown too big.
+        /// Order of smallest block that holds bytes.
+        std::size_t order_(std::size_t bytes) const
+        {
+                std::size_t order = 0;
+                while ((min_block_ << order) < bytes)
+                {
+                        order++;
+                }
+                return order;
+        }
+
+        /// Allocate new slab that consists of a single free block.
+        typename std::list<slab_t>::iterator create_slab_(std::size_t bytes)
+        {
+                slab_t slab;
+                slab.memory = device_malloc<T>(
+                        (bytes + sizeof(T) - 1) / sizeof(T), *device_);
+                slab.free_blocks.resize(order_(bytes) + 1);
+                slab.free_blocks.back().insert(0);
+                statistics_.reserved_bytes += bytes;
+                return slabs_.insert(slabs_.end(), std::move(slab));
+        }
+
+        /// Return block to its slab and merge it with free buddies.
+        void release_block_(const block_t& block)
+        {
+                auto& free_blocks = block.slab->free_blocks;
+                auto offset = block.offset;
+                auto order = block.order;
+                while (order + 1 < free_blocks.size())
+                {
+                        auto buddy = offset ^ (min_block_ << order);
+                        auto it = free_blocks[order].find(buddy);
+                        if (it == free_blocks[order].end())
+                        {
+                                break;
+                        }
+                        free_blocks[order].erase(it);
+                        offset = std::min(offset, buddy);
+                        order++;
+                }
+                free_blocks[order].insert(offset);
+        }
+
+        /// Method used to release empty slabs if the allocator has grown too
+        /// big.
         void purge_()
         {
-                while (num_elements_ > max_elements_ &&
-                        !available_memory_.empty())
+                for (auto it = slabs_.begin(); it != slabs_.end() &&
+                        statistics_.reserved_bytes >
+                                max_elements_ * sizeof(T);)
                 {
-                        auto available_it = available_memory_.begin();
-                        auto ptr = available_it->second;
-                        num_elements_ -= available_it->first;
-                        available_memory_.erase(available_it);
-                        device_free(ptr);
+                        if (it->free_blocks.back().empty())
+                        {
+                                ++it;
+                                continue;
+                        }
+                        statistics_.reserved_bytes -=
+                                min_block_ << (it->free_blocks.size() - 1);
+                        device_free(it->memory);
+                        it = slabs_.erase(it);
                 }
         }
 
@@ -163,32 +692,62 @@ private:
                 for (auto memory : in_use_memory_)
                 {
                         auto ptr = memory.first;
-                        device_free(ptr);
+                        device_region_free(ptr);
+                        release_block_(memory.second);
                 }
                 in_use_memory_.clear();
+                statistics_.in_use_bytes = 0;
+                requested_bytes_ = 0;
         }
 
         /// Mutex used to allow multi-threaded access to class.
         std::mutex mutex_;
 
         /// Device we allocate memory from.
-        device* device_;
+        device* device_ { nullptr };
 
         /// Flag that indicates if allocator is initialized or not.
         bool initialized_ { false };
 
         /// Maximum number of elements this allocator should hold.
-        std::size_t max_elements_;
+        std::size_t max_elements_ { 0 };
+
+        /// Size of smallest block (bytes).
+        std::size_t min_block_ { 1 };
+
+        /// Size of a regular slab (bytes), larger requests get own slabs.
+        std::size_t slab_bytes_ { 1 };
+
+        /// Blocks per size class cached by each thread.
+        std::size_t magazine_size_ { 0 };
 
-        /// Num elements held
-        std::size_t num_elements_ = { 0 };
+        /// Id that identifies thread caches of this allocator.
+        std::size_t id_ { 0 };
 
-        /// List of free storage elements.
-        std::unordered_multimap<std::size_t, pointer>
-        available_memory_;
+        /// Handle that thread caches use to reach this allocator.
+        std::shared_ptr<owner_t> owner_;
+
+        /// Allocations served from thread caches.
+        std::atomic<std::size_t> thread_cache_hits_ { 0 };
+
+        /// Bytes requested by users, counted in allocate and deallocate
+        /// since blocks in thread caches pass without locking.
+        std::atomic<std::size_t> requested_bytes_ { 0 };
+
+        /// Slabs held by the allocator.
+        std::list<slab_t> slabs_;
 
         /// List of in-use storage elements.
-        std::unordered_map<pointer, std::size_t> in_use_memory_;
+        std::unordered_map<pointer, block_t> in_use_memory_;
+
+        /// Blocks freed in feed order, not yet returned to the depot.
+        std::list<pending_t> pending_;
+
+        /// Number of blocks in pending_ (read without locking).
+        std::atomic<std::size_t> pending_count_ { 0 };
+
+        /// Allocation statistics.
+        device_pool_allocator_statistics statistics_;
 };
 
 } // namespace aura
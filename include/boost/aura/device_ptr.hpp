@@ -26,6 +26,11 @@ namespace base = base_detail::metal;
 using base::device_ptr;
 using base::device_malloc;
 using base::device_free;
+using base::device_map;
+using base::device_unmap;
+using base::device_region;
+using base::device_region_alignment;
+using base::device_region_free;
 
 
 } // namespace aura
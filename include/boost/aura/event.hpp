@@ -0,0 +1,34 @@
+#pragma once
+
+#if defined AURA_BASE_CUDA
+#include <boost/aura/base/cuda/event.hpp>
+#elif defined AURA_BASE_OPENCL
+#include <boost/aura/base/opencl/event.hpp>
+#elif defined AURA_BASE_METAL
+#include <boost/aura/base/metal/event.hpp>
+#endif
+
+namespace boost
+{
+namespace aura
+{
+
+#if defined AURA_BASE_CUDA
+namespace base = base_detail::cuda;
+#elif defined AURA_BASE_OPENCL
+namespace base = base_detail::opencl;
+#elif defined AURA_BASE_METAL
+namespace base = base_detail::metal;
+#endif
+
+using base::event;
+
+/**
+ * @brief wait for all operations before an event to finish
+ *
+ * @param e the event to wait for
+ */
+inline void wait_for(event& e) { e.synchronize(); }
+
+} // namespace aura
+} // namespace boost
@@ -8,6 +8,9 @@
 #include <boost/aura/base/metal/feed.hpp>
 #endif
 
+#include <boost/aura/event.hpp>
+#include <boost/aura/graph.hpp>
+
 namespace boost
 {
 namespace aura
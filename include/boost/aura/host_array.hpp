@@ -0,0 +1,128 @@
+#pragma once
+
+#include <boost/aura/bounds.hpp>
+#include <boost/aura/device.hpp>
+#include <boost/aura/pinned_host_allocator.hpp>
+
+#include <initializer_list>
+#include <memory>
+
+namespace boost
+{
+namespace aura
+{
+
+/// Host array in pinned memory, can have multiple dimensions.
+/// Use as source or destination of copy operations to transfer data
+/// without a staging copy by the driver.
+template <typename T, typename BoundsType = bounds>
+class host_array
+{
+public:
+        /// Convenience types
+        typedef T* iterator;
+        typedef const T* const_iterator;
+        typedef T value_type;
+
+        // Prevent copies
+        host_array(const host_array&) = delete;
+        void operator=(const host_array&) = delete;
+
+        /// Create empty array
+        host_array() {}
+
+        /// Create one-dimensional array of size, pinned for device
+        host_array(std::size_t size, device& d)
+                : bounds_({size})
+        {
+                allocate(size, d);
+        }
+
+        /// Create multi-dimensional array of bound size b, pinned for device
+        host_array(const BoundsType& b, device& d)
+                : bounds_(b)
+        {
+                allocate(product(b), d);
+        }
+
+        /// Create multi-dimensional array from initializer list.
+        host_array(
+                const std::initializer_list<
+                        typename BoundsType::value_type
+                >& dimensions,
+                device& d)
+                : bounds_(dimensions)
+        {
+                allocate(product(bounds_), d);
+        }
+
+        /// move constructor, move host_array here, invalidate other
+        host_array(host_array&& ha)
+                : bounds_(std::move(ha.bounds_))
+                , data_(std::move(ha.data_))
+        {
+                ha.bounds_.clear();
+        }
+
+        /// move assignment, move host_array here, invalidate other
+        host_array& operator=(host_array&& ha)
+        {
+                bounds_ = ha.bounds_;
+                data_ = std::move(ha.data_);
+                ha.bounds_.clear();
+                return *this;
+        }
+
+        /// Access bounds and size
+        BoundsType bounds() const { return bounds_; }
+
+        std::size_t size() const { return product(bounds_); }
+
+        /// Begin
+        iterator begin() { return data_.get(); }
+        const_iterator begin() const { return data_.get(); }
+
+        /// End
+        iterator end() { return data_.get() + size(); }
+        const_iterator end() const { return data_.get() + size(); }
+
+        /// Access data
+        T* data() { return data_.get(); }
+        const T* data() const { return data_.get(); }
+
+        /// Access element
+        T& operator[](std::size_t i) { return data_.get()[i]; }
+        const T& operator[](std::size_t i) const { return data_.get()[i]; }
+
+private:
+        /// Deleter, returns memory to allocator.
+        struct deleter_t
+        {
+                void operator()(T* p)
+                {
+                        allocator->deallocate(p, size);
+                }
+
+                std::shared_ptr<pinned_host_allocator<T>> allocator;
+                std::size_t size;
+        };
+
+        /// Allocation helper function
+        void allocate(std::size_t size, device& d)
+        {
+                auto allocator =
+                        std::make_shared<pinned_host_allocator<T>>(d);
+                data_ = std::unique_ptr<T, deleter_t>(
+                        allocator->allocate(size),
+                        deleter_t { allocator, size });
+        }
+
+        /// Stores the bounds
+        BoundsType bounds_;
+
+        /// Holds data
+        std::unique_ptr<T, deleter_t> data_;
+};
+
+} // namespace aura
+} // namespace boost
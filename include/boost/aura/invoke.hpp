@@ -11,6 +11,8 @@
 #include <boost/aura/base/metal/invoke.hpp>
 #endif
 
+#include <vector>
+
 namespace boost
 {
 namespace aura
@@ -57,7 +59,7 @@ MeshType normalize_mesh(MeshType mesh, BundleType bundle,
 
 /// Pack arguments
 template <typename... Targs>
-auto args(const Targs... ar) -> base::args_t<sizeof...(Targs)>
+auto args(const Targs... ar) -> base::args_t<Targs...>
 {
         return base::args_impl(ar...);
 }
@@ -68,19 +70,30 @@ inline void invoke(kernel& k, const MeshType& m, const BundleType& b, feed& f,
         mesh_definition mesh_def = mesh_definition::mesh_size)
 {
         auto normalized_mesh = normalize_mesh(m, b, mesh_def);
-        base::detail::invoke_impl(k, normalize_mesh, b, base::args_t<0>(), f);
+        base::detail::invoke_impl(k, normalized_mesh, b, base::args_t<>(), f);
 }
 
 /// invoke kernel with args
-template <unsigned long N, typename MeshType, typename BundleType>
+template <typename MeshType, typename BundleType, typename... Targs>
 inline void invoke(kernel& k, const MeshType& m, const BundleType& b,
-        const base::args_t<N>&& a, feed& f,
+        const base::args_t<Targs...>&& a, feed& f,
         mesh_definition mesh_def = mesh_definition::mesh_size)
 {
         auto normalized_mesh = normalize_mesh(m, b, mesh_def);
         base::detail::invoke_impl(k, normalized_mesh, b, std::move(a), f);
 }
 
+/// invoke kernel once for each argument pack, all launches use the same
+/// mesh and bundle
+template <typename MeshType, typename BundleType, typename... Targs>
+inline void invoke_many(kernel& k, const MeshType& m, const BundleType& b,
+        const std::vector<base::args_t<Targs...>>& packs, feed& f,
+        mesh_definition mesh_def = mesh_definition::mesh_size)
+{
+        auto normalized_mesh = normalize_mesh(m, b, mesh_def);
+        base::detail::invoke_many_impl(k, normalized_mesh, b, packs, f);
+}
+
 
 } // namespace aura
 } // namespace boost
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <boost/aura/feed.hpp>
+#include <boost/aura/invoke.hpp>
+#include <boost/aura/kernel.hpp>
+
+#if defined AURA_BASE_CUDA
+#include <boost/aura/base/cuda/launch_plan.hpp>
+#elif defined AURA_BASE_OPENCL
+#include <boost/aura/base/opencl/launch_plan.hpp>
+#elif defined AURA_BASE_METAL
+#include <boost/aura/base/metal/launch_plan.hpp>
+#endif
+
+namespace boost
+{
+namespace aura
+{
+
+#if defined AURA_BASE_CUDA
+namespace base = base_detail::cuda;
+#elif defined AURA_BASE_OPENCL
+namespace base = base_detail::opencl;
+#elif defined AURA_BASE_METAL
+namespace base = base_detail::metal;
+#endif
+
+using base::launch_plan;
+
+/// Prepare kernel launch that is enqueued many times, e.g.
+/// auto plan = make_launch_plan(k, m, b, args(ptr, 0.0f));
+/// plan.set_arg<1>(1.0f);
+/// plan.enqueue(f);
+template <typename MeshType, typename BundleType, typename... Targs>
+base::launch_plan<Targs...> make_launch_plan(kernel& k, const MeshType& m,
+        const BundleType& b, base::args_t<Targs...>&& a,
+        mesh_definition mesh_def = mesh_definition::mesh_size)
+{
+        auto normalized_mesh = normalize_mesh(m, b, mesh_def);
+        return base::launch_plan<Targs...>(
+                k, normalized_mesh, b, std::move(a));
+}
+
+} // namespace aura
+} // namespace boost
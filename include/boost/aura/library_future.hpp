@@ -0,0 +1,112 @@
+#pragma once
+
+#include <boost/aura/base/deferred_build.hpp>
+#include <boost/aura/base/worker_pool.hpp>
+#include <boost/aura/device.hpp>
+#include <boost/aura/io.hpp>
+#include <boost/aura/library.hpp>
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+
+namespace boost
+{
+namespace aura
+{
+
+/// Handle to a library that is built in the background.
+///
+/// Libraries are created on the worker pool and, where the base supports
+/// it, compiled by the driver asynchronously. The handle blocks only when it
+/// is resolved with get(), so many libraries can build concurrently.
+class library_future
+{
+public:
+        /// Create invalid handle.
+        library_future() {}
+
+        /// Create handle from future of library.
+        explicit library_future(
+                std::shared_future<std::shared_ptr<library>> future)
+                : future_(std::move(future))
+        {
+        }
+
+        /// Wait for the build and access the library, rethrows build errors.
+        std::shared_ptr<library> get() const
+        {
+                auto l = future_.get();
+                l->wait();
+                return l;
+        }
+
+        /// Wait for the build to finish.
+        void wait() const { get(); }
+
+        /// Query if the library is built (does not block).
+        bool ready() const
+        {
+                if (!valid() ||
+                        future_.wait_for(std::chrono::seconds(0)) !=
+                                std::future_status::ready)
+                {
+                        return false;
+                }
+                try
+                {
+                        return future_.get()->ready();
+                }
+                catch (...)
+                {
+                        // Failed builds are done, get() throws.
+                        return true;
+                }
+        }
+
+        /// Query if the handle refers to a library.
+        bool valid() const { return future_.valid(); }
+
+private:
+        /// Library that is being created.
+        std::shared_future<std::shared_ptr<library>> future_;
+};
+
+/// Build library from string in the background, d is referenced by the
+/// build and must outlive the returned handle and the library.
+inline library_future build_library_async(const std::string& kernelstring,
+        device& d, bool inject_aura_preamble = true,
+        const std::string& options = "")
+{
+        return library_future(
+                detail::worker_pool::instance()
+                        .submit([kernelstring, &d, inject_aura_preamble,
+                                        options]()
+                                {
+                                        return std::make_shared<library>(
+                                                kernelstring, d,
+                                                inject_aura_preamble, options,
+                                                deferred_build);
+                                })
+                        .share());
+}
+
+/// Build library from file in the background, d is referenced by the
+/// build and must outlive the returned handle and the library.
+inline library_future build_library_async(boost::aura::path p, device& d,
+        bool inject_aura_preamble = true, const std::string& options = "")
+{
+        return library_future(
+                detail::worker_pool::instance()
+                        .submit([p, &d, inject_aura_preamble, options]()
+                                {
+                                        return std::make_shared<library>(p, d,
+                                                inject_aura_preamble, options,
+                                                deferred_build);
+                                })
+                        .share());
+}
+
+} // namespace aura
+} // namespace boost
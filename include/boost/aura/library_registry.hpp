@@ -0,0 +1,159 @@
+#pragma once
+
+#include <boost/aura/base/content_hash.hpp>
+#include <boost/aura/device.hpp>
+#include <boost/aura/io.hpp>
+#include <boost/aura/library.hpp>
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <tuple>
+
+namespace boost
+{
+namespace aura
+{
+
+/// Process-wide, thread-safe registry of shared libraries.
+///
+/// Requests for the same source, options and device return the same
+/// library, so only the first request pays for compilation. Libraries are
+/// reference counted: an entry lives as long as any holder (or any kernel
+/// created from it) holds a reference. Concurrent requests for a library
+/// that is still being built wait for that build.
+class library_registry
+{
+public:
+        /// Process-wide registry.
+        static library_registry& instance()
+        {
+                static library_registry registry;
+                return registry;
+        }
+
+        /// Create empty registry.
+        library_registry() {}
+
+        /// Prevent copies.
+        library_registry(const library_registry&) = delete;
+        void operator=(const library_registry&) = delete;
+
+        /// Get library from string (build it if it is not registered).
+        std::shared_ptr<library> get(const std::string& kernelstring,
+                device& d, bool inject_aura_preamble = true,
+                const std::string& options = "")
+        {
+                // Programs belong to the context of a device object, so the
+                // device object is part of the key next to its ordinal.
+                key_t key(detail::content_hash({kernelstring}), options,
+                        inject_aura_preamble, d.get_ordinal(), &d);
+
+                std::unique_lock<std::mutex> lock(mutex_);
+                while (true)
+                {
+                        auto it = libraries_.find(key);
+                        if (it != libraries_.end())
+                        {
+                                auto l = it->second.lock();
+                                if (l)
+                                {
+                                        return l;
+                                }
+                        }
+                        if (pending_.count(key) == 0)
+                        {
+                                break;
+                        }
+                        // Another thread is building this library.
+                        cv_.wait(lock);
+                }
+                pending_.insert(key);
+                lock.unlock();
+
+                std::shared_ptr<library> l;
+                try
+                {
+                        l = std::make_shared<library>(kernelstring, d,
+                                inject_aura_preamble, options);
+                }
+                catch (...)
+                {
+                        lock.lock();
+                        pending_.erase(key);
+                        cv_.notify_all();
+                        throw;
+                }
+
+                lock.lock();
+                purge_();
+                libraries_[key] = l;
+                pending_.erase(key);
+                cv_.notify_all();
+                return l;
+        }
+
+        /// Get library from file (build it if it is not registered).
+        std::shared_ptr<library> get(boost::aura::path p, device& d,
+                bool inject_aura_preamble = true,
+                const std::string& options = "")
+        {
+                return get(boost::aura::read_all(p), d, inject_aura_preamble,
+                        options);
+        }
+
+        /// Number of libraries that are currently alive.
+        std::size_t size() const
+        {
+                std::lock_guard<std::mutex> guard(mutex_);
+                std::size_t count = 0;
+                for (const auto& entry : libraries_)
+                {
+                        if (!entry.second.expired())
+                        {
+                                count++;
+                        }
+                }
+                return count;
+        }
+
+private:
+        /// Source hash, options, preamble flag, device ordinal, device.
+        typedef std::tuple<std::string, std::string, bool, std::size_t,
+                const device*>
+                key_t;
+
+        /// Remove entries of libraries that are no longer alive.
+        void purge_()
+        {
+                for (auto it = libraries_.begin(); it != libraries_.end();)
+                {
+                        if (it->second.expired())
+                        {
+                                it = libraries_.erase(it);
+                        }
+                        else
+                        {
+                                ++it;
+                        }
+                }
+        }
+
+        /// Mutex used to allow multi-threaded access to class.
+        mutable std::mutex mutex_;
+
+        /// Signals that a pending build finished.
+        std::condition_variable cv_;
+
+        /// Registered libraries.
+        std::map<key_t, std::weak_ptr<library>> libraries_;
+
+        /// Libraries that are currently being built.
+        std::set<key_t> pending_;
+};
+
+} // namespace aura
+} // namespace boost
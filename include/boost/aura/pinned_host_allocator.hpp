@@ -0,0 +1,130 @@
+#pragma once
+
+#include <boost/aura/device.hpp>
+
+#if defined AURA_BASE_CUDA
+#include <boost/aura/base/cuda/pinned_memory.hpp>
+#elif defined AURA_BASE_OPENCL
+#include <boost/aura/base/opencl/pinned_memory.hpp>
+#elif defined AURA_BASE_METAL
+#include <boost/aura/base/metal/pinned_memory.hpp>
+#endif
+
+#include <cassert>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace boost
+{
+namespace aura
+{
+
+#if defined AURA_BASE_CUDA
+namespace base = base_detail::cuda;
+#elif defined AURA_BASE_OPENCL
+namespace base = base_detail::opencl;
+#elif defined AURA_BASE_METAL
+namespace base = base_detail::metal;
+#endif
+
+using base::pinned_memory;
+using base::pinned_malloc;
+using base::pinned_free;
+
+namespace detail
+{
+
+/// Pinned allocations of a pinned_host_allocator (shared by its copies).
+struct pinned_host_allocations
+{
+        std::mutex mutex;
+        std::unordered_map<void*, pinned_memory<char>> allocations;
+};
+
+} // namespace detail
+
+/// Allocator for pinned (page-locked) host memory.
+/// Transfers between pinned host memory and the device use DMA directly,
+/// pageable memory is staged by the driver. Satisfies the standard
+/// allocator requirements, so it can be used with standard containers.
+template <class T>
+struct pinned_host_allocator
+{
+        using value_type = T;
+
+        /// Rebind allocator to other type.
+        template <class U>
+        struct rebind
+        {
+                typedef pinned_host_allocator<U> other;
+        };
+
+        /// Construct allocator.
+        pinned_host_allocator(device& d)
+                : device_(&d)
+                , allocations_(
+                          std::make_shared<detail::pinned_host_allocations>())
+        {}
+
+        /// Copy construct allocator.
+        template <class U>
+        pinned_host_allocator(const pinned_host_allocator<U>& other)
+                : device_(other.device_)
+                , allocations_(other.allocations_)
+        {}
+
+        /// Allocate memory.
+        T* allocate(std::size_t n)
+        {
+                assert(device_);
+                auto m = pinned_malloc<char>(n * sizeof(T), *device_);
+                std::lock_guard<std::mutex> guard(allocations_->mutex);
+                allocations_->allocations[m.host_ptr] = m;
+                return reinterpret_cast<T*>(m.host_ptr);
+        }
+
+        /// Deallocate memory.
+        void deallocate(T* p, std::size_t)
+        {
+                pinned_memory<char> m;
+                {
+                        std::lock_guard<std::mutex> guard(
+                                allocations_->mutex);
+                        auto it = allocations_->allocations.find(p);
+                        assert(it != allocations_->allocations.end());
+                        m = it->second;
+                        allocations_->allocations.erase(it);
+                }
+                pinned_free(m);
+        }
+
+        /// Access device.
+        device& get_device() const { return *device_; }
+
+        /// Allocators are equal if they can free each others memory.
+        template <class U>
+        bool operator==(const pinned_host_allocator<U>& other) const
+        {
+                return allocations_ == other.allocations_;
+        }
+
+        template <class U>
+        bool operator!=(const pinned_host_allocator<U>& other) const
+        {
+                return !(*this == other);
+        }
+
+private:
+        /// Device the memory is pinned for.
+        device* device_;
+
+        /// Live allocations.
+        std::shared_ptr<detail::pinned_host_allocations> allocations_;
+
+        template <class U>
+        friend struct pinned_host_allocator;
+};
+
+} // namespace aura
+} // namespace boost
@@ -4,6 +4,8 @@ namespace boost
 {
 namespace aura
 {
+/// Backend defaults, device::get_properties() holds the values of a
+/// device.
 namespace platform
 {
 
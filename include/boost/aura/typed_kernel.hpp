@@ -0,0 +1,83 @@
+#pragma once
+
+#include <boost/aura/base/kernel_signature.hpp>
+#include <boost/aura/feed.hpp>
+#include <boost/aura/invoke.hpp>
+#include <boost/aura/kernel.hpp>
+#include <boost/aura/library.hpp>
+#include <boost/aura/mesh_bundle.hpp>
+
+#include <memory>
+#include <string>
+#include <type_traits>
+
+namespace boost
+{
+namespace aura
+{
+
+template <typename Signature>
+class typed_kernel;
+
+/// Kernel with a fixed host signature.
+///
+/// The signature is checked against the kernel when it is created, and
+/// calls only accept arguments of the signature. Argument types are only
+/// checked if the library was built with the kernel_arg_info option,
+/// otherwise only the number of arguments is. Arguments are packed
+/// directly into their kernel argument types, e.g.
+/// library l(source, d, true, kernel_arg_info);
+/// typed_kernel<void(device_ptr<float>, int)> k("scale", l);
+/// k(mesh, bundle, f, ptr, 42);
+template <typename... Params>
+class typed_kernel<void(Params...)>
+{
+public:
+        /// Create kernel from library and check its signature.
+        inline explicit typed_kernel(const std::string& name, library& l)
+                : kernel_(name, l)
+        {
+                check_();
+        }
+
+        /// Create kernel from shared library and check its signature, the
+        /// kernel keeps the library alive.
+        inline explicit typed_kernel(
+                const std::string& name, std::shared_ptr<library> l)
+                : kernel_(name, std::move(l))
+        {
+                check_();
+        }
+
+        /// Invoke kernel, arguments must have exactly the types of the
+        /// signature (no implicit conversions, e.g. double to float).
+        template <typename MeshType, typename BundleType, typename... Args>
+        void operator()(
+                const MeshType& m, const BundleType& b, feed& f, Args&&... a)
+        {
+                static_assert(
+                        std::is_same<detail::type_list<typename std::decay<
+                                             Args>::type...>,
+                                detail::type_list<Params...>>::value,
+                        "typed_kernel arguments do not match the signature");
+                invoke(kernel_, m, b,
+                        args(detail::kernel_arg<Params>::convert(a)...), f);
+        }
+
+        /// Access untyped kernel.
+        kernel& get_kernel() { return kernel_; }
+
+private:
+        /// Check signature, throws if it does not match.
+        void check_()
+        {
+                base::check_signature(
+                        kernel_, {detail::kernel_arg<Params>::describe()...});
+        }
+
+        /// Untyped kernel.
+        kernel kernel_;
+};
+
+} // namespace aura
+} // namespace boost
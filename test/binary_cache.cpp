@@ -0,0 +1,218 @@
+#define BOOST_TEST_MODULE binary_cache
+#include <boost/test/unit_test.hpp>
+
+#include <boost/aura/binary_cache.hpp>
+#include <boost/aura/device.hpp>
+#include <boost/aura/environment.hpp>
+#include <boost/aura/kernel.hpp>
+#include <boost/aura/library.hpp>
+
+#include <test/test.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <cstdint>
+#include <fstream>
+
+namespace fs = boost::filesystem;
+
+namespace
+{
+
+/// Empty temporary directory, removed with its contents when destroyed.
+struct temp_dir
+{
+        temp_dir()
+                : path(fs::temp_directory_path() /
+                          fs::unique_path("aura-binary-cache-%%%%-%%%%"))
+        {
+                fs::create_directories(path);
+        }
+
+        ~temp_dir()
+        {
+                boost::system::error_code ec;
+                fs::remove_all(path, ec);
+        }
+
+        std::string string() const { return path.string(); }
+
+        fs::path path;
+};
+
+/// Points the process-wide cache to a directory, restores the previous
+/// directory when destroyed.
+struct scoped_cache_directory
+{
+        explicit scoped_cache_directory(const std::string& directory)
+                : old_directory(boost::aura::binary_cache::instance()
+                                        .get_directory())
+        {
+                boost::aura::binary_cache::instance().set_directory(directory);
+        }
+
+        ~scoped_cache_directory()
+        {
+                boost::aura::binary_cache::instance().set_directory(
+                        old_directory);
+        }
+
+        std::string old_directory;
+};
+
+/// Count cache entries in directory.
+std::size_t count_entries(const temp_dir& dir)
+{
+        std::size_t count = 0;
+        for (fs::directory_iterator it(dir.path), end; it != end; ++it)
+        {
+                if (it->path().extension() == ".aurabin")
+                {
+                        count++;
+                }
+        }
+        return count;
+}
+
+} // namespace
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(basic_key)
+{
+        auto k0 = boost::aura::binary_cache::make_key({"ab", "c"});
+        auto k1 = boost::aura::binary_cache::make_key({"a", "bc"});
+        auto k2 = boost::aura::binary_cache::make_key({"ab", "c"});
+        BOOST_CHECK(k0 != k1);
+        BOOST_CHECK(k0 == k2);
+        BOOST_CHECK(k0.size() == 32);
+}
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(store_load)
+{
+        temp_dir dir;
+        {
+                boost::aura::binary_cache cache(dir.string());
+                BOOST_CHECK(cache.enabled());
+
+                std::vector<unsigned char> binary(1024, 42);
+                std::vector<unsigned char> loaded;
+                BOOST_CHECK(!cache.load("entry", loaded));
+
+                cache.store("entry", binary);
+                BOOST_CHECK(cache.load("entry", loaded));
+                BOOST_CHECK(loaded == binary);
+
+                // Overwrite existing entry.
+                binary.assign(16, 21);
+                cache.store("entry", binary);
+                BOOST_CHECK(cache.load("entry", loaded));
+                BOOST_CHECK(loaded == binary);
+                BOOST_CHECK(count_entries(dir) == 1);
+
+                // Rejected binaries count as misses.
+                BOOST_CHECK(cache.num_hits() == 2);
+                BOOST_CHECK(cache.num_misses() == 1);
+                cache.report_rejected();
+                BOOST_CHECK(cache.num_hits() == 1);
+                BOOST_CHECK(cache.num_misses() == 2);
+        }
+}
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(corrupt_entry)
+{
+        temp_dir dir;
+        {
+                boost::aura::binary_cache cache(dir.string());
+                auto entry = (dir.path / "entry.aurabin").string();
+                {
+                        std::ofstream out(entry);
+                        out << "not a binary";
+                }
+                std::vector<unsigned char> loaded;
+                BOOST_CHECK(!cache.load("entry", loaded));
+                // Corrupt entry is removed.
+                BOOST_CHECK(count_entries(dir) == 0);
+
+                // Size in header larger than the file.
+                {
+                        std::ofstream out(entry, std::ios::binary);
+                        std::uint64_t size = std::uint64_t(1) << 60;
+                        out.write("AURABIN1", 8);
+                        out.write(reinterpret_cast<const char*>(&size),
+                                sizeof(size));
+                }
+                BOOST_CHECK(!cache.load("entry", loaded));
+                BOOST_CHECK(loaded.empty());
+                BOOST_CHECK(count_entries(dir) == 0);
+                BOOST_CHECK(cache.num_misses() == 2);
+                BOOST_CHECK(cache.num_hits() == 0);
+        }
+}
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(eviction)
+{
+        temp_dir dir;
+        {
+                // Room for three entries.
+                boost::aura::binary_cache cache(dir.string(), 3 * 1024 + 100);
+                std::vector<unsigned char> binary(1000, 1);
+                for (int i = 0; i < 10; i++)
+                {
+                        cache.store(std::to_string(i), binary);
+                }
+                BOOST_CHECK(count_entries(dir) <= 3);
+                BOOST_CHECK(count_entries(dir) > 0);
+        }
+}
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(disabled)
+{
+        boost::aura::binary_cache cache;
+        BOOST_CHECK(!cache.enabled());
+        std::vector<unsigned char> binary(16, 1);
+        cache.store("entry", binary);
+        BOOST_CHECK(!cache.load("entry", binary));
+}
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(cached_library)
+{
+        temp_dir dir;
+        scoped_cache_directory scoped_directory(dir.string());
+
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                auto p = boost::aura::path(
+                        boost::aura::test::get_test_dir() + "/kernels.al");
+                {
+                        boost::aura::library l(p, d);
+                        boost::aura::kernel k("add", l);
+                }
+#ifdef AURA_BASE_OPENCL
+                auto& cache = boost::aura::binary_cache::instance();
+                BOOST_CHECK(count_entries(dir) == 1);
+                auto hits = cache.num_hits();
+#endif
+                {
+                        // Second build loads binary from cache.
+                        boost::aura::library l(p, d);
+                        boost::aura::kernel k("add", l);
+                }
+#ifdef AURA_BASE_OPENCL
+                BOOST_CHECK(count_entries(dir) == 1);
+                BOOST_CHECK(cache.num_hits() == hits + 1);
+#endif
+        }
+        boost::aura::finalize();
+}
@@ -0,0 +1,119 @@
+#define BOOST_TEST_MODULE bundle_tuner
+#include <boost/test/unit_test.hpp>
+
+#include <boost/aura/bundle_tuner.hpp>
+#include <boost/aura/copy.hpp>
+#include <boost/aura/device.hpp>
+#include <boost/aura/device_ptr.hpp>
+#include <boost/aura/environment.hpp>
+#include <boost/aura/feed.hpp>
+#include <boost/aura/invoke.hpp>
+#include <boost/aura/io.hpp>
+#include <boost/aura/kernel.hpp>
+#include <boost/aura/library.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <test/test.hpp>
+
+#include <vector>
+
+using namespace boost::aura;
+namespace fs = boost::filesystem;
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(candidates)
+{
+        bundle_limits l;
+        l.max_size = 256;
+        l.max_extent = {{256, 256, 64}};
+        l.preferred_multiple = 32;
+
+        auto c = bundle_tuner::candidates(mesh({{1024, 1, 1}}), l);
+        BOOST_CHECK(c.size() == 4);
+        BOOST_CHECK(c.front() == bundle({{256, 1, 1}}));
+        BOOST_CHECK(c.back() == bundle({{32, 1, 1}}));
+
+        // Bundles must divide mesh.
+        c = bundle_tuner::candidates(mesh({{96, 4, 1}}), l);
+        for (const auto& b : c)
+        {
+                BOOST_CHECK(96 % b[0] == 0 && 4 % b[1] == 0 && b[2] == 1);
+                BOOST_CHECK(b[0] * b[1] * b[2] % 32 == 0);
+        }
+        BOOST_CHECK(c.front() == bundle({{32, 4, 1}}));
+
+        // Mesh smaller than preferred multiple.
+        c = bundle_tuner::candidates(mesh({{6, 1, 1}}), l);
+        BOOST_CHECK(c.size() == 2);
+        BOOST_CHECK(c.front() == bundle({{2, 1, 1}}));
+}
+
+BOOST_AUTO_TEST_CASE(tune_and_invoke)
+{
+        initialize();
+        {
+                auto file = fs::temp_directory_path() /
+                        fs::unique_path("aura-bundle-cache-%%%%-%%%%");
+                device d(AURA_UNIT_TEST_DEVICE);
+                feed f(d);
+                library l(path(test::get_test_dir() + "/kernels.al"), d);
+                kernel k("add", l);
+                const std::size_t num_el = 1024;
+
+                std::vector<float> a(num_el, 2.0f);
+                std::vector<float> b(num_el, 3.0f);
+                std::vector<float> c(num_el, 0.0f);
+
+                auto a_ptr = device_malloc<float>(num_el, d);
+                auto b_ptr = device_malloc<float>(num_el, d);
+                auto c_ptr = device_malloc<float>(num_el, d);
+                copy(a.begin(), a.end(), a_ptr, f);
+                copy(b.begin(), b.end(), b_ptr, f);
+
+                auto m = mesh({{num_el, 1, 1}});
+                bundle tuned;
+                {
+                        bundle_tuner t(file.string());
+                        BOOST_CHECK(!t.lookup(k, m, d, tuned));
+                        tuned = t.tune(k, m,
+                                args(a_ptr.get_base_ptr(),
+                                        b_ptr.get_base_ptr(),
+                                        c_ptr.get_base_ptr()),
+                                f);
+                        BOOST_CHECK(num_el % tuned[0] == 0);
+                }
+
+                // Results are read back from file.
+                {
+                        bundle_tuner t(file.string());
+                        bundle loaded;
+                        BOOST_CHECK(t.lookup(k, m, d, loaded));
+                        BOOST_CHECK(loaded == tuned);
+
+                        // Same kernel from edited source is not tuned.
+                        library edited(read_all(path(test::get_test_dir() +
+                                               "/kernels.al")) +
+                                        "\n// edited\n",
+                                d);
+                        kernel k2("add", edited);
+                        BOOST_CHECK(!t.lookup(k2, m, d, loaded));
+                }
+
+                invoke(k, m, auto_bundle,
+                        args(a_ptr.get_base_ptr(), b_ptr.get_base_ptr(),
+                                c_ptr.get_base_ptr()),
+                        f);
+                copy(c_ptr, c_ptr + num_el, c.begin(), f);
+                wait_for(f);
+                BOOST_CHECK(c[0] == 5.0f);
+                BOOST_CHECK(c[num_el - 1] == 5.0f);
+
+                device_free(a_ptr);
+                device_free(b_ptr);
+                device_free(c_ptr);
+                fs::remove(file);
+        }
+        finalize();
+}
@@ -7,6 +7,8 @@
 #include <boost/aura/environment.hpp>
 #include <boost/aura/feed.hpp>
 
+#include <future>
+
 // _____________________________________________________________________________
 
 
@@ -109,3 +111,31 @@ BOOST_AUTO_TEST_CASE(basic_copy_shared)
         }
         boost::aura::finalize();
 }
+
+BOOST_AUTO_TEST_CASE(async_copy)
+{
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                boost::aura::feed f(d);
+
+                std::vector<float> host_src(1024, 21.0f);
+                std::vector<float> host_dst(1024, 0.0f);
+
+                auto ptr0 = boost::aura::device_malloc<float>(1024, d);
+
+                boost::aura::copy_async(
+                        host_src.begin(), host_src.end(), ptr0, f);
+                auto e = boost::aura::copy_async(
+                        ptr0, ptr0 + 1024, host_dst.begin(), f);
+
+                std::promise<void> done;
+                e.then([&done]() { done.set_value(); });
+                done.get_future().wait();
+                BOOST_CHECK(e.query());
+                BOOST_CHECK(std::equal(
+                        host_src.begin(), host_src.end(), host_dst.begin()));
+                boost::aura::device_free(ptr0);
+        }
+        boost::aura::finalize();
+}
@@ -76,3 +76,30 @@ BOOST_AUTO_TEST_CASE(device_ctors)
         }
         boost::aura::finalize();
 }
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(device_properties)
+{
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                const auto& p = d.get_properties();
+                BOOST_CHECK(!p.name.empty());
+                BOOST_CHECK(p.max_bundle_size > 0);
+                BOOST_CHECK(p.max_bundle_extent[0] > 0);
+                BOOST_CHECK(p.memory_alignment > 0);
+                BOOST_CHECK(p.supports_shared_memory ==
+                        d.supports_shared_memory());
+                std::cout << p.name << " (" << p.vendor << "): "
+                          << p.compute_units << " compute units, "
+                          << p.global_memory_size << " bytes global memory"
+                          << std::endl;
+
+                // Properties move with the device.
+                auto name = p.name;
+                boost::aura::device d1(std::move(d));
+                BOOST_CHECK(d1.get_properties().name == name);
+        }
+        boost::aura::finalize();
+}
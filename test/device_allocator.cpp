@@ -4,6 +4,10 @@
 #include <boost/aura/device_allocator.hpp>
 #include <boost/aura/device_pool_allocator.hpp>
 #include <boost/aura/environment.hpp>
+#include <boost/aura/feed.hpp>
+
+#include <thread>
+#include <vector>
 
 // _____________________________________________________________________________
 
@@ -103,10 +107,10 @@ BOOST_AUTO_TEST_CASE(pool_allocator_multiple_sizes)
                                         a.deallocate(ptr0, 1024);
                                         a.deallocate(ptr1, 2*1024);
                                 }
-                                // We had to allocate twice.
+                                // Both sizes are carved from one slab.
                                 BOOST_CHECK(
                                         d.allocation_tracker.count_active() ==
-                                        2
+                                        1
                                 );
                                 BOOST_CHECK(
                                         d.allocation_tracker.count_old() ==
@@ -115,7 +119,7 @@ BOOST_AUTO_TEST_CASE(pool_allocator_multiple_sizes)
                         }
                 }
                 BOOST_CHECK(d.allocation_tracker.count_active() == 0);
-                BOOST_CHECK(d.allocation_tracker.count_old() == 2);
+                BOOST_CHECK(d.allocation_tracker.count_old() == 1);
 
         }
         boost::aura::finalize();
@@ -134,13 +138,13 @@ BOOST_AUTO_TEST_CASE(pool_allocator_force_purge)
                                 auto ptr0 = a.allocate(10);
                                 a.deallocate(ptr0, 10);
 
-                                auto ptr1 = a.allocate(11);
+                                auto ptr1 = a.allocate(1000);
                                 // This alloc should have triggered a purge.
                                 BOOST_CHECK(
                                         d.allocation_tracker.count_old() ==
                                         1
                                 );
-                                a.deallocate(ptr1, 11);
+                                a.deallocate(ptr1, 1000);
                         }
                 }
                 BOOST_CHECK(d.allocation_tracker.count_active() == 0);
@@ -173,8 +177,177 @@ BOOST_AUTO_TEST_CASE(pool_allocator_force_shutdown)
                         }
                 }
                 BOOST_CHECK(d.allocation_tracker.count_active() == 0);
-                BOOST_CHECK(d.allocation_tracker.count_old() == 2);
+                BOOST_CHECK(d.allocation_tracker.count_old() == 1);
+
+        }
+        boost::aura::finalize();
+}
+
+BOOST_AUTO_TEST_CASE(pool_allocator_nearby_sizes)
+{
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                d.allocation_tracker.activate();
+                {
+                        boost::aura::device_pool_allocator<float> a(d);
+                        auto ptr0 = a.allocate(1024);
+                        a.deallocate(ptr0, 1024);
+                        auto ptr1 = a.allocate(1025);
+                        a.deallocate(ptr1, 1025);
+                        a.flush();
+
+                        // Second allocation is served from the slab.
+                        BOOST_CHECK(d.allocation_tracker.count_active() == 1);
+                        auto s = a.get_statistics();
+                        BOOST_CHECK(s.hits == 1);
+                        BOOST_CHECK(s.misses == 1);
+                        BOOST_CHECK(s.hit_rate() == 0.5);
+                        BOOST_CHECK(s.in_use_bytes == 0);
+                        BOOST_CHECK(s.largest_free_block == s.reserved_bytes);
+                }
+                BOOST_CHECK(d.allocation_tracker.count_active() == 0);
+        }
+        boost::aura::finalize();
+}
+
+BOOST_AUTO_TEST_CASE(pool_allocator_requested_bytes)
+{
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                {
+                        // Thread caches of 4 blocks per size class.
+                        boost::aura::device_pool_allocator<float> a(
+                                d, 1024 * 1024, 1024 * 1024, 4);
+                        auto ptr0 = a.allocate(1000);
+                        auto s = a.get_statistics();
+                        BOOST_CHECK(s.requested_bytes == 1000 * sizeof(float));
 
+                        // Freed into and served from the thread cache.
+                        a.deallocate(ptr0, 1000);
+                        BOOST_CHECK(a.get_statistics().requested_bytes == 0);
+                        auto ptr1 = a.allocate(900);
+                        s = a.get_statistics();
+                        BOOST_CHECK(s.thread_cache_hits > 0);
+                        BOOST_CHECK(s.requested_bytes == 900 * sizeof(float));
+                        BOOST_CHECK(s.internal_fragmentation() > 0.);
+                        a.deallocate(ptr1, 900);
+
+                        a.flush();
+                        s = a.get_statistics();
+                        BOOST_CHECK(s.requested_bytes == 0);
+                        BOOST_CHECK(s.in_use_bytes == 0);
+                }
+        }
+        boost::aura::finalize();
+}
+
+BOOST_AUTO_TEST_CASE(pool_allocator_coalesce)
+{
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                d.allocation_tracker.activate();
+                {
+                        // One slab of 1M elements.
+                        const std::size_t n = 1024 * 1024;
+                        boost::aura::device_pool_allocator<float> a(d, n, n);
+                        auto ptr0 = a.allocate(n / 2);
+                        auto ptr1 = a.allocate(n / 2);
+                        BOOST_CHECK(d.allocation_tracker.count_active() == 1);
+                        auto s = a.get_statistics();
+                        BOOST_CHECK(s.in_use_bytes == s.reserved_bytes);
+                        BOOST_CHECK(s.largest_free_block == 0);
+
+                        // Halves are merged, whole slab is free again.
+                        a.deallocate(ptr0, n / 2);
+                        a.deallocate(ptr1, n / 2);
+                        auto ptr2 = a.allocate(n);
+                        BOOST_CHECK(d.allocation_tracker.count_active() == 1);
+                        s = a.get_statistics();
+                        BOOST_CHECK(s.hits + s.thread_cache_hits == 2);
+                        a.deallocate(ptr2, n);
+                }
+                BOOST_CHECK(d.allocation_tracker.count_active() == 0);
+                BOOST_CHECK(d.allocation_tracker.count_old() == 1);
+        }
+        boost::aura::finalize();
+}
+
+BOOST_AUTO_TEST_CASE(pool_allocator_threads)
+{
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                d.allocation_tracker.activate();
+                {
+                        boost::aura::device_pool_allocator<float> a(d);
+                        std::vector<std::thread> threads;
+                        for (int t = 0; t < 4; t++)
+                        {
+                                threads.emplace_back([&a, t]()
+                                        {
+                                                for (int i = 0; i < 100; i++)
+                                                {
+                                                        auto ptr = a.allocate(
+                                                                1024 + t);
+                                                        a.deallocate(
+                                                                ptr, 1024 + t);
+                                                }
+                                        });
+                        }
+                        for (auto& t : threads)
+                        {
+                                t.join();
+                        }
+                        // Thread caches are flushed when threads exit.
+                        auto s = a.get_statistics();
+                        BOOST_CHECK(s.in_use_bytes == 0);
+                        BOOST_CHECK(s.thread_cache_hits > 0);
+                        BOOST_CHECK(d.allocation_tracker.count_active() == 1);
+                }
+                BOOST_CHECK(d.allocation_tracker.count_active() == 0);
+        }
+        boost::aura::finalize();
+}
+
+BOOST_AUTO_TEST_CASE(pool_allocator_feed_ordered)
+{
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                boost::aura::feed f0(d);
+                boost::aura::feed f1(d);
+                d.allocation_tracker.activate();
+                {
+                        // Without thread caches, so blocks that are not
+                        // pending come from the depot.
+                        boost::aura::device_pool_allocator<float> a(d,
+                                10 * 1024 * 1024 / sizeof(float),
+                                4 * 1024 * 1024 / sizeof(float), 0);
+                        auto ptr0 = a.allocate(1024, f0);
+                        auto copy = ptr0;
+                        a.deallocate(ptr0, 1024, f0);
+                        BOOST_CHECK(a.get_statistics().misses == 1);
+
+                        // Same feed reuses the block without waiting.
+                        auto ptr1 = a.allocate(1024, f0);
+                        BOOST_CHECK(ptr1 == copy);
+                        BOOST_CHECK(a.get_statistics().hits == 1);
+                        a.deallocate(ptr1, 1024, f0);
+
+                        // Other feeds get the block once f0 is done.
+                        f0.synchronize();
+                        auto ptr2 = a.allocate(1024, f1);
+                        auto s = a.get_statistics();
+                        BOOST_CHECK(s.hits == 2);
+                        BOOST_CHECK(s.misses == 1);
+                        BOOST_CHECK(s.thread_cache_hits == 0);
+                        a.deallocate(ptr2, 1024, f1);
+                        BOOST_CHECK(d.allocation_tracker.count_active() == 1);
+                }
+                BOOST_CHECK(d.allocation_tracker.count_active() == 0);
         }
         boost::aura::finalize();
 }
@@ -49,3 +49,102 @@ BOOST_AUTO_TEST_CASE(basic)
         }
         finalize();
 }
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(access_tags)
+{
+        initialize();
+        {
+                device d(AURA_UNIT_TEST_DEVICE);
+                feed f(d);
+                const std::size_t numel = 1024;
+                device_array<float> ar0(numel, d);
+                {
+                        // Write only map does not read device memory.
+                        auto m0 = ar0.map(f, memory_access_tag::wo);
+                        std::fill(m0.begin(), m0.end(), 21.0f);
+                        if (m0.is_zero_copy())
+                        {
+                                BOOST_CHECK(d.supports_zero_copy_map() ||
+                                        d.supports_shared_memory());
+                        }
+                }
+                {
+                        auto m0 = ar0.map(f, memory_access_tag::ro);
+                        BOOST_CHECK(
+                                std::all_of(
+                                        m0.begin(),
+                                        m0.end(),
+                                        [](float v) { return v == 21.0f; }
+                                )
+                        );
+                }
+                {
+                        // Moved map is unmapped once.
+                        auto m0 = ar0.map(f);
+                        auto m1(std::move(m0));
+                        std::fill(m1.begin(), m1.end(), 42.0f);
+                }
+                std::vector<float> vec(numel, 0.0f);
+                boost::aura::copy(ar0, vec, f);
+                f.synchronize();
+                BOOST_CHECK(vec[numel - 1] == 42.0f);
+        }
+        finalize();
+}
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(range_and_dirty)
+{
+        initialize();
+        {
+                device d(AURA_UNIT_TEST_DEVICE);
+                feed f(d);
+                const std::size_t numel = 64 * 1024;
+                device_array<float> ar0(numel, d);
+                std::vector<float> vec(numel, 1.0f);
+                boost::aura::copy(vec, ar0, f);
+                f.synchronize();
+
+                {
+                        // Modify a range, only one page is dirty.
+                        auto m0 = ar0.map(1024, 4096, f,
+                                memory_access_tag::rw, true);
+                        BOOST_CHECK(m0.size() == 4096);
+                        BOOST_CHECK(m0.begin()[0] == 1.0f);
+                        m0.begin()[100] = 2.0f;
+                }
+                {
+                        // Multiple ranges.
+                        auto maps = ar0.map({{0, 16}, {numel - 16, 16}}, f);
+                        BOOST_CHECK(maps.size() == 2);
+                        std::fill(maps[0].begin(), maps[0].end(), 3.0f);
+                        std::fill(maps[1].begin(), maps[1].end(), 4.0f);
+                }
+
+                boost::aura::copy(ar0, vec, f);
+                f.synchronize();
+                BOOST_CHECK(vec[0] == 3.0f);
+                BOOST_CHECK(vec[15] == 3.0f);
+                BOOST_CHECK(vec[16] == 1.0f);
+                BOOST_CHECK(vec[1024 + 100] == 2.0f);
+                BOOST_CHECK(vec[1024 + 101] == 1.0f);
+                BOOST_CHECK(vec[numel - 17] == 1.0f);
+                BOOST_CHECK(vec[numel - 1] == 4.0f);
+
+                {
+                        // Write-only maps are written back as a whole.
+                        auto m1 = ar0.map(0, 2048, f, memory_access_tag::wo,
+                                true);
+                        std::fill(m1.begin(), m1.end(), 5.0f);
+                }
+                boost::aura::copy(ar0, vec, f);
+                f.synchronize();
+                BOOST_CHECK(std::count(vec.begin(), vec.begin() + 2048,
+                                    5.0f) == 2048);
+                BOOST_CHECK(vec[2048] == 1.0f);
+        }
+        finalize();
+}
@@ -0,0 +1,63 @@
+#define BOOST_TEST_MODULE event
+#include <boost/test/unit_test.hpp>
+
+#include <boost/aura/copy.hpp>
+#include <boost/aura/device.hpp>
+#include <boost/aura/device_ptr.hpp>
+#include <boost/aura/environment.hpp>
+#include <boost/aura/event.hpp>
+#include <boost/aura/feed.hpp>
+
+#include <algorithm>
+#include <vector>
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(basic_event)
+{
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                boost::aura::feed f(d);
+
+                boost::aura::event empty;
+                BOOST_CHECK(empty.query());
+
+                boost::aura::event e(f);
+                e.synchronize();
+                BOOST_CHECK(e.query());
+
+                boost::aura::event moved(std::move(e));
+                BOOST_CHECK(moved.query());
+        }
+        boost::aura::finalize();
+}
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(cross_feed_event)
+{
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                boost::aura::feed upload(d);
+                boost::aura::feed download(d);
+
+                std::vector<float> src(1024 * 1024, 21.0f);
+                std::vector<float> dst(1024 * 1024, 0.0f);
+                auto ptr = boost::aura::device_malloc<float>(src.size(), d);
+
+                boost::aura::copy(src, ptr, upload);
+                auto e = upload.record();
+                // Download feed waits for upload without blocking the host.
+                download.wait(e);
+                boost::aura::copy(ptr, dst, download);
+                boost::aura::wait_for(download);
+                BOOST_CHECK(e.query());
+                BOOST_CHECK(std::equal(src.begin(), src.end(), dst.begin()));
+
+                boost::aura::wait_for(e);
+                boost::aura::device_free(ptr);
+        }
+        boost::aura::finalize();
+}
@@ -1,13 +1,17 @@
 #define BOOST_TEST_MODULE feed
 #include <boost/test/unit_test.hpp>
 
+#include <boost/aura/copy.hpp>
 #include <boost/aura/device.hpp>
+#include <boost/aura/device_ptr.hpp>
 #include <boost/aura/environment.hpp>
+#include <boost/aura/event.hpp>
 #include <boost/aura/feed.hpp>
 
 #include <boost/core/ignore_unused.hpp>
 
 #include <iostream>
+#include <vector>
 
 // _____________________________________________________________________________
 
@@ -40,3 +44,96 @@ BOOST_AUTO_TEST_CASE(basic_feed)
         }
         boost::aura::finalize();
 }
+
+BOOST_AUTO_TEST_CASE(out_of_order_feed)
+{
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                boost::aura::feed f(d, boost::aura::feed_order::out_of_order);
+
+                std::vector<float> host_src(1024, 21.0f);
+                std::vector<float> host_dst(1024, 0.0f);
+                auto ptr0 = boost::aura::device_malloc<float>(1024, d);
+                auto ptr1 = boost::aura::device_malloc<float>(1024, d);
+
+                // Each copy depends on the previous one through a buffer.
+                for (int i = 0; i < 16; i++)
+                {
+                        host_src[0] = i;
+                        boost::aura::copy(
+                                host_src.begin(), host_src.end(), ptr0, f);
+                        boost::aura::copy(ptr0, ptr0 + 1024, ptr1, f);
+                        boost::aura::copy(
+                                ptr1, ptr1 + 1024, host_dst.begin(), f);
+                        f.synchronize();
+                        BOOST_CHECK(std::equal(host_src.begin(),
+                                host_src.end(), host_dst.begin()));
+                }
+                boost::aura::device_free(ptr0);
+                boost::aura::device_free(ptr1);
+        }
+        boost::aura::finalize();
+}
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(out_of_order_host_memory)
+{
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                boost::aura::feed f(d, boost::aura::feed_order::out_of_order);
+
+                const std::size_t n = 1 << 20;
+                std::vector<float> src(n);
+                std::vector<float> host(n, 0.0f);
+                std::vector<float> dst(n, 0.0f);
+                for (std::size_t i = 0; i < n; i++)
+                {
+                        src[i] = i;
+                }
+                auto ptr0 = boost::aura::device_malloc<float>(n, d);
+                auto ptr1 = boost::aura::device_malloc<float>(n, d);
+                boost::aura::copy(src.begin(), src.end(), ptr0, f);
+
+                // The copy from host waits for the copy to host, which
+                // waits for the write of ptr0, without synchronizing.
+                boost::aura::copy(ptr0, ptr0 + n, host.begin(), f);
+                boost::aura::copy(host.begin(), host.end(), ptr1, f);
+                boost::aura::copy(ptr1, ptr1 + n, dst.begin(), f);
+                f.synchronize();
+                BOOST_CHECK(dst == src);
+                boost::aura::device_free(ptr0);
+                boost::aura::device_free(ptr1);
+        }
+        boost::aura::finalize();
+}
+
+#ifdef AURA_BASE_OPENCL
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(out_of_order_tracking_is_bounded)
+{
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                boost::aura::feed f(d, boost::aura::feed_order::out_of_order);
+                std::vector<float> host(16, 1.0f);
+
+                // Many short-lived buffers, ordered with events only.
+                for (int i = 0; i < 1000; i++)
+                {
+                        auto ptr = boost::aura::device_malloc<float>(16, d);
+                        boost::aura::copy(host.begin(), host.end(), ptr, f);
+                        auto e = f.record();
+                        boost::aura::wait_for(e);
+                        boost::aura::device_free(ptr);
+                }
+                BOOST_CHECK(f.num_tracked() < 256);
+        }
+        boost::aura::finalize();
+}
+
+#endif
@@ -0,0 +1,159 @@
+#define BOOST_TEST_MODULE graph
+#include <boost/test/unit_test.hpp>
+
+#include <boost/aura/copy.hpp>
+#include <boost/aura/device.hpp>
+#include <boost/aura/device_array.hpp>
+#include <boost/aura/device_ptr.hpp>
+#include <boost/aura/environment.hpp>
+#include <boost/aura/feed.hpp>
+#include <boost/aura/graph.hpp>
+#include <boost/aura/invoke.hpp>
+#include <boost/aura/kernel.hpp>
+#include <boost/aura/library.hpp>
+
+#include <test/test.hpp>
+
+#include <algorithm>
+#include <vector>
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(capture_and_replay)
+{
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                boost::aura::feed f(d);
+                boost::aura::library l(
+                        boost::aura::path(boost::aura::test::get_test_dir() +
+                                "/kernels.al"),
+                        d);
+                boost::aura::kernel k("add", l);
+                const std::size_t num_el = 128;
+
+                std::vector<float> a(num_el, 2.0f);
+                std::vector<float> b(num_el, 3.0f);
+                std::vector<float> c(num_el, 0.0f);
+
+                auto a_ptr = boost::aura::device_malloc<float>(num_el, d);
+                auto b_ptr = boost::aura::device_malloc<float>(num_el, d);
+                auto c_ptr = boost::aura::device_malloc<float>(num_el, d);
+                auto d_ptr = boost::aura::device_malloc<float>(num_el, d);
+                boost::aura::copy(b.begin(), b.end(), b_ptr, f);
+
+                boost::aura::graph g;
+                f.begin_capture(g);
+                boost::aura::copy(a.begin(), a.end(), a_ptr, f);
+                boost::aura::invoke(k, boost::aura::mesh({{num_el, 1, 1}}),
+                        boost::aura::bundle({{1, 1, 1}}),
+                        boost::aura::args(a_ptr.get_base_ptr(),
+                                b_ptr.get_base_ptr(), c_ptr.get_base_ptr()),
+                        f);
+                boost::aura::copy(c_ptr, c_ptr + num_el, c.begin(), f);
+                f.end_capture();
+                BOOST_CHECK(g.num_kernel_nodes() == 1);
+
+                // Nothing was executed while capturing.
+                f.synchronize();
+                BOOST_CHECK(c[0] == 0.0f);
+
+                for (float v : {1.0f, 4.0f})
+                {
+                        std::fill(a.begin(), a.end(), v);
+                        g.launch(f);
+                        f.synchronize();
+                        BOOST_CHECK(std::all_of(c.begin(), c.end(),
+                                [v](float x) { return x == v + 3.0f; }));
+                }
+
+                // Rebind output, the last copy still reads c_ptr.
+                g.set_arg(0, 2, d_ptr.get_base_ptr());
+                std::fill(c.begin(), c.end(), 0.0f);
+                boost::aura::copy(c.begin(), c.end(), c_ptr, f);
+                g.launch(f);
+                std::vector<float> result(num_el, 0.0f);
+                boost::aura::copy(d_ptr, d_ptr + num_el, result.begin(), f);
+                f.synchronize();
+                BOOST_CHECK(c[0] == 0.0f);
+                BOOST_CHECK(result[0] == 4.0f + 3.0f);
+
+                boost::aura::device_free(a_ptr);
+                boost::aura::device_free(b_ptr);
+                boost::aura::device_free(c_ptr);
+                boost::aura::device_free(d_ptr);
+        }
+        boost::aura::finalize();
+}
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(rebind_scalar)
+{
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                boost::aura::feed f(d);
+                boost::aura::library l(R"(
+                        AURA_KERNEL void fill(AURA_DEVMEM float* a,
+                                AURA_VALUE(float) v
+                                AURA_MESH_ID_ARG)
+                        {
+                                a[AURA_MESH_ID_0] = v;
+                        }
+                )",
+                        d);
+                boost::aura::kernel k("fill", l);
+                const std::size_t num_el = 64;
+                std::vector<float> a(num_el, 0.0f);
+                auto a_ptr = boost::aura::device_malloc<float>(num_el, d);
+
+                boost::aura::graph g;
+                f.begin_capture(g);
+                boost::aura::invoke(k, boost::aura::mesh({{num_el, 1, 1}}),
+                        boost::aura::bundle({{1, 1, 1}}),
+                        boost::aura::args(a_ptr.get_base_ptr(), 1.0f), f);
+                boost::aura::copy(a_ptr, a_ptr + num_el, a.begin(), f);
+                f.end_capture();
+
+                g.launch(f);
+                f.synchronize();
+                BOOST_CHECK(a[num_el - 1] == 1.0f);
+
+                g.set_arg(0, 1, 5.0f);
+                g.launch(f);
+                f.synchronize();
+                BOOST_CHECK(std::all_of(a.begin(), a.end(),
+                        [](float x) { return x == 5.0f; }));
+
+                boost::aura::device_free(a_ptr);
+        }
+        boost::aura::finalize();
+}
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(capture_rejects_host_sync)
+{
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                boost::aura::feed f(d);
+                boost::aura::device_array<float> a(64, d);
+
+                boost::aura::graph g;
+                f.begin_capture(g);
+                BOOST_CHECK_THROW(a.zero(f), std::string);
+                BOOST_CHECK_THROW(a.map(f), std::string);
+                f.end_capture();
+                BOOST_CHECK(g.size() == 0);
+
+                // A moved feed no longer captures.
+                f.begin_capture(g);
+                boost::aura::feed f2(std::move(f));
+                BOOST_CHECK(f.get_capture() == nullptr);
+                BOOST_CHECK(f2.get_capture() == &g);
+                f2.end_capture();
+        }
+        boost::aura::finalize();
+}
@@ -0,0 +1,82 @@
+#define BOOST_TEST_MODULE host_array
+#include <boost/test/unit_test.hpp>
+
+#include <boost/aura/copy.hpp>
+#include <boost/aura/device.hpp>
+#include <boost/aura/device_array.hpp>
+#include <boost/aura/environment.hpp>
+#include <boost/aura/feed.hpp>
+#include <boost/aura/host_array.hpp>
+#include <boost/aura/pinned_host_allocator.hpp>
+
+#include <algorithm>
+#include <vector>
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(basic_host_array)
+{
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                boost::aura::host_array<float> ha0(1024, d);
+                BOOST_CHECK(ha0.size() == 1024);
+                std::fill(ha0.begin(), ha0.end(), 42.0f);
+                BOOST_CHECK(ha0[1023] == 42.0f);
+
+                boost::aura::host_array<float> ha1({32, 32}, d);
+                BOOST_CHECK(ha1.size() == 1024);
+
+                boost::aura::host_array<float> ha2(std::move(ha0));
+                BOOST_CHECK(ha2.size() == 1024);
+                BOOST_CHECK(ha0.size() == 0);
+        }
+        boost::aura::finalize();
+}
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(host_array_copy)
+{
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                boost::aura::feed f(d);
+                boost::aura::host_array<float> src(1024, d);
+                boost::aura::host_array<float> dst(1024, d);
+                std::fill(src.begin(), src.end(), 21.0f);
+                std::fill(dst.begin(), dst.end(), 0.0f);
+
+                boost::aura::device_array<float> da(1024, d);
+                boost::aura::copy(src, da, f);
+                boost::aura::copy(da, dst, f);
+                boost::aura::wait_for(f);
+                BOOST_CHECK(std::equal(src.begin(), src.end(), dst.begin()));
+
+                auto ptr = boost::aura::device_malloc<float>(1024, d);
+                std::fill(dst.begin(), dst.end(), 0.0f);
+                boost::aura::copy(src, ptr, f);
+                boost::aura::copy(ptr, dst, f);
+                boost::aura::wait_for(f);
+                boost::aura::device_free(ptr);
+                BOOST_CHECK(std::equal(src.begin(), src.end(), dst.begin()));
+        }
+        boost::aura::finalize();
+}
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(pinned_host_allocator_vector)
+{
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                boost::aura::pinned_host_allocator<float> a(d);
+                std::vector<float, boost::aura::pinned_host_allocator<float>>
+                        v(1024, 1.0f, a);
+                v.resize(4096, 2.0f);
+                BOOST_CHECK(v[0] == 1.0f);
+                BOOST_CHECK(v[4095] == 2.0f);
+        }
+        boost::aura::finalize();
+}
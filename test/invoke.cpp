@@ -8,11 +8,14 @@
 #include <boost/aura/feed.hpp>
 #include <boost/aura/invoke.hpp>
 #include <boost/aura/kernel.hpp>
+#include <boost/aura/launch_plan.hpp>
 #include <boost/aura/library.hpp>
 
 #include <test/test.hpp>
 
 #include <iostream>
+#include <thread>
+#include <vector>
 
 
 // _____________________________________________________________________________
@@ -107,3 +110,271 @@ BOOST_AUTO_TEST_CASE(basic_library_from_file_array)
         }
         boost::aura::finalize();
 }
+
+BOOST_AUTO_TEST_CASE(changed_args_and_threads)
+{
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                boost::aura::library l(
+                        boost::aura::path(boost::aura::test::get_test_dir() +
+                                "/kernels.al"),
+                        d);
+                boost::aura::kernel k("add", l);
+                const std::size_t num_el = 128;
+                const std::size_t num_threads = 4;
+
+                std::vector<float> a(num_el, 2.0f);
+                auto a_ptr = boost::aura::device_malloc<float>(num_el, d);
+                {
+                        boost::aura::feed f(d);
+                        boost::aura::copy(a.begin(), a.end(), a_ptr, f);
+                        f.synchronize();
+                }
+
+                std::vector<std::vector<float>> results(
+                        num_threads, std::vector<float>(num_el, 0.0f));
+                std::vector<std::thread> threads;
+                for (std::size_t t = 0; t < num_threads; t++)
+                {
+                        threads.emplace_back([&, t]()
+                                {
+                                        boost::aura::feed f(d);
+                                        auto b_ptr = boost::aura::
+                                                device_malloc<float>(num_el, d);
+                                        auto c_ptr = boost::aura::
+                                                device_malloc<float>(num_el, d);
+                                        std::vector<float> b(num_el, t);
+                                        boost::aura::copy(
+                                                b.begin(), b.end(), b_ptr, f);
+                                        // Same arguments twice, then the
+                                        // output changes.
+                                        for (int i = 0; i < 2; i++)
+                                        {
+                                                boost::aura::invoke(k,
+                                                        boost::aura::mesh(
+                                                                {{num_el, 1, 1}}),
+                                                        boost::aura::bundle(
+                                                                {{1, 1, 1}}),
+                                                        boost::aura::args(
+                                                                a_ptr.get_base_ptr(),
+                                                                a_ptr.get_base_ptr(),
+                                                                c_ptr.get_base_ptr()),
+                                                        f);
+                                        }
+                                        boost::aura::invoke(k,
+                                                boost::aura::mesh(
+                                                        {{num_el, 1, 1}}),
+                                                boost::aura::bundle(
+                                                        {{1, 1, 1}}),
+                                                boost::aura::args(
+                                                        a_ptr.get_base_ptr(),
+                                                        b_ptr.get_base_ptr(),
+                                                        c_ptr.get_base_ptr()),
+                                                f);
+                                        boost::aura::copy(c_ptr, c_ptr + num_el,
+                                                results[t].begin(), f);
+                                        f.synchronize();
+                                        boost::aura::device_free(b_ptr);
+                                        boost::aura::device_free(c_ptr);
+                                });
+                }
+                for (auto& t : threads)
+                {
+                        t.join();
+                }
+                for (std::size_t t = 0; t < num_threads; t++)
+                {
+                        BOOST_CHECK(results[t][0] == 2.0f + t);
+                        BOOST_CHECK(results[t][num_el - 1] == 2.0f + t);
+                }
+                boost::aura::device_free(a_ptr);
+        }
+        boost::aura::finalize();
+}
+
+#ifdef AURA_BASE_OPENCL
+
+BOOST_AUTO_TEST_CASE(skipped_args)
+{
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                boost::aura::feed f(d);
+                boost::aura::library l(R"(
+                        AURA_KERNEL void fill(AURA_DEVMEM float* a,
+                                AURA_VALUE(float) v
+                                AURA_MESH_ID_ARG)
+                        {
+                                a[AURA_MESH_ID_0] = v;
+                        }
+                )",
+                        d);
+                boost::aura::kernel k("fill", l);
+                const std::size_t num_el = 64;
+                std::vector<float> a(num_el);
+                auto launch = [&](boost::aura::device_ptr<float> ptr, float v)
+                {
+                        boost::aura::invoke(k,
+                                boost::aura::mesh({{num_el, 1, 1}}),
+                                boost::aura::bundle({{1, 1, 1}}),
+                                boost::aura::args(ptr.get_base_ptr(), v), f);
+                        boost::aura::copy(ptr, ptr + num_el, a.begin(), f);
+                        boost::aura::wait_for(f);
+                };
+
+                // Unchanged buffers and values are skipped.
+                auto ptr0 = boost::aura::device_malloc<float>(num_el, d);
+                launch(ptr0, 1.0f);
+                BOOST_CHECK(k.num_skipped_args() == 0);
+                launch(ptr0, 1.0f);
+                BOOST_CHECK(k.num_skipped_args() == 2);
+                launch(ptr0, 2.0f);
+                BOOST_CHECK(k.num_skipped_args() == 3);
+                BOOST_CHECK(a[num_el - 1] == 2.0f);
+
+                // A new buffer is set, the freed one stays retained until
+                // then, so the new one can not get its handle.
+                boost::aura::device_free(ptr0);
+                auto ptr1 = boost::aura::device_malloc<float>(num_el, d);
+                launch(ptr1, 2.0f);
+                BOOST_CHECK(k.num_skipped_args() == 4);
+                BOOST_CHECK(a[0] == 2.0f);
+                boost::aura::device_free(ptr1);
+
+                // Arguments set on the base kernel do not affect bind().
+                float v = 5.0f;
+                AURA_OPENCL_SAFE_CALL(clSetKernelArg(
+                        k.get_base_kernel(), 1, sizeof(v), &v));
+                auto ptr2 = boost::aura::device_malloc<float>(num_el, d);
+                launch(ptr2, 2.0f);
+                BOOST_CHECK(a[0] == 2.0f);
+                boost::aura::device_free(ptr2);
+
+                // Threads launching one after another share a kernel
+                // object.
+                for (int i = 0; i < 8; i++)
+                {
+                        std::thread t([&]()
+                                {
+                                        auto ptr = boost::aura::
+                                                device_malloc<float>(num_el, d);
+                                        boost::aura::feed f2(d);
+                                        boost::aura::invoke(k,
+                                                boost::aura::mesh(
+                                                        {{num_el, 1, 1}}),
+                                                boost::aura::bundle(
+                                                        {{1, 1, 1}}),
+                                                boost::aura::args(
+                                                        ptr.get_base_ptr(),
+                                                        3.0f),
+                                                f2);
+                                        boost::aura::wait_for(f2);
+                                        boost::aura::device_free(ptr);
+                                });
+                        t.join();
+                }
+                BOOST_CHECK(k.num_kernel_objects() == 1);
+        }
+        boost::aura::finalize();
+}
+
+#endif
+
+BOOST_AUTO_TEST_CASE(launch_plan)
+{
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                boost::aura::feed f(d);
+                boost::aura::library l(
+                        boost::aura::path(boost::aura::test::get_test_dir() +
+                                "/kernels.al"),
+                        d);
+                boost::aura::kernel k("add", l);
+                const std::size_t num_el = 128;
+
+                std::vector<float> a(num_el, 2.0f);
+                std::vector<float> b(num_el, 3.0f);
+                std::vector<float> c(num_el, 0.0f);
+
+                auto a_ptr = boost::aura::device_malloc<float>(num_el, d);
+                auto b_ptr = boost::aura::device_malloc<float>(num_el, d);
+                auto c_ptr = boost::aura::device_malloc<float>(num_el, d);
+                boost::aura::copy(a.begin(), a.end(), a_ptr, f);
+                boost::aura::copy(b.begin(), b.end(), b_ptr, f);
+
+                auto plan = boost::aura::make_launch_plan(k,
+                        boost::aura::mesh({{num_el, 1, 1}}),
+                        boost::aura::bundle({{1, 1, 1}}),
+                        boost::aura::args(a_ptr.get_base_ptr(),
+                                b_ptr.get_base_ptr(), c_ptr.get_base_ptr()));
+                plan.enqueue(f);
+                boost::aura::copy(c_ptr, c_ptr + num_el, c.begin(), f);
+                boost::aura::wait_for(f);
+                BOOST_CHECK(c[0] == 5.0f);
+
+                // c = c + b, repeatedly.
+                plan.set_arg<0>(c_ptr.get_base_ptr());
+                for (int i = 0; i < 3; i++)
+                {
+                        plan.enqueue(f);
+                }
+                boost::aura::copy(c_ptr, c_ptr + num_el, c.begin(), f);
+                boost::aura::wait_for(f);
+                BOOST_CHECK(c[0] == 14.0f);
+                BOOST_CHECK(c[num_el - 1] == 14.0f);
+
+                boost::aura::device_free(a_ptr);
+                boost::aura::device_free(b_ptr);
+                boost::aura::device_free(c_ptr);
+        }
+        boost::aura::finalize();
+}
+
+BOOST_AUTO_TEST_CASE(invoke_many_)
+{
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                boost::aura::feed f(d);
+                boost::aura::library l(
+                        boost::aura::path(boost::aura::test::get_test_dir() +
+                                "/kernels.al"),
+                        d);
+                boost::aura::kernel k("add", l);
+                const std::size_t num_el = 128;
+
+                std::vector<float> a(num_el, 2.0f);
+                std::vector<float> b(num_el, 3.0f);
+                std::vector<float> c(num_el, 0.0f);
+
+                auto a_ptr = boost::aura::device_malloc<float>(num_el, d);
+                auto b_ptr = boost::aura::device_malloc<float>(num_el, d);
+                auto c_ptr = boost::aura::device_malloc<float>(num_el, d);
+                boost::aura::copy(a.begin(), a.end(), a_ptr, f);
+                boost::aura::copy(b.begin(), b.end(), b_ptr, f);
+
+                // c = a + b, then c = c + b twice.
+                auto a_base = a_ptr.get_base_ptr();
+                auto b_base = b_ptr.get_base_ptr();
+                auto c_base = c_ptr.get_base_ptr();
+                std::vector<decltype(boost::aura::args(a_base, b_base, c_base))>
+                        packs;
+                packs.push_back(boost::aura::args(a_base, b_base, c_base));
+                packs.push_back(boost::aura::args(c_base, b_base, c_base));
+                packs.push_back(boost::aura::args(c_base, b_base, c_base));
+                boost::aura::invoke_many(k,
+                        boost::aura::mesh({{num_el, 1, 1}}),
+                        boost::aura::bundle({{1, 1, 1}}), packs, f);
+                boost::aura::copy(c_ptr, c_ptr + num_el, c.begin(), f);
+                boost::aura::wait_for(f);
+                BOOST_CHECK(c[0] == 11.0f);
+                BOOST_CHECK(c[num_el - 1] == 11.0f);
+
+                boost::aura::device_free(a_ptr);
+                boost::aura::device_free(b_ptr);
+                boost::aura::device_free(c_ptr);
+        }
+        boost::aura::finalize();
+}
@@ -0,0 +1,106 @@
+#define BOOST_TEST_MODULE library_future
+#include <boost/test/unit_test.hpp>
+
+#include <boost/aura/device.hpp>
+#include <boost/aura/environment.hpp>
+#include <boost/aura/kernel.hpp>
+#include <boost/aura/library.hpp>
+#include <boost/aura/library_future.hpp>
+
+#include <test/test.hpp>
+
+#include <atomic>
+#include <future>
+#include <vector>
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(basic_worker_pool)
+{
+        boost::aura::detail::worker_pool pool(4);
+        BOOST_CHECK(pool.size() == 4);
+
+        std::atomic<int> count(0);
+        std::vector<std::future<int>> results;
+        for (int i = 0; i < 64; i++)
+        {
+                results.push_back(pool.submit([&count, i]()
+                        {
+                                count++;
+                                return i;
+                        }));
+        }
+        for (int i = 0; i < 64; i++)
+        {
+                BOOST_CHECK(results[i].get() == i);
+        }
+        BOOST_CHECK(count == 64);
+
+        // Exceptions are forwarded to the future.
+        auto f = pool.submit([]() -> int { throw std::string("error"); });
+        BOOST_CHECK_THROW(f.get(), std::string);
+}
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(basic_library_future)
+{
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                auto p = boost::aura::path(
+                        boost::aura::test::get_test_dir() + "/kernels.al");
+
+                auto f = boost::aura::build_library_async(p, d);
+                BOOST_CHECK(f.valid());
+                boost::aura::kernel k("add", f.get());
+                BOOST_CHECK(f.ready());
+
+                boost::aura::library_future empty;
+                BOOST_CHECK(!empty.valid());
+                BOOST_CHECK(!empty.ready());
+        }
+        boost::aura::finalize();
+}
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(parallel_library_future)
+{
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                auto p = boost::aura::path(
+                        boost::aura::test::get_test_dir() + "/kernels.al");
+
+                // Distinct options so every build compiles.
+                std::vector<boost::aura::library_future> futures;
+                for (int i = 0; i < 8; i++)
+                {
+                        futures.push_back(boost::aura::build_library_async(p,
+                                d, true,
+                                std::string("-DAURA_FUTURE_TEST=") +
+                                        std::to_string(i)));
+                }
+                for (auto& f : futures)
+                {
+                        boost::aura::kernel k("add", f.get());
+                        BOOST_CHECK(f.ready());
+                }
+        }
+        boost::aura::finalize();
+}
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(failed_library_future)
+{
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                auto f = boost::aura::build_library_async(
+                        std::string("this is not a kernel"), d);
+                BOOST_CHECK_THROW(f.get(), std::string);
+        }
+        boost::aura::finalize();
+}
@@ -0,0 +1,100 @@
+#define BOOST_TEST_MODULE library_registry
+#include <boost/test/unit_test.hpp>
+
+#include <boost/aura/device.hpp>
+#include <boost/aura/environment.hpp>
+#include <boost/aura/kernel.hpp>
+#include <boost/aura/library.hpp>
+#include <boost/aura/library_registry.hpp>
+
+#include <test/test.hpp>
+
+#include <thread>
+#include <vector>
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(basic_registry)
+{
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                boost::aura::library_registry r;
+                auto p = boost::aura::path(
+                        boost::aura::test::get_test_dir() + "/kernels.al");
+
+                auto l0 = r.get(p, d);
+                auto l1 = r.get(p, d);
+                BOOST_CHECK(l0 == l1);
+                BOOST_CHECK(r.size() == 1);
+
+                // Different options, different library.
+                auto l2 = r.get(p, d, true, "-DAURA_REGISTRY_TEST");
+                BOOST_CHECK(l0 != l2);
+                BOOST_CHECK(r.size() == 2);
+
+                l2.reset();
+                BOOST_CHECK(r.size() == 1);
+        }
+        boost::aura::finalize();
+}
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(kernel_keeps_library_alive)
+{
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                boost::aura::library_registry r;
+                auto p = boost::aura::path(
+                        boost::aura::test::get_test_dir() + "/kernels.al");
+
+                auto l = r.get(p, d);
+                auto raw = l.get();
+                boost::aura::kernel k("add", std::move(l));
+                BOOST_CHECK(r.size() == 1);
+
+                // Registry still hands out the library held by the kernel.
+                BOOST_CHECK(r.get(p, d).get() == raw);
+
+                k.reset();
+                BOOST_CHECK(r.size() == 0);
+        }
+        boost::aura::finalize();
+}
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(concurrent_registry)
+{
+        boost::aura::initialize();
+        {
+                boost::aura::device d(AURA_UNIT_TEST_DEVICE);
+                boost::aura::library_registry r;
+                auto p = boost::aura::path(
+                        boost::aura::test::get_test_dir() + "/kernels.al");
+
+                const std::size_t num_threads = 8;
+                std::vector<std::shared_ptr<boost::aura::library>> libraries(
+                        num_threads);
+                std::vector<std::thread> threads;
+                for (std::size_t i = 0; i < num_threads; i++)
+                {
+                        threads.emplace_back([&, i]()
+                                {
+                                        libraries[i] = r.get(p, d);
+                                });
+                }
+                for (auto& t : threads)
+                {
+                        t.join();
+                }
+                for (const auto& l : libraries)
+                {
+                        BOOST_CHECK(l == libraries[0]);
+                }
+                BOOST_CHECK(r.size() == 1);
+        }
+        boost::aura::finalize();
+}
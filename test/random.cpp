@@ -0,0 +1,217 @@
+#define BOOST_TEST_MODULE random
+#include <boost/test/unit_test.hpp>
+
+#include <boost/aura/algorithm.hpp>
+#include <boost/aura/copy.hpp>
+#include <boost/aura/device.hpp>
+#include <boost/aura/device_array.hpp>
+#include <boost/aura/environment.hpp>
+#include <boost/aura/feed.hpp>
+#include <boost/aura/invoke.hpp>
+#include <boost/aura/kernel.hpp>
+#include <boost/aura/library.hpp>
+
+#include <test/test.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace boost::aura;
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(philox_known_answers)
+{
+        // Known answer vectors of the Random123 distribution.
+        typedef std::array<std::uint32_t, 4> ctr;
+        BOOST_CHECK(philox4x32(ctr{{0, 0, 0, 0}}, {{0, 0}}) ==
+                (ctr{{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}}));
+        BOOST_CHECK(philox4x32(ctr{{0xffffffff, 0xffffffff, 0xffffffff,
+                                       0xffffffff}},
+                            {{0xffffffff, 0xffffffff}}) ==
+                (ctr{{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}}));
+        BOOST_CHECK(philox4x32(ctr{{0x243f6a88, 0x85a308d3, 0x13198a2e,
+                                       0x03707344}},
+                            {{0xa4093822, 0x299f31d0}}) ==
+                (ctr{{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}}));
+}
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(uniform)
+{
+        initialize();
+        {
+                device d(AURA_UNIT_TEST_DEVICE);
+                feed f(d);
+                const std::size_t n = 100003;
+                const std::uint64_t seed = 0x123456789abcdefull;
+                device_array<float> a(n, d);
+                fill_uniform(a, seed, 0, f);
+                std::vector<float> result(n);
+                copy(a, result, f);
+                wait_for(f);
+
+                // Same numbers as the host generator.
+                for (std::size_t i = 0; i < n; i += 97)
+                {
+                        auto r = philox4x32({{std::uint32_t(i / 4), 0, 0, 0}},
+                                {{std::uint32_t(seed),
+                                        std::uint32_t(seed >> 32)}});
+                        float expected = (r[i % 4] >> 8) / 16777216.0f;
+                        BOOST_CHECK(result[i] == expected);
+                }
+                double sum = 0;
+                for (float v : result)
+                {
+                        BOOST_CHECK(v >= 0.0f && v < 1.0f);
+                        sum += v;
+                }
+                BOOST_CHECK(std::abs(sum / n - 0.5) < 0.01);
+
+                // Filling in parts with matching offsets gives the same
+                // numbers, independent of block boundaries.
+                device_array<float> b(n, d);
+                std::size_t split[] = {0, 1, 6, 4099, n};
+                for (std::size_t i = 0; i + 1 < 5; i++)
+                {
+                        fill_uniform(b.begin() + split[i],
+                                b.begin() + split[i + 1], seed, split[i], f);
+                }
+                std::vector<float> parts(n);
+                copy(b, parts, f);
+                wait_for(f);
+                BOOST_CHECK(parts == result);
+
+                // Other seed, other numbers, range scaled.
+                fill_uniform(b, seed + 1, 0, f, -2.0f, 2.0f);
+                copy(b, parts, f);
+                wait_for(f);
+                BOOST_CHECK(parts != result);
+                for (float v : parts)
+                {
+                        BOOST_CHECK(v >= -2.0f && v < 2.0f);
+                }
+        }
+        finalize();
+}
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(normal)
+{
+        initialize();
+        {
+                device d(AURA_UNIT_TEST_DEVICE);
+                feed f(d);
+                const std::size_t n = 200000;
+                device_array<float> a(n, d);
+                fill_normal(a, 7, 0, f, 3.0f, 2.0f);
+                std::vector<float> result(n);
+                copy(a, result, f);
+                wait_for(f);
+                double sum = 0;
+                double sum2 = 0;
+                for (float v : result)
+                {
+                        sum += v;
+                        sum2 += v * v;
+                }
+                double mean = sum / n;
+                double var = sum2 / n - mean * mean;
+                BOOST_CHECK(std::abs(mean - 3.0) < 0.05);
+                BOOST_CHECK(std::abs(var - 4.0) < 0.1);
+
+                // Offset into the stream.
+                device_array<float> b(n - 5, d);
+                fill_normal(b, 7, 5, f, 3.0f, 2.0f);
+                std::vector<float> tail(n - 5);
+                copy(b, tail, f);
+                wait_for(f);
+                BOOST_CHECK(std::equal(
+                        tail.begin(), tail.end(), result.begin() + 5));
+        }
+        finalize();
+}
+
+// _____________________________________________________________________________
+
+#ifndef AURA_BASE_METAL
+
+BOOST_AUTO_TEST_CASE(uniform_double)
+{
+        initialize();
+        {
+                device d(AURA_UNIT_TEST_DEVICE);
+                // Double needs fp64 support.
+                if (d.get_properties().preferred_vector_width_double > 0)
+                {
+                        feed f(d);
+                        const std::size_t n = 1001;
+                        device_array<double> a(n, d);
+                        fill_uniform(a, 42, 3, f);
+                        std::vector<double> result(n);
+                        copy(a, result, f);
+                        wait_for(f);
+                        for (std::size_t i = 0; i < n; i++)
+                        {
+                                std::size_t j = i + 3;
+                                auto r = philox4x32(
+                                        {{std::uint32_t(j / 2), 0, 0, 0}},
+                                        {{42, 0}});
+                                std::uint64_t hi = r[2 * (j % 2)];
+                                std::uint64_t lo = r[2 * (j % 2) + 1];
+                                double expected = ((hi << 21) | (lo >> 11)) /
+                                        9007199254740992.0;
+                                BOOST_CHECK(result[i] == expected);
+                        }
+                }
+        }
+        finalize();
+}
+
+#endif
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(user_kernel)
+{
+        initialize();
+        {
+                device d(AURA_UNIT_TEST_DEVICE);
+                feed f(d);
+                library l(random_alang_header::get() + R"(
+                        AURA_KERNEL void draw(AURA_DEVMEM uint* y
+                                AURA_MESH_ID_ARG)
+                        {
+                                aura_uint4 c;
+                                c.x = AURA_MESH_ID_0;
+                                c.y = 1;
+                                c.z = 2;
+                                c.w = 3;
+                                y[AURA_MESH_ID_0] =
+                                        aura_philox4x32(c, 5, 6).w;
+                        }
+                )",
+                        d);
+                kernel k("draw", l);
+                const std::size_t n = 64;
+                device_array<std::uint32_t> a(n, d);
+                invoke(k, mesh({{n, 1, 1}}), bundle({{1, 1, 1}}),
+                        args(a.get_base_ptr()), f);
+                std::vector<std::uint32_t> result(n);
+                copy(a, result, f);
+                wait_for(f);
+                for (std::size_t i = 0; i < n; i++)
+                {
+                        auto r = philox4x32(
+                                {{std::uint32_t(i), 1, 2, 3}}, {{5, 6}});
+                        BOOST_CHECK(result[i] == r[3]);
+                }
+        }
+        finalize();
+}
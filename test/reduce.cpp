@@ -0,0 +1,119 @@
+#define BOOST_TEST_MODULE reduce
+#include <boost/test/unit_test.hpp>
+
+#include <boost/aura/algorithm.hpp>
+#include <boost/aura/copy.hpp>
+#include <boost/aura/device.hpp>
+#include <boost/aura/device_array.hpp>
+#include <boost/aura/environment.hpp>
+#include <boost/aura/feed.hpp>
+
+#include <test/test.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+using namespace boost::aura;
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(reduce_int)
+{
+        initialize();
+        {
+                device d(AURA_UNIT_TEST_DEVICE);
+                feed f(d);
+                // Sizes below, at and above one bundle and one full mesh.
+                for (std::size_t n : {1, 7, 256, 1000, 100000})
+                {
+                        std::vector<std::int32_t> v(n);
+                        std::iota(v.begin(), v.end(), 1);
+                        device_array<std::int32_t> a(n, d);
+                        copy(v, a, f);
+                        BOOST_CHECK(reduce(a, 5, f) ==
+                                std::accumulate(v.begin(), v.end(), 5));
+                        BOOST_CHECK(reduce(a, 0, maximum(), f) ==
+                                std::int32_t(n));
+                        BOOST_CHECK(reduce(a, 100, minimum(), f) == 1);
+                }
+        }
+        finalize();
+}
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(reduce_range)
+{
+        initialize();
+        {
+                device d(AURA_UNIT_TEST_DEVICE);
+                feed f(d);
+                const std::size_t n = 4096;
+                std::vector<float> v(n, 1.0f);
+                v[10] = 100.0f;
+                device_array<float> a(n, d);
+                copy(v, a, f);
+
+                // Ranges with an offset.
+                BOOST_CHECK(reduce(a.begin() + 11, a.end(), 0.0f, f) ==
+                        float(n - 11));
+                BOOST_CHECK(reduce(a.begin() + 5, a.begin() + 15, 0.0f, f) ==
+                        109.0f);
+                BOOST_CHECK(reduce(a.begin(), a.begin(), 3.0f, f) == 3.0f);
+
+                auto norm2 = transform_reduce(
+                        a, 0.0f, plus(), square(), f);
+                BOOST_CHECK(norm2 == float(n - 1) + 10000.0f);
+                BOOST_CHECK(dot(a, a, f) == norm2);
+        }
+        finalize();
+}
+
+// _____________________________________________________________________________
+
+namespace
+{
+
+/// Check positions of minimum and maximum of T.
+template <typename T>
+void check_min_max_element(device& d)
+{
+        feed f(d);
+        const std::size_t n = 30000;
+        std::vector<T> v(n);
+        for (std::size_t i = 0; i < n; i++)
+        {
+                v[i] = std::sin(T(i));
+        }
+        // Ties resolve to the first position.
+        v[20000] = v[12345] = 2;
+        v[29999] = v[300] = -2;
+        device_array<T> a(n, d);
+        copy(v, a, f);
+
+        BOOST_CHECK(max_element(a, f) - a.begin() == 12345);
+        BOOST_CHECK(min_element(a, f) - a.begin() == 300);
+        BOOST_CHECK(min_element(a.begin() + 301, a.end(), f) - a.begin() ==
+                29999);
+        BOOST_CHECK(max_element(a.begin(), a.begin(), f) == a.begin());
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(min_max_element)
+{
+        initialize();
+        {
+                device d(AURA_UNIT_TEST_DEVICE);
+                check_min_max_element<float>(d);
+                // Double needs fp64 support (e.g. not on Metal).
+                if (d.get_properties().preferred_vector_width_double > 0)
+                {
+                        check_min_max_element<double>(d);
+                }
+        }
+        finalize();
+}
@@ -0,0 +1,173 @@
+#define BOOST_TEST_MODULE scan
+#include <boost/test/unit_test.hpp>
+
+#include <boost/aura/algorithm.hpp>
+#include <boost/aura/copy.hpp>
+#include <boost/aura/device.hpp>
+#include <boost/aura/device_array.hpp>
+#include <boost/aura/environment.hpp>
+#include <boost/aura/feed.hpp>
+
+#include <test/test.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <vector>
+
+using namespace boost::aura;
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(scan)
+{
+        initialize();
+        {
+                device d(AURA_UNIT_TEST_DEVICE);
+                feed f(d);
+                // Sizes below, at and above one tile and several levels.
+                for (std::size_t n : {1, 7, 1024, 1025, 300000})
+                {
+                        std::vector<std::int32_t> v(n);
+                        for (std::size_t i = 0; i < n; i++)
+                        {
+                                v[i] = i % 7 - 3;
+                        }
+                        device_array<std::int32_t> a(n, d);
+                        device_array<std::int32_t> b(n, d);
+                        copy(v, a, f);
+
+                        std::vector<std::int32_t> expected(n);
+                        std::vector<std::int32_t> result(n);
+                        std::partial_sum(v.begin(), v.end(), expected.begin());
+                        inclusive_scan(a, b, f);
+                        copy(b, result, f);
+                        wait_for(f);
+                        BOOST_CHECK(result == expected);
+
+                        // Exclusive scan in place.
+                        std::int32_t sum = 10;
+                        for (std::size_t i = 0; i < n; i++)
+                        {
+                                expected[i] = sum;
+                                sum += v[i];
+                        }
+                        exclusive_scan(a.begin(), a.end(), a.begin(), 10, f);
+                        copy(a, result, f);
+                        wait_for(f);
+                        BOOST_CHECK(result == expected);
+                }
+        }
+        finalize();
+}
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(scan_op)
+{
+        initialize();
+        {
+                device d(AURA_UNIT_TEST_DEVICE);
+                feed f(d);
+                const std::size_t n = 5000;
+                std::vector<float> v(n);
+                for (std::size_t i = 0; i < n; i++)
+                {
+                        v[i] = float((i * 37) % 101);
+                }
+                device_array<float> a(n, d);
+                copy(v, a, f);
+
+                // Running maximum starting with init.
+                std::vector<float> expected(n);
+                float m = 50.0f;
+                for (std::size_t i = 0; i < n; i++)
+                {
+                        m = std::max(m, v[i]);
+                        expected[i] = m;
+                }
+                std::vector<float> result(n);
+                auto end = inclusive_scan(
+                        a.begin(), a.end(), a.begin(), maximum(), 50.0f, f);
+                BOOST_CHECK(end == a.end());
+                copy(a, result, f);
+                wait_for(f);
+                BOOST_CHECK(result == expected);
+        }
+        finalize();
+}
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(copy_if_partition)
+{
+        initialize();
+        {
+                device d(AURA_UNIT_TEST_DEVICE);
+                feed f(d);
+                const std::size_t n = 100000;
+                std::vector<float> v(n);
+                for (std::size_t i = 0; i < n; i++)
+                {
+                        v[i] = float((i * 7919) % 1000) / 1000.0f;
+                }
+                device_array<float> a(n, d);
+                device_array<float> b(n, d);
+                copy(v, a, f);
+
+                std::vector<float> expected;
+                std::copy_if(v.begin(), v.end(), std::back_inserter(expected),
+                        [](float x) { return x > 0.75f; });
+                auto end = copy_if(a, b, greater_than<float>{0.75f}, f);
+                BOOST_CHECK(end - b.begin() == std::ptrdiff_t(expected.size()));
+                std::vector<float> result(expected.size());
+                copy(b.begin(), end, result.data(), f);
+                wait_for(f);
+                BOOST_CHECK(result == expected);
+
+                std::stable_partition(v.begin(), v.end(),
+                        [](float x) { return x < 0.25f; });
+                auto middle = partition(a, less_than<float>{0.25f}, f);
+                BOOST_CHECK(middle - a.begin() == 25000);
+                result.resize(n);
+                copy(a, result, f);
+                wait_for(f);
+                BOOST_CHECK(result == v);
+
+                // Empty range.
+                BOOST_CHECK(copy_if(a.begin(), a.begin(), b.begin(),
+                                    nonzero(), f) == b.begin());
+        }
+        finalize();
+}
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(unique_)
+{
+        initialize();
+        {
+                device d(AURA_UNIT_TEST_DEVICE);
+                feed f(d);
+                const std::size_t n = 20000;
+                std::vector<std::uint32_t> v(n);
+                for (std::size_t i = 0; i < n; i++)
+                {
+                        v[i] = i / 3 + (i % 5 == 0);
+                }
+                device_array<std::uint32_t> a(n, d);
+                copy(v, a, f);
+
+                auto expected_end = std::unique(v.begin(), v.end());
+                auto end = unique(a, f);
+                BOOST_CHECK(end - a.begin() == expected_end - v.begin());
+                std::vector<std::uint32_t> result(end - a.begin());
+                copy(a.begin(), end, result.data(), f);
+                wait_for(f);
+                BOOST_CHECK(std::equal(
+                        result.begin(), result.end(), v.begin()));
+        }
+        finalize();
+}
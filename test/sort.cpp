@@ -0,0 +1,145 @@
+#define BOOST_TEST_MODULE sort
+#include <boost/test/unit_test.hpp>
+
+#include <boost/aura/algorithm.hpp>
+#include <boost/aura/copy.hpp>
+#include <boost/aura/device.hpp>
+#include <boost/aura/device_array.hpp>
+#include <boost/aura/device_pool_allocator.hpp>
+#include <boost/aura/environment.hpp>
+#include <boost/aura/feed.hpp>
+
+#include <test/test.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace boost::aura;
+
+namespace
+{
+
+/// Sort random keys on the device and compare with std::sort.
+template <typename T, typename Distribution>
+bool check_sort(std::size_t n, Distribution dist, std::size_t digit_bits,
+        device& d, feed& f)
+{
+        std::mt19937 gen(n);
+        std::vector<T> v(n);
+        for (auto& x : v)
+        {
+                x = dist(gen);
+        }
+        device_array<T> a(n, d);
+        copy(v, a, f);
+        sort(a, f, digit_bits);
+        std::vector<T> result(n);
+        copy(a, result, f);
+        wait_for(f);
+        std::sort(v.begin(), v.end());
+        return result == v;
+}
+
+} // namespace
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(sort_keys)
+{
+        initialize();
+        {
+                device d(AURA_UNIT_TEST_DEVICE);
+                feed f(d);
+                for (std::size_t n : {1, 2, 1000, 100000})
+                {
+                        BOOST_CHECK(check_sort<std::int32_t>(n,
+                                std::uniform_int_distribution<std::int32_t>(
+                                        -1000000, 1000000),
+                                4, d, f));
+                        BOOST_CHECK(check_sort<std::uint64_t>(n,
+                                std::uniform_int_distribution<std::uint64_t>(),
+                                8, d, f));
+                        BOOST_CHECK(check_sort<float>(n,
+                                std::uniform_real_distribution<float>(
+                                        -10.0f, 10.0f),
+                                3, d, f));
+                        BOOST_CHECK(check_sort<double>(n,
+                                std::normal_distribution<double>(), 5, d, f));
+                }
+                device_array<std::int32_t> a(10, d);
+                BOOST_CHECK_THROW(sort(a, f, 9), std::string);
+        }
+        finalize();
+}
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(sort_by_key_)
+{
+        initialize();
+        {
+                device d(AURA_UNIT_TEST_DEVICE);
+                d.allocation_tracker.activate();
+                feed f(d);
+                const std::size_t n = 50000;
+                std::vector<std::uint32_t> keys(n);
+                std::vector<float> values(n);
+                for (std::size_t i = 0; i < n; i++)
+                {
+                        keys[i] = (i * 7919) % 100;
+                        values[i] = float(i);
+                }
+                device_array<std::uint32_t> k(n, d);
+                device_array<float> v(n, d);
+                copy(keys, k, f);
+                copy(values, v, f);
+
+                // Storage from pool allocators is reused by repeated sorts,
+                // the second sort allocates no device memory at all.
+                device_pool_allocator<std::uint32_t> key_pool(d);
+                device_pool_allocator<float> value_pool(d);
+                device_pool_allocator<std::uint32_t> count_pool(d);
+                sort_storage<std::uint32_t, float, device_pool_allocator> s(
+                        key_pool, value_pool, count_pool);
+                auto allocations = [&]()
+                {
+                        return d.allocation_tracker.count_active() +
+                                d.allocation_tracker.count_old();
+                };
+                sort_by_key(k, v, s, f);
+                wait_for(f);
+                auto first_allocations = allocations();
+                BOOST_CHECK(first_allocations > 2);
+                sort_by_key(k, v, s, f);
+                wait_for(f);
+                BOOST_CHECK(allocations() == first_allocations);
+
+                // Sort is stable, so equal keys keep the order of values.
+                std::vector<std::size_t> order(n);
+                for (std::size_t i = 0; i < n; i++)
+                {
+                        order[i] = i;
+                }
+                std::stable_sort(order.begin(), order.end(),
+                        [&](std::size_t a, std::size_t b)
+                        {
+                                return keys[a] < keys[b];
+                        });
+                std::vector<std::uint32_t> result_keys(n);
+                std::vector<float> result_values(n);
+                copy(k, result_keys, f);
+                copy(v, result_values, f);
+                wait_for(f);
+                bool ok = true;
+                for (std::size_t i = 0; i < n; i++)
+                {
+                        ok = ok && result_keys[i] == keys[order[i]] &&
+                                result_values[i] == values[order[i]];
+                }
+                BOOST_CHECK(ok);
+        }
+        finalize();
+}
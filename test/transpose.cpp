@@ -0,0 +1,139 @@
+#define BOOST_TEST_MODULE transpose
+#include <boost/test/unit_test.hpp>
+
+#include <boost/aura/algorithm.hpp>
+#include <boost/aura/bounds.hpp>
+#include <boost/aura/copy.hpp>
+#include <boost/aura/device.hpp>
+#include <boost/aura/device_array.hpp>
+#include <boost/aura/environment.hpp>
+#include <boost/aura/feed.hpp>
+
+#include <test/test.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+using namespace boost::aura;
+
+namespace
+{
+
+/// Permute array with bounds b on the device and compare with the host.
+bool check_permute(const bounds& b, const bounds& axes, device& d, feed& f)
+{
+        std::size_t n = product(b);
+        std::vector<std::int32_t> v(n);
+        std::iota(v.begin(), v.end(), 0);
+
+        bounds out_bounds;
+        for (std::size_t i = 0; i < axes.size(); i++)
+        {
+                out_bounds.push_back(b[axes[i]]);
+        }
+        std::vector<std::int32_t> expected(n);
+        for (std::size_t i = 0; i < n; i++)
+        {
+                // Coordinates of element i, first axis fastest.
+                std::vector<std::size_t> c(b.size());
+                std::size_t rest = i;
+                for (std::size_t k = 0; k < b.size(); k++)
+                {
+                        c[k] = rest % b[k];
+                        rest /= b[k];
+                }
+                std::size_t dst = 0;
+                std::size_t stride = 1;
+                for (std::size_t k = 0; k < axes.size(); k++)
+                {
+                        dst += c[axes[k]] * stride;
+                        stride *= out_bounds[k];
+                }
+                expected[dst] = v[i];
+        }
+
+        device_array<std::int32_t> in(b, d);
+        device_array<std::int32_t> out(out_bounds, d);
+        copy(v, in, f);
+        permute(in, out, axes, f);
+        std::vector<std::int32_t> result(n);
+        copy(out, result, f);
+        wait_for(f);
+        return result == expected;
+}
+
+} // namespace
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(transpose_2d)
+{
+        initialize();
+        {
+                device d(AURA_UNIT_TEST_DEVICE);
+                feed f(d);
+                const std::size_t columns = 37;
+                const std::size_t rows = 1000;
+                std::vector<float> v(columns * rows);
+                for (std::size_t i = 0; i < v.size(); i++)
+                {
+                        v[i] = float(i);
+                }
+                device_array<float> in(bounds({columns, rows}), d);
+                device_array<float> out(bounds({rows, columns}), d);
+                copy(v, in, f);
+                transpose(in, out, f);
+                std::vector<float> result(v.size());
+                copy(out, result, f);
+                wait_for(f);
+                bool ok = true;
+                for (std::size_t r = 0; r < rows; r++)
+                {
+                        for (std::size_t c = 0; c < columns; c++)
+                        {
+                                ok = ok && result[c * rows + r] ==
+                                        v[r * columns + c];
+                        }
+                }
+                BOOST_CHECK(ok);
+
+                // Output bounds must match.
+                device_array<float> wrong(bounds({columns, rows}), d);
+                BOOST_CHECK_THROW(transpose(in, wrong, f), std::string);
+        }
+        finalize();
+}
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(permute_axes)
+{
+        initialize();
+        {
+                device d(AURA_UNIT_TEST_DEVICE);
+                feed f(d);
+                // All permutations of three axes.
+                std::vector<std::size_t> p = {0, 1, 2};
+                do
+                {
+                        BOOST_CHECK(check_permute(bounds({33, 17, 65}),
+                                bounds({p[0], p[1], p[2]}), d, f));
+                } while (std::next_permutation(p.begin(), p.end()));
+
+                // Axes of extent one and axes that can be merged.
+                BOOST_CHECK(check_permute(bounds({40, 1, 3, 50}),
+                        bounds({3, 0, 1, 2}), d, f));
+                BOOST_CHECK(check_permute(bounds({2, 3, 4, 5, 6}),
+                        bounds({4, 3, 2, 1, 0}), d, f));
+
+                device_array<std::int32_t> a(bounds({4, 4}), d);
+                device_array<std::int32_t> b(bounds({4, 4}), d);
+                BOOST_CHECK_THROW(permute(a, b, bounds({0, 0}), f),
+                        std::string);
+                BOOST_CHECK_THROW(permute(a, b, bounds({0}), f), std::string);
+        }
+        finalize();
+}
@@ -0,0 +1,91 @@
+#define BOOST_TEST_MODULE typed_kernel
+#include <boost/test/unit_test.hpp>
+
+#include <boost/aura/copy.hpp>
+#include <boost/aura/device.hpp>
+#include <boost/aura/device_ptr.hpp>
+#include <boost/aura/environment.hpp>
+#include <boost/aura/feed.hpp>
+#include <boost/aura/kernel.hpp>
+#include <boost/aura/library.hpp>
+#include <boost/aura/typed_kernel.hpp>
+
+#include <test/test.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace boost::aura;
+
+// _____________________________________________________________________________
+
+BOOST_AUTO_TEST_CASE(basic_typed_kernel)
+{
+        initialize();
+        {
+                device d(AURA_UNIT_TEST_DEVICE);
+                feed f(d);
+                library l(path(test::get_test_dir() + "/kernels.al"), d);
+                typed_kernel<void(device_ptr<float>, device_ptr<float>,
+                        device_ptr<float>)>
+                        k("add", l);
+                const std::size_t num_el = 128;
+
+                std::vector<float> a(num_el, 2.0f);
+                std::vector<float> b(num_el, 3.0f);
+                std::vector<float> c(num_el, 0.0f);
+
+                auto a_ptr = device_malloc<float>(num_el, d);
+                auto b_ptr = device_malloc<float>(num_el, d);
+                auto c_ptr = device_malloc<float>(num_el, d);
+                copy(a.begin(), a.end(), a_ptr, f);
+                copy(b.begin(), b.end(), b_ptr, f);
+
+                k(mesh({{num_el, 1, 1}}), bundle({{1, 1, 1}}), f, a_ptr, b_ptr,
+                        c_ptr);
+
+                copy(c_ptr, c_ptr + num_el, c.begin(), f);
+                wait_for(f);
+                BOOST_CHECK(c[0] == 5.0f);
+                BOOST_CHECK(c[num_el - 1] == 5.0f);
+
+                device_free(a_ptr);
+                device_free(b_ptr);
+                device_free(c_ptr);
+        }
+        finalize();
+}
+
+BOOST_AUTO_TEST_CASE(signature_mismatch)
+{
+        initialize();
+        {
+                device d(AURA_UNIT_TEST_DEVICE);
+                library l(path(test::get_test_dir() + "/kernels.al"), d, true,
+                        kernel_arg_info);
+#ifdef AURA_BASE_OPENCL
+                // Wrong number of arguments.
+                BOOST_CHECK_THROW(
+                        (typed_kernel<void(device_ptr<float>)>("add", l)),
+                        std::string);
+
+#ifdef CL_VERSION_1_2
+                // Wrong element type, only detected if the driver provides
+                // argument info (libraries from the binary cache may not).
+                kernel probe("add", l);
+                cl_kernel_arg_address_qualifier address;
+                if (clGetKernelArgInfo(probe.get_base_kernel(), 0,
+                            CL_KERNEL_ARG_ADDRESS_QUALIFIER, sizeof(address),
+                            &address, NULL) == CL_SUCCESS)
+                {
+                        BOOST_CHECK_THROW(
+                                (typed_kernel<void(device_ptr<int>,
+                                        device_ptr<float>,
+                                        device_ptr<float>)>("add", l)),
+                                std::string);
+                }
+#endif
+#endif
+        }
+        finalize();
+}